@@ -3,32 +3,128 @@
 #include <stdio.h>
 #include "assert.h"
 #include "compress40.h"
+#include "stats.h"
+#include "trace.h"
+#include "quantstats.h"
+#include "tuning.h"
+#include "mem.h"
 
 static void (*compress_or_decompress)(FILE *input) = compress40;
 
+/********** autotune ********
+ *
+ * Tunes the codec for this machine, saves the result to the config file
+ * and prints it.
+ *
+ * Parameters:
+ *      const char *program:    The program name, for messages.
+ *      const char *image:      A PPM image to calibrate on, or NULL for a
+ *                              synthetic one.
+ *
+ * Return:
+ *      int:                    The exit status.
+ ************************/
+static int autotune(const char *program, const char *image)
+{
+        char *ppm = NULL;
+        size_t len = 0;
+        if (image != NULL) {
+                FILE *fp = fopen(image, "rb");
+                if (fp == NULL) {
+                        fprintf(stderr, "%s: cannot open '%s'\n", program,
+                                image);
+                        return EXIT_FAILURE;
+                }
+                fseek(fp, 0, SEEK_END);
+                len = ftell(fp);
+                rewind(fp);
+                ppm = ALLOC(len + 1);
+                size_t got = fread(ppm, 1, len, fp);
+                assert(got == len);
+                fclose(fp);
+        }
+
+        Cache_topology topology;
+        Tuning_topology(&topology);
+        fprintf(stderr, "cpus %d, line %zu, L1d %zu, L2 %zu, LLC %zu\n",
+                topology.cpus, topology.line, topology.l1d, topology.l2,
+                topology.llc);
+        Tuning_autotune(ppm, len, &topology, stderr);
+        FREE(ppm);
+
+        const char *path = Tuning_path();
+        if (path == NULL || !Tuning_save(path, &topology)) {
+                fprintf(stderr, "%s: cannot save tuning to '%s'\n", program,
+                        path == NULL ? "(no HOME)" : path);
+                return EXIT_FAILURE;
+        }
+        printf("threads %d strip_cols %u (saved to %s)\n",
+               Tuning_current.threads, Tuning_current.strip_cols, path);
+        return EXIT_SUCCESS;
+}
+
 int main(int argc, char *argv[])
 {
+        const char *trace_path = getenv("COMP40_TRACE");
         int i;
 
+        /* COMP40_STATS=1 works like --stats, for runs we don't launch */
+        const char *env = getenv("COMP40_STATS");
+        if (env != NULL && *env != '\0' && strcmp(env, "0") != 0) {
+                Stats_enabled = 1;
+        }
+        env = getenv("COMP40_QSTATS");
+        if (env != NULL && *env != '\0' && strcmp(env, "0") != 0) {
+                Quantstats_enabled = 1;
+        }
+
+        /* Use the tuner's last choice, if it has made one */
+        const char *tuning = Tuning_path();
+        if (tuning != NULL) {
+                Tuning_load(tuning);
+        }
+
         for (i = 1; i < argc; i++) {
                 if (strcmp(argv[i], "-c") == 0) {
                         compress_or_decompress = compress40;
                 } else if (strcmp(argv[i], "-d") == 0) {
                         compress_or_decompress = decompress40;
+                } else if (strcmp(argv[i], "--stats") == 0) {
+                        Stats_enabled = 1;
+                } else if (strcmp(argv[i], "--perf-counters") == 0) {
+                        Stats_perf_counters();
+                } else if (strcmp(argv[i], "--qstats") == 0) {
+                        Quantstats_enabled = 1;
+                } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+                        trace_path = argv[++i];
+                } else if (strcmp(argv[i], "--autotune") == 0) {
+                        if (i + 2 < argc) {
+                                fprintf(stderr, "Usage: %s --autotune "
+                                        "[filename]\n", argv[0]);
+                                exit(1);
+                        }
+                        return autotune(argv[0], i + 1 < argc ? argv[i + 1]
+                                                              : NULL);
                 } else if (*argv[i] == '-') {
                         fprintf(stderr, "%s: unknown option '%s'\n",
                                 argv[0], argv[i]);
                         exit(1);
                 } else if (argc - i > 2) {
-                        fprintf(stderr, "Usage: %s -d [filename]\n"
-                                "       %s -c [filename]\n",
-                                argv[0], argv[0]);
+                        fprintf(stderr, "Usage: %s [options] -d [filename]\n"
+                                "       %s [options] -c [filename]\n"
+                                "Options: --stats, --perf-counters, "
+                                "--qstats, --trace file\n"
+                                "       %s --autotune [filename]\n",
+                                argv[0], argv[0], argv[0]);
                         exit(1);
                 } else {
                         break;
                 }
         }
         assert(argc - i <= 1);    /* at most one file on command line */
+        if (trace_path != NULL && *trace_path != '\0') {
+                Trace_start();
+        }
         if (i < argc) {
                 FILE *fp = fopen(argv[i], "r");
                 assert(fp != NULL);
@@ -38,5 +134,15 @@ int main(int argc, char *argv[])
                 compress_or_decompress(stdin);
         }
 
+        if (Quantstats_enabled) {
+                Quantstats_report(stderr);
+        }
+        if (Trace_enabled) {
+                FILE *trace = fopen(trace_path, "w");
+                assert(trace != NULL);
+                Trace_dump(trace);
+                fclose(trace);
+        }
+
         return EXIT_SUCCESS; 
 }
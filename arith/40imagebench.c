@@ -0,0 +1,549 @@
+/**************************************************************
+ *
+ *                     40imagebench.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     A per-stage benchmark for the arith pipeline. Each stage of
+ *     compression and decompression runs on its own over every block of
+ *     an image, so its cost can be measured apart from the others. Every
+ *     stage gets -w untimed warmup runs and -r timed runs; the median run
+ *     is reported as ns/block, MB/s of RGB pixel data and (where the CPU
+ *     has a readable cycle counter) cycles/pixel.
+ *
+ *     Images are synthetic squares of several sizes (ppmgen's fractal
+ *     kind, from ppmsynth.h), plus any PPM files named on the command
+ *     line. The results are printed to stdout as JSON, with the name of
+ *     the active kernel set (see kernels.h), which COMP40_KERNEL can
+ *     force.
+ *
+ *     Usage: 40imagebench [-r repetitions] [-w warmup] [-S] [file.ppm ...]
+ *            -S skips the synthetic images.
+ *
+ ************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "pnm.h"
+#include "a2methods.h"
+#include "a2plain.h"
+#include "a2row.h"
+#include "bitpack.h"
+#include "rgb2cav.h"
+#include "dct.h"
+#include "quantize.h"
+#include "packword.h"
+#include "frame.h"
+#include "jobarena.h"
+#include "timer.h"
+#include "kernels.h"
+#include "ppmsynth.h"
+
+static const unsigned SYNTHETIC_SIZES[] = {64, 256, 1024, 2048};
+#define NUM_SYNTHETIC (sizeof(SYNTHETIC_SIZES) / sizeof(SYNTHETIC_SIZES[0]))
+
+/********** Bench ********
+ *
+ * One image, and the intermediate results of every stage for every one
+ * of its blocks, so that each stage can run on its own.
+ *
+ * Elements:
+ *      const char *ppm:          The image as PPM bytes.
+ *      size_t ppm_len:           The number of bytes in ppm.
+ *      Pnm_ppm image:            The image, as read.
+ *      Pnm_ppm scratch:          The image read by the read stage.
+ *      Pnm_ppm decoded:          The image filled in by decoding.
+ *      unsigned cols, rows:      The image's size in 2x2 blocks.
+ *      size_t nblocks:           cols * rows.
+ *      struct CAV *cavs:         Four pixels per block, in block order.
+ *      struct DCT *dcts:         One per block.
+ *      struct Quantized *qs:     One per block.
+ *      uint32_t *words:          One per block.
+ *      char *compressed:         The compressed image.
+ *      size_t compressed_len:    The number of bytes in compressed.
+ *      RGB_block rgb_block:      Pointers to one block's pixels.
+ *      CAV_block cav_block:      Pointers to one block's CAV values.
+ *      JobArena_T arena:         Owns frame.
+ *      Frame frame:              The image as planar component video.
+ *      FILE *sink:               Where the output stages write.
+ ************************/
+typedef struct Bench
+{
+        const char *ppm;
+        size_t ppm_len;
+        Pnm_ppm image;
+        Pnm_ppm scratch;
+        Pnm_ppm decoded;
+        unsigned cols, rows;
+        size_t nblocks;
+        struct CAV *cavs;
+        struct DCT *dcts;
+        struct Quantized *qs;
+        uint32_t *words;
+        char *compressed;
+        size_t compressed_len;
+        RGB_block rgb_block;
+        CAV_block cav_block;
+        JobArena_T arena;
+        Frame frame;
+        FILE *sink;
+} *Bench;
+
+/********** Stage ********
+ *
+ * One timed stage.
+ *
+ * Elements:
+ *      const char *name:      The name reported for the stage.
+ *      void (*run)(Bench):    Runs the stage once over the whole image.
+ *      void (*undo)(Bench):   If not NULL, runs untimed after each run.
+ ************************/
+typedef struct Stage
+{
+        const char *name;
+        void (*run)(Bench b);
+        void (*undo)(Bench b);
+} Stage;
+
+/********** point_block ********
+ *
+ * Points the bench's scratch blocks at block n: the RGB pointers at the
+ * pixels of an image, and the CAV pointers at the block's CAV values.
+ *
+ * Parameters:
+ *      Bench b:          The bench.
+ *      Pnm_ppm image:    The image whose pixels to use, or NULL to leave
+ *                        the RGB pointers alone.
+ *      size_t n:         The block, counted down each column of blocks.
+ ************************/
+static inline void point_block(Bench b, Pnm_ppm image, size_t n)
+{
+        size_t col = n / b->rows, row = n % b->rows;
+        Pnm_rgb rows[2] = {NULL, NULL};
+        if (image != NULL)
+        {
+                rows[0] = A2Methods_row(image->methods, image->pixels,
+                                        row * 2);
+                rows[1] = A2Methods_row(image->methods, image->pixels,
+                                        row * 2 + 1);
+        }
+        for (size_t k = 0; k < 4; k++)
+        {
+                if (rows[k / 2] != NULL)
+                {
+                        b->rgb_block->rgb[k] = &rows[k / 2][col * 2 + k % 2];
+                }
+                else if (image != NULL)
+                {
+                        b->rgb_block->rgb[k] = image->methods->at(
+                                image->pixels, col * 2 + k % 2,
+                                row * 2 + k / 2);
+                }
+                b->cav_block->cav[k] = &b->cavs[n * 4 + k];
+        }
+}
+
+/***************************************************************
+ *                      Compression stages
+ ***************************************************************/
+static void stage_read(Bench b)
+{
+        FILE *fp = fmemopen((void *)b->ppm, b->ppm_len, "r");
+        b->scratch = Pnm_ppmread(fp, uarray2_methods_plain);
+        fclose(fp);
+}
+
+static void undo_read(Bench b)
+{
+        Pnm_ppmfree(&b->scratch);
+}
+
+static void stage_rgb2cav(Bench b)
+{
+        for (size_t n = 0; n < b->nblocks; n++)
+        {
+                point_block(b, b->image, n);
+                RGBtoCAV_block(b->cav_block, b->rgb_block,
+                               b->image->denominator);
+        }
+}
+
+static void stage_dct(Bench b)
+{
+        for (size_t n = 0; n < b->nblocks; n++)
+        {
+                point_block(b, NULL, n);
+                computeDCT(&b->dcts[n], b->cav_block);
+        }
+}
+
+static void stage_frame(Bench b)
+{
+        Frame_from_ppm(b->frame, b->image);
+}
+
+static void stage_dct_frame(Bench b)
+{
+        for (size_t n = 0; n < b->nblocks; n++)
+        {
+                computeDCT_frame(&b->dcts[n], b->frame, n / b->rows,
+                                 n % b->rows);
+        }
+}
+
+static void stage_quantize(Bench b)
+{
+        for (size_t n = 0; n < b->nblocks; n++)
+        {
+                quantize(&b->qs[n], &b->dcts[n]);
+        }
+}
+
+static void stage_pack(Bench b)
+{
+        for (size_t n = 0; n < b->nblocks; n++)
+        {
+                b->words[n] = packWord(&b->qs[n]);
+        }
+}
+
+static void stage_output(Bench b)
+{
+        fprintf(b->sink, "COMP40 Compressed image format 2\n%u %u\n",
+                b->cols * 2, b->rows * 2);
+        for (size_t n = 0; n < b->nblocks; n++)
+        {
+                for (int shift = 24; shift >= 0; shift -= 8)
+                {
+                        putc((b->words[n] >> shift) & 0xFF, b->sink);
+                }
+        }
+        fflush(b->sink);
+}
+
+/***************************************************************
+ *                     Decompression stages
+ ***************************************************************/
+static void stage_input(Bench b)
+{
+        FILE *fp = fmemopen(b->compressed, b->compressed_len, "r");
+        unsigned width, height;
+        int read = fscanf(fp, "COMP40 Compressed image format 2\n%u %u",
+                          &width, &height);
+        assert(read == 2);
+        int c = getc(fp);
+        assert(c == '\n');
+
+        for (size_t n = 0; n < b->nblocks; n++)
+        {
+                uint32_t packed = 0;
+                for (int shift = 24; shift >= 0; shift -= 8)
+                {
+                        packed = Bitpack_newu(packed, 8, shift, getc(fp));
+                }
+                b->words[n] = packed;
+        }
+        fclose(fp);
+}
+
+static void stage_unpack(Bench b)
+{
+        for (size_t n = 0; n < b->nblocks; n++)
+        {
+                unpackWord(&b->qs[n], b->words[n]);
+        }
+}
+
+static void stage_dequantize(Bench b)
+{
+        for (size_t n = 0; n < b->nblocks; n++)
+        {
+                dequantize(&b->dcts[n], &b->qs[n]);
+        }
+}
+
+static void stage_invert_dct(Bench b)
+{
+        for (size_t n = 0; n < b->nblocks; n++)
+        {
+                point_block(b, NULL, n);
+                invertDCT(b->cav_block, &b->dcts[n]);
+        }
+}
+
+static void stage_cav2rgb(Bench b)
+{
+        for (size_t n = 0; n < b->nblocks; n++)
+        {
+                point_block(b, b->decoded, n);
+                CAVtoRGB_block(b->rgb_block, b->cav_block,
+                               b->decoded->denominator);
+        }
+}
+
+static void stage_write(Bench b)
+{
+        Pnm_ppmwrite(b->sink, b->decoded);
+        fflush(b->sink);
+}
+
+static const Stage STAGES[] = {
+        {"read", stage_read, undo_read},
+        {"rgb2cav", stage_rgb2cav, NULL},
+        {"dct", stage_dct, NULL},
+        {"frame_from_ppm", stage_frame, NULL},
+        {"dct_frame", stage_dct_frame, NULL},
+        {"quantize", stage_quantize, NULL},
+        {"pack", stage_pack, NULL},
+        {"output", stage_output, NULL},
+        {"input", stage_input, NULL},
+        {"unpack", stage_unpack, NULL},
+        {"dequantize", stage_dequantize, NULL},
+        {"invert_dct", stage_invert_dct, NULL},
+        {"cav2rgb", stage_cav2rgb, NULL},
+        {"write", stage_write, NULL},
+};
+#define NUM_STAGES (sizeof(STAGES) / sizeof(STAGES[0]))
+
+/********** Bench_new ********
+ *
+ * Reads an image and runs it through every stage once, so that each
+ * stage's input is ready.
+ *
+ * Parameters:
+ *      const char *ppm:  The image as PPM bytes.
+ *      size_t len:       The number of bytes in ppm.
+ *      FILE *sink:       Where the output stages write.
+ *
+ * Return:
+ *      Bench:            The prepared bench. Free with Bench_free.
+ ************************/
+static Bench Bench_new(const char *ppm, size_t len, FILE *sink)
+{
+        Bench b;
+        NEW(b);
+        b->ppm = ppm;
+        b->ppm_len = len;
+        b->sink = sink;
+
+        FILE *fp = fmemopen((void *)ppm, len, "r");
+        assert(fp != NULL);
+        b->image = Pnm_ppmread(fp, uarray2_methods_plain);
+        fclose(fp);
+
+        b->cols = b->image->width / 2;
+        b->rows = b->image->height / 2;
+        b->nblocks = (size_t)b->cols * b->rows;
+        b->cavs = CALLOC(4 * b->nblocks + 1, sizeof(struct CAV));
+        b->dcts = CALLOC(b->nblocks + 1, sizeof(struct DCT));
+        b->qs = CALLOC(b->nblocks + 1, sizeof(struct Quantized));
+        b->words = CALLOC(b->nblocks + 1, sizeof(uint32_t));
+        NEW(b->rgb_block);
+        NEW(b->cav_block);
+
+        b->arena = JobArena_new(4096);
+        b->frame = Frame_arena_new(b->arena, b->cols * 2, b->rows * 2);
+
+        NEW(b->decoded);
+        b->decoded->width = b->cols * 2;
+        b->decoded->height = b->rows * 2;
+        b->decoded->denominator = 255;
+        b->decoded->methods = uarray2_methods_plain;
+        b->decoded->pixels = b->decoded->methods->new(b->decoded->width,
+                                                      b->decoded->height,
+                                                      sizeof(struct Pnm_rgb));
+
+        /* Encode once to get the compressed bytes for the decode stages */
+        stage_frame(b);
+        stage_dct_frame(b);
+        stage_quantize(b);
+        stage_pack(b);
+        FILE *out = open_memstream(&b->compressed, &b->compressed_len);
+        FILE *saved = b->sink;
+        b->sink = out;
+        stage_output(b);
+        fclose(out);
+        b->sink = saved;
+
+        /* And leave intermediate results for stages that need them */
+        stage_rgb2cav(b);
+        return b;
+}
+
+/********** Bench_free ********
+ *
+ * Frees a bench made by Bench_new.
+ *
+ * Parameters:
+ *      Bench *b:         A pointer to the bench. Set to NULL.
+ ************************/
+static void Bench_free(Bench *b)
+{
+        Bench bench = *b;
+        Pnm_ppmfree(&bench->image);
+        Pnm_ppmfree(&bench->decoded);
+        FREE(bench->cavs);
+        FREE(bench->dcts);
+        FREE(bench->qs);
+        FREE(bench->words);
+        FREE(bench->rgb_block);
+        FREE(bench->cav_block);
+        free(bench->compressed);
+        JobArena_free(&bench->arena);
+        FREE(*b);
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+        uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+        return (x > y) - (x < y);
+}
+
+/********** median ********
+ *
+ * Gets the median of n samples, sorting them in place.
+ ************************/
+static uint64_t median(uint64_t *samples, int n)
+{
+        qsort(samples, n, sizeof(*samples), compare_u64);
+        return samples[n / 2];
+}
+
+/********** run_image ********
+ *
+ * Times every stage on one image and prints the image's JSON object.
+ *
+ * Parameters:
+ *      const char *name:     The name to report for the image.
+ *      const char *ppm:      The image as PPM bytes.
+ *      size_t len:           The number of bytes in ppm.
+ *      int reps:             The number of timed runs of each stage.
+ *      int warmup:           The number of untimed runs before those.
+ *      FILE *sink:           Where the output stages write.
+ ************************/
+static void run_image(const char *name, const char *ppm, size_t len,
+                      int reps, int warmup, FILE *sink)
+{
+        Bench b = Bench_new(ppm, len, sink);
+        double pixels = 4.0 * b->nblocks;
+        uint64_t *ns = CALLOC(reps, sizeof(uint64_t));
+        uint64_t *cycles = CALLOC(reps, sizeof(uint64_t));
+
+        printf("    {\"image\": \"%s\", \"width\": %u, \"height\": %u, "
+               "\"blocks\": %zu,\n     \"stages\": [\n", name,
+               b->image->width, b->image->height, b->nblocks);
+        for (size_t s = 0; s < NUM_STAGES; s++) {
+                const Stage *stage = &STAGES[s];
+                for (int r = -warmup; r < reps; r++) {
+                        uint64_t c0 = Timer_cycles();
+                        uint64_t t0 = Timer_ns();
+                        stage->run(b);
+                        uint64_t t1 = Timer_ns();
+                        uint64_t c1 = Timer_cycles();
+                        if (stage->undo != NULL) {
+                                stage->undo(b);
+                        }
+                        if (r >= 0) {
+                                ns[r] = t1 - t0;
+                                cycles[r] = c1 - c0;
+                        }
+                }
+
+                double med = median(ns, reps);
+                printf("      {\"stage\": \"%s\", \"median_ns\": %.0f, "
+                       "\"ns_per_block\": %.3f, \"mb_per_s\": %.1f, "
+                       "\"cycles_per_pixel\": ", stage->name, med,
+                       med / b->nblocks, 3 * pixels / med * 1e3);
+                if (Timer_has_cycles()) {
+                        printf("%.3f}", median(cycles, reps) / pixels);
+                } else {
+                        printf("null}");
+                }
+                printf("%s\n", s + 1 < NUM_STAGES ? "," : "");
+        }
+        printf("     ]}");
+
+        FREE(cycles);
+        FREE(ns);
+        Bench_free(&b);
+}
+
+int main(int argc, char *argv[])
+{
+        int reps = 5, warmup = 1, synthetic = 1;
+        int i;
+
+        for (i = 1; i < argc; i++) {
+                if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+                        reps = atoi(argv[++i]);
+                } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+                        warmup = atoi(argv[++i]);
+                } else if (strcmp(argv[i], "-S") == 0) {
+                        synthetic = 0;
+                } else if (argv[i][0] == '-') {
+                        fprintf(stderr, "Usage: %s [-r repetitions] "
+                                "[-w warmup] [-S] [file.ppm ...]\n",
+                                argv[0]);
+                        exit(1);
+                } else {
+                        break;
+                }
+        }
+        if (reps < 1 || warmup < 0) {
+                fprintf(stderr, "%s: need -r >= 1 and -w >= 0\n", argv[0]);
+                exit(1);
+        }
+
+        FILE *sink = fopen("/dev/null", "w");
+        assert(sink != NULL);
+
+        printf("{\"repetitions\": %d, \"warmup\": %d, \"cycles\": %s,\n"
+               " \"kernels\": \"%s\",\n"
+               " \"images\": [\n", reps, warmup,
+               Timer_has_cycles() ? "\"tsc\"" : "null",
+               Kernels_active()->name);
+        int first = 1;
+        for (size_t s = 0; synthetic && s < NUM_SYNTHETIC; s++) {
+                char name[32];
+                size_t len;
+                snprintf(name, sizeof(name), "synthetic-%u",
+                         SYNTHETIC_SIZES[s]);
+                char *ppm = Ppmsynth_image(PPMSYNTH_FRACTAL,
+                                           SYNTHETIC_SIZES[s],
+                                           SYNTHETIC_SIZES[s], 255, 0, &len);
+                printf("%s", first ? "" : ",\n");
+                run_image(name, ppm, len, reps, warmup, sink);
+                FREE(ppm);
+                first = 0;
+        }
+        for (; i < argc; i++) {
+                FILE *fp = fopen(argv[i], "r");
+                if (fp == NULL) {
+                        fprintf(stderr, "%s: cannot open %s\n", argv[0],
+                                argv[i]);
+                        exit(1);
+                }
+                size_t len = 0, cap = 65536;
+                char *ppm = ALLOC(cap);
+                while ((len += fread(ppm + len, 1, cap - len, fp)) == cap) {
+                        cap *= 2;
+                        RESIZE(ppm, cap);
+                }
+                fclose(fp);
+
+                printf("%s", first ? "" : ",\n");
+                run_image(argv[i], ppm, len, reps, warmup, sink);
+                FREE(ppm);
+                first = 0;
+        }
+        printf("\n ]}\n");
+
+        fclose(sink);
+        return EXIT_SUCCESS;
+}
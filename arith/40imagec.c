@@ -0,0 +1,111 @@
+/**************************************************************
+ *
+ *                     40imagec.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     A test client for 40imaged. Behaves like 40image, but hands the
+ *     work to the server: the image is sent inline, or with -f the input
+ *     file and stdout are passed to the server as file descriptors. -S
+ *     prints the server's latency stats instead.
+ *
+ *     Usage: 40imagec [-s socket] [-f] -c|-d [filename]
+ *            40imagec [-s socket] -S
+ *
+ ************************/
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "imaged.h"
+
+int main(int argc, char *argv[])
+{
+        const char *path = IMAGED_DEFAULT_SOCKET;
+        int op = IMAGED_COMPRESS;
+        int pass_fds = 0;
+        int i;
+
+        for (i = 1; i < argc; i++) {
+                if (strcmp(argv[i], "-c") == 0) {
+                        op = IMAGED_COMPRESS;
+                } else if (strcmp(argv[i], "-d") == 0) {
+                        op = IMAGED_DECOMPRESS;
+                } else if (strcmp(argv[i], "-S") == 0) {
+                        op = IMAGED_STATS;
+                } else if (strcmp(argv[i], "-f") == 0) {
+                        pass_fds = 1;
+                } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+                        path = argv[++i];
+                } else if (*argv[i] == '-') {
+                        fprintf(stderr, "%s: unknown option '%s'\n",
+                                argv[0], argv[i]);
+                        exit(1);
+                } else {
+                        break;
+                }
+        }
+        if (argc - i > 1) {
+                fprintf(stderr, "Usage: %s [-s socket] [-f] -c|-d [filename]\n"
+                        "       %s [-s socket] -S\n", argv[0], argv[0]);
+                exit(1);
+        }
+
+        int sock = Imaged_connect(path);
+        if (sock < 0) {
+                fprintf(stderr, "%s: cannot connect to %s\n", argv[0], path);
+                exit(1);
+        }
+
+        Imaged_header req = {IMAGED_MAGIC, op, 0, 0};
+        char *payload = NULL;
+        int fds[2];
+        int nfds = 0;
+
+        if (op != IMAGED_STATS && pass_fds) {
+                fds[nfds++] = i < argc ? open(argv[i], O_RDONLY) : 0;
+                assert(fds[0] >= 0);
+                fds[nfds++] = 1;
+                req.flags = IMAGED_FD_IN | IMAGED_FD_OUT;
+        } else if (op != IMAGED_STATS) {
+                FILE *fp = i < argc ? fopen(argv[i], "r") : stdin;
+                assert(fp != NULL);
+                size_t len;
+                payload = Imaged_slurp(fp, &len);
+                req.length = len;
+                if (fp != stdin) {
+                        fclose(fp);
+                }
+        }
+
+        Imaged_header resp;
+        int rfds[2];
+        int nrfds;
+        if (Imaged_send(sock, &req, payload, fds, nfds) < 0 ||
+            Imaged_recv(sock, &resp, rfds, &nrfds) < 0 ||
+            resp.op != IMAGED_OK) {
+                fprintf(stderr, "%s: request failed\n", argv[0]);
+                exit(1);
+        }
+
+        if (!(resp.flags & IMAGED_FD_OUT)) {
+                char *result = ALLOC(resp.length + 1);
+                int rc = Imaged_read_full(sock, result, resp.length);
+                assert(rc == 0);
+                fwrite(result, 1, resp.length, stdout);
+                FREE(result);
+        }
+
+        if (payload != NULL) {
+                FREE(payload);
+        }
+        close(sock);
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,774 @@
+/**************************************************************
+ *
+ *                     40imaged.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     A persistent codec server. Listens on a Unix domain socket and
+ *     serves compress/decompress requests (see imaged.h) on a thread pool
+ *     that is created once at startup, so clients pay no per-image process
+ *     setup. The main thread waits on every open connection with poll and
+ *     hands each request that arrives to the pool as a job of its own, so
+ *     a worker is busy only while it serves a request, never while a
+ *     client sits idle. Keeps the latencies of the most recent requests
+ *     and reports p50/p99 on a stats request and at shutdown.
+ *
+ *     Every image is checked before it is coded, so a truncated or
+ *     malformed image, or one bigger than -m bytes, gets an error response
+ *     instead of stopping the server.
+ *
+ *     Usage: 40imaged [-s socket] [-t threads] [-m max_bytes]
+ *                     [-T trace.json] [-Q]
+ *            -m caps the size of an image sent or produced (default 1GB).
+ *            -Q prints quantization telemetry at shutdown.
+ *
+ ************************/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "codec40.h"
+#include "compress40_io.h"
+#include "imaged.h"
+#include "ppmrows.h"
+#include "threadpool.h"
+#include "trace.h"
+#include "quantstats.h"
+
+#define LATENCY_WINDOW 65536
+
+/* The default cap on the bytes of an image sent or produced */
+#define DEFAULT_MAX_LENGTH ((size_t)1 << 30)
+
+/* Seconds a worker waits on a stalled client before giving up on it */
+#define IO_TIMEOUT 10
+
+/********** Latencies ********
+ *
+ * The latencies of the most recent requests, kept in a ring buffer.
+ *
+ * Elements:
+ *      pthread_mutex_t lock:           Protects the other fields.
+ *      double us[LATENCY_WINDOW]:      Latencies in microseconds.
+ *      uint64_t count:                 Requests served since startup.
+ ************************/
+static struct Latencies
+{
+        pthread_mutex_t lock;
+        double us[LATENCY_WINDOW];
+        uint64_t count;
+} latencies = {PTHREAD_MUTEX_INITIALIZER, {0}, 0};
+
+/********** Conn ********
+ *
+ * An open client connection.
+ *
+ * Elements:
+ *      int sock:       The connected socket. Only the main thread closes
+ *                      it.
+ *      int busy:       1 while a worker is serving a request on it.
+ *      int done:       Set by the worker when the connection should be
+ *                      closed.
+ *      Conn *next:     The next connection in the returned list.
+ ************************/
+typedef struct Conn
+{
+        int sock;
+        int busy;
+        int done;
+        struct Conn *next;
+} Conn;
+
+/********** Returned ********
+ *
+ * Connections that workers have finished a request on, waiting for the
+ * main thread to poll them again.
+ *
+ * Elements:
+ *      pthread_mutex_t lock:   Protects conns.
+ *      Conn *conns:            The returned connections.
+ *      int wake[2]:            A pipe that wakes the main thread's poll.
+ ************************/
+static struct Returned
+{
+        pthread_mutex_t lock;
+        Conn *conns;
+        int wake[2];
+} returned = {PTHREAD_MUTEX_INITIALIZER, NULL, {-1, -1}};
+
+static volatile sig_atomic_t stopping = 0;
+static size_t max_length = DEFAULT_MAX_LENGTH;
+
+static void serve_conn(void *arg);
+static int serve_request(int sock, Imaged_header *req, int *fds, int nfds);
+static int send_error(int sock, Imaged_header *req);
+static char *read_fd(int fd, size_t *len);
+static int check_image(int op, const char *image, size_t len);
+static int check_ppm(const char *image, size_t len);
+static void open_conn(Conn ***conns, size_t *nconns, size_t *cap,
+                      int sock);
+static void take_returned(Conn **conns, size_t *nconns);
+static void record_latency(double us);
+static char *format_stats(size_t *len);
+
+/********** now_us ********
+ *
+ * Gets the monotonic clock in microseconds.
+ ************************/
+static double now_us(void)
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/********** on_signal ********
+ *
+ * Asks the poll loop to stop, and wakes it.
+ ************************/
+static void on_signal(int sig)
+{
+        (void)sig;
+        stopping = 1;
+        int saved = errno;
+        ssize_t woke = write(returned.wake[1], "", 1);
+        (void)woke;
+        errno = saved;
+}
+
+int main(int argc, char *argv[])
+{
+        const char *path = IMAGED_DEFAULT_SOCKET;
+        const char *trace_path = NULL;
+        int nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+        int i;
+
+        for (i = 1; i < argc; i++)
+        {
+                if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+                {
+                        path = argv[++i];
+                }
+                else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+                {
+                        nthreads = atoi(argv[++i]);
+                }
+                else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+                {
+                        max_length = strtoull(argv[++i], NULL, 10);
+                }
+                else if (strcmp(argv[i], "-T") == 0 && i + 1 < argc)
+                {
+                        trace_path = argv[++i];
+                }
+                else if (strcmp(argv[i], "-Q") == 0)
+                {
+                        Quantstats_enabled = 1;
+                }
+                else
+                {
+                        fprintf(stderr, "Usage: %s [-s socket] [-t threads] "
+                                "[-m max_bytes] [-T trace.json] [-Q]\n",
+                                argv[0]);
+                        exit(1);
+                }
+        }
+        if (nthreads < 1)
+        {
+                nthreads = 1;
+        }
+        if (max_length == 0)
+        {
+                max_length = DEFAULT_MAX_LENGTH;
+        }
+        if (trace_path != NULL)
+        {
+                Trace_start();
+        }
+
+        struct sockaddr_un addr;
+        assert(strlen(path) < sizeof(addr.sun_path));
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strcpy(addr.sun_path, path);
+
+        int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        assert(listener >= 0);
+        unlink(path);
+        if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+            listen(listener, SOMAXCONN) < 0)
+        {
+                fprintf(stderr, "%s: cannot listen on %s: %s\n",
+                        argv[0], path, strerror(errno));
+                exit(1);
+        }
+        int rc = pipe(returned.wake);
+        assert(rc == 0);
+        for (i = 0; i < 2; i++)
+        {
+                fcntl(returned.wake[i], F_SETFD, FD_CLOEXEC);
+                fcntl(returned.wake[i], F_SETFL, O_NONBLOCK);
+        }
+
+        /* The handler wakes poll through the pipe, so a signal that
+         * arrives just before poll waits is not missed. The workers start
+         * with the signals blocked, so only the main thread handles them. */
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = on_signal;
+        sigaction(SIGINT, &sa, NULL);
+        sigaction(SIGTERM, &sa, NULL);
+        signal(SIGPIPE, SIG_IGN);
+        sigset_t stop_signals, mask;
+        sigemptyset(&stop_signals);
+        sigaddset(&stop_signals, SIGINT);
+        sigaddset(&stop_signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &stop_signals, &mask);
+        ThreadPool_T pool = ThreadPool_new(nthreads);
+        pthread_sigmask(SIG_SETMASK, &mask, NULL);
+
+        fprintf(stderr, "%s: listening on %s with %d threads\n",
+                argv[0], path, nthreads);
+
+        size_t nconns = 0, cap = 16;
+        Conn **conns = ALLOC(cap * sizeof(*conns));
+        struct pollfd *pfds = ALLOC((cap + 2) * sizeof(*pfds));
+        Conn **polled = ALLOC(cap * sizeof(*polled));
+        while (!stopping)
+        {
+                /* Poll for new clients, returned connections and requests
+                 * on the connections no worker is serving */
+                pfds[0] = (struct pollfd){listener, POLLIN, 0};
+                pfds[1] = (struct pollfd){returned.wake[0], POLLIN, 0};
+                size_t npolled = 0;
+                for (size_t c = 0; c < nconns; c++)
+                {
+                        if (!conns[c]->busy)
+                        {
+                                pfds[npolled + 2] = (struct pollfd){
+                                        conns[c]->sock, POLLIN, 0};
+                                polled[npolled++] = conns[c];
+                        }
+                }
+                if (poll(pfds, npolled + 2, -1) < 0)
+                {
+                        continue;
+                }
+
+                for (size_t p = 0; p < npolled; p++)
+                {
+                        if (pfds[p + 2].revents != 0)
+                        {
+                                polled[p]->busy = 1;
+                                ThreadPool_submit(pool, serve_conn,
+                                                  polled[p]);
+                        }
+                }
+                if (pfds[1].revents != 0)
+                {
+                        take_returned(conns, &nconns);
+                }
+                if (pfds[0].revents != 0)
+                {
+                        int client = accept(listener, NULL, NULL);
+                        if (client >= 0)
+                        {
+                                fcntl(client, F_SETFD, FD_CLOEXEC);
+                                size_t old = cap;
+                                open_conn(&conns, &nconns, &cap, client);
+                                if (cap != old)
+                                {
+                                        RESIZE(pfds,
+                                               (cap + 2) * sizeof(*pfds));
+                                        RESIZE(polled,
+                                               cap * sizeof(*polled));
+                                }
+                        }
+                }
+        }
+
+        /* Stop accepting, let requests in progress finish, and end every
+         * connection once its current request is answered */
+        close(listener);
+        unlink(path);
+        for (size_t c = 0; c < nconns; c++)
+        {
+                shutdown(conns[c]->sock, SHUT_RD);
+        }
+        ThreadPool_free(&pool);
+        for (size_t c = 0; c < nconns; c++)
+        {
+                close(conns[c]->sock);
+                FREE(conns[c]);
+        }
+        FREE(conns);
+        FREE(pfds);
+        FREE(polled);
+        close(returned.wake[0]);
+        close(returned.wake[1]);
+
+        size_t len;
+        char *stats = format_stats(&len);
+        fputs(stats, stderr);
+        FREE(stats);
+        if (Quantstats_enabled)
+        {
+                Quantstats_report(stderr);
+        }
+        if (trace_path != NULL)
+        {
+                Trace_enabled = 0;
+                FILE *trace = fopen(trace_path, "w");
+                if (trace != NULL)
+                {
+                        Trace_dump(trace);
+                        fclose(trace);
+                }
+        }
+
+        return EXIT_SUCCESS;
+}
+
+/********** open_conn ********
+ *
+ * Adds a newly accepted client to the connections the main thread polls.
+ *
+ * Parameters:
+ *      Conn ***conns:  The open connections, grown when full.
+ *      size_t *nconns: The number of open connections.
+ *      size_t *cap:    The capacity of *conns; doubled when it grows.
+ *      int sock:       The accepted socket.
+ *
+ * Notes:
+ *      Reads and writes on the socket time out after IO_TIMEOUT seconds,
+ *      so a client that stalls mid-request cannot hold a worker forever.
+ ************************/
+static void open_conn(Conn ***conns, size_t *nconns, size_t *cap, int sock)
+{
+        struct timeval timeout = {IO_TIMEOUT, 0};
+        setsockopt(sock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(sock, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        if (*nconns == *cap)
+        {
+                *cap *= 2;
+                RESIZE(*conns, *cap * sizeof(**conns));
+        }
+        Conn *conn;
+        NEW(conn);
+        conn->sock = sock;
+        conn->busy = 0;
+        conn->done = 0;
+        conn->next = NULL;
+        (*conns)[(*nconns)++] = conn;
+}
+
+/********** take_returned ********
+ *
+ * Takes back the connections workers have finished with, closing those
+ * that are done.
+ *
+ * Parameters:
+ *      Conn **conns:   The open connections.
+ *      size_t *nconns: The number of open connections.
+ ************************/
+static void take_returned(Conn **conns, size_t *nconns)
+{
+        char drain[64];
+        while (read(returned.wake[0], drain, sizeof(drain)) > 0)
+        {
+        }
+
+        pthread_mutex_lock(&returned.lock);
+        Conn *list = returned.conns;
+        returned.conns = NULL;
+        pthread_mutex_unlock(&returned.lock);
+
+        for (; list != NULL; list = list->next)
+        {
+                list->busy = 0;
+        }
+        for (size_t c = 0; c < *nconns;)
+        {
+                if (conns[c]->busy || !conns[c]->done)
+                {
+                        c++;
+                        continue;
+                }
+                close(conns[c]->sock);
+                FREE(conns[c]);
+                conns[c] = conns[--*nconns];
+        }
+}
+
+/********** serve_conn ********
+ *
+ * Pool job: serves the one request waiting on a connection, then hands
+ * the connection back to the main thread.
+ *
+ * Parameters:
+ *      void *arg:      The Conn.
+ ************************/
+static void serve_conn(void *arg)
+{
+        Conn *conn = arg;
+        Imaged_header req;
+        int fds[2];
+        int nfds;
+
+        if (Imaged_recv(conn->sock, &req, fds, &nfds) == 0)
+        {
+                double start = now_us();
+                Trace_begin("request", TRACE_NO_STRIP);
+                int rc = serve_request(conn->sock, &req, fds, nfds);
+                Trace_end("request", TRACE_NO_STRIP);
+                for (int i = 0; i < nfds; i++)
+                {
+                        close(fds[i]);
+                }
+                conn->done = rc < 0;
+                if (req.op != IMAGED_STATS)
+                {
+                        record_latency(now_us() - start);
+                }
+        }
+        else
+        {
+                conn->done = 1;
+        }
+
+        pthread_mutex_lock(&returned.lock);
+        conn->next = returned.conns;
+        returned.conns = conn;
+        pthread_mutex_unlock(&returned.lock);
+        ssize_t woke = write(returned.wake[1], "", 1);
+        (void)woke;     /* a full pipe will wake the main thread anyway */
+}
+
+/********** serve_request ********
+ *
+ * Runs one request and sends its response.
+ *
+ * Parameters:
+ *      int sock:            The client's socket.
+ *      Imaged_header *req:  The request header. Its inline payload, if
+ *                           any, is still on the socket.
+ *      int *fds:            Descriptors passed with the request.
+ *      int nfds:            The number of descriptors in fds.
+ *
+ * Return:
+ *      int:                 0 if the connection can carry on, -1 if it
+ *                           should be closed.
+ *
+ * Notes:
+ *      An image that is too big, truncated or malformed, or a descriptor
+ *      that cannot be read or written, gets an IMAGED_ERROR response.
+ *      An inline payload over the cap is not read, so the connection is
+ *      closed after the response.
+ ************************/
+static int serve_request(int sock, Imaged_header *req, int *fds, int nfds)
+{
+        Imaged_header resp = {IMAGED_MAGIC, IMAGED_ERROR, req->flags, 0};
+        int want_fds = ((req->flags & IMAGED_FD_IN) != 0) +
+                       ((req->flags & IMAGED_FD_OUT) != 0);
+
+        if (req->op == IMAGED_STATS)
+        {
+                size_t len;
+                char *stats = format_stats(&len);
+                resp.op = IMAGED_OK;
+                resp.flags = 0;
+                resp.length = len;
+                int rc = Imaged_send(sock, &resp, stats, NULL, 0);
+                FREE(stats);
+                return rc;
+        }
+        if ((req->op != IMAGED_COMPRESS && req->op != IMAGED_DECOMPRESS) ||
+            nfds != want_fds)
+        {
+                return -1;
+        }
+
+        /* Read the whole input, so it can be checked before coding */
+        char *inbuf;
+        size_t inlen;
+        if (req->flags & IMAGED_FD_IN)
+        {
+                inbuf = read_fd(fds[0], &inlen);
+        }
+        else
+        {
+                if (req->length == 0 || req->length > max_length)
+                {
+                        send_error(sock, req);
+                        return -1;
+                }
+                inlen = req->length;
+                inbuf = ALLOC(inlen);
+                if (Imaged_read_full(sock, inbuf, inlen) < 0)
+                {
+                        FREE(inbuf);
+                        return -1;
+                }
+        }
+        if (inbuf == NULL || !check_image(req->op, inbuf, inlen))
+        {
+                FREE(inbuf);
+                return send_error(sock, req);
+        }
+
+        FILE *input = fmemopen(inbuf, inlen, "r");
+        FILE *output = NULL;
+        char *outbuf = NULL;
+        size_t outlen = 0;
+        if (req->flags & IMAGED_FD_OUT)
+        {
+                int out = dup(fds[nfds - 1]);
+                output = out < 0 ? NULL : fdopen(out, "w");
+                if (output == NULL && out >= 0)
+                {
+                        close(out);
+                }
+        }
+        else
+        {
+                output = open_memstream(&outbuf, &outlen);
+        }
+        if (input == NULL || output == NULL)
+        {
+                if (input != NULL)
+                {
+                        fclose(input);
+                }
+                if (output != NULL)
+                {
+                        fclose(output);
+                }
+                free(outbuf);   /* allocated by open_memstream */
+                FREE(inbuf);
+                return send_error(sock, req);
+        }
+
+        if (req->op == IMAGED_COMPRESS)
+        {
+                compress40_to(input, output);
+        }
+        else
+        {
+                decompress40_to(input, output);
+        }
+        long written = ftell(output);
+        resp.length = written < 0 ? 0 : written;
+        int failed = ferror(output);
+        failed |= fclose(output) != 0;
+        fclose(input);
+        FREE(inbuf);
+        if (failed)
+        {
+                free(outbuf);
+                return send_error(sock, req);
+        }
+
+        resp.op = IMAGED_OK;
+        int rc = Imaged_send(sock, &resp, outbuf, NULL, 0);
+        free(outbuf);
+        return rc;
+}
+
+/********** send_error ********
+ *
+ * Sends an IMAGED_ERROR response with no payload.
+ *
+ * Parameters:
+ *      int sock:            The client's socket.
+ *      Imaged_header *req:  The request that failed.
+ *
+ * Return:
+ *      int:                 0 on success, -1 on failure.
+ ************************/
+static int send_error(int sock, Imaged_header *req)
+{
+        Imaged_header resp = {IMAGED_MAGIC, IMAGED_ERROR, req->flags, 0};
+        return Imaged_send(sock, &resp, NULL, NULL, 0);
+}
+
+/********** read_fd ********
+ *
+ * Reads a descriptor to its end.
+ *
+ * Parameters:
+ *      int fd:         The descriptor to read.
+ *      size_t *len:    Filled in with the number of bytes read.
+ *
+ * Return:
+ *      char *:         The bytes read, which the client must FREE, or
+ *                      NULL if reading fails or there are more than
+ *                      max_length bytes.
+ ************************/
+static char *read_fd(int fd, size_t *len)
+{
+        size_t cap = 65536;
+        char *buf = ALLOC(cap);
+        *len = 0;
+
+        for (;;)
+        {
+                if (*len == cap)
+                {
+                        cap *= 2;
+                        RESIZE(buf, cap);
+                }
+                ssize_t got = read(fd, buf + *len, cap - *len);
+                if (got < 0 && errno == EINTR)
+                {
+                        continue;
+                }
+                if (got < 0 || *len + got > max_length)
+                {
+                        FREE(buf);
+                        return NULL;
+                }
+                if (got == 0)
+                {
+                        return buf;
+                }
+                *len += got;
+        }
+}
+
+/********** check_image ********
+ *
+ * Checks that an image can be coded without tripping any of the codec's
+ * checked runtime errors, and that the result stays under the cap.
+ *
+ * Parameters:
+ *      int op:                 IMAGED_COMPRESS or IMAGED_DECOMPRESS.
+ *      const char *image:      The image.
+ *      size_t len:             The number of bytes in image.
+ *
+ * Return:
+ *      int:                    1 if the image can be coded, else 0.
+ ************************/
+static int check_image(int op, const char *image, size_t len)
+{
+        if (op == IMAGED_COMPRESS)
+        {
+                return check_ppm(image, len);
+        }
+
+        /* decompress40 asserts on a truncated image or an illegal
+         * codeword, so both are rejected here */
+        unsigned width, height;
+        if (Codec40_check((const unsigned char *)image, len, &width,
+                          &height) == 0)
+        {
+                return 0;
+        }
+        return width <= INT_MAX && height <= INT_MAX &&
+               3 * (size_t)width * height <= max_length;
+}
+
+/********** check_ppm ********
+ *
+ * Checks that a PPM has a valid header, every row it promises, and no
+ * sample above its maximum value.
+ *
+ * Parameters:
+ *      const char *image:      The PPM.
+ *      size_t len:             The number of bytes in image.
+ *
+ * Return:
+ *      int:                    1 if the PPM is whole and valid, else 0.
+ ************************/
+static int check_ppm(const char *image, size_t len)
+{
+        FILE *fp = fmemopen((void *)image, len, "r");
+        if (fp == NULL)
+        {
+                return 0;
+        }
+        Ppmrows_T rows = Ppmrows_new(fp);
+        int valid = rows != NULL;
+        for (unsigned row = 0; valid && row < Ppmrows_height(rows); row++)
+        {
+                const struct Pnm_rgb *pixels = Ppmrows_next(rows);
+                unsigned denominator = Ppmrows_denominator(rows);
+                valid = pixels != NULL;
+                for (unsigned col = 0; valid && col < Ppmrows_width(rows);
+                     col++)
+                {
+                        valid = pixels[col].red <= denominator &&
+                                pixels[col].green <= denominator &&
+                                pixels[col].blue <= denominator;
+                }
+        }
+        if (rows != NULL)
+        {
+                Ppmrows_free(&rows);
+        }
+        fclose(fp);
+        return valid;
+}
+
+/********** record_latency ********
+ *
+ * Adds one request latency to the ring buffer.
+ *
+ * Parameters:
+ *      double us:      The latency in microseconds.
+ ************************/
+static void record_latency(double us)
+{
+        pthread_mutex_lock(&latencies.lock);
+        latencies.us[latencies.count % LATENCY_WINDOW] = us;
+        latencies.count++;
+        pthread_mutex_unlock(&latencies.lock);
+}
+
+/********** format_stats ********
+ *
+ * Formats the request count and latency percentiles as text.
+ *
+ * Parameters:
+ *      size_t *len:    Filled in with the length of the text.
+ *
+ * Return:
+ *      char *:         The text. Client must FREE it.
+ ************************/
+static char *format_stats(size_t *len)
+{
+        double *window = CALLOC(LATENCY_WINDOW, sizeof(double));
+
+        pthread_mutex_lock(&latencies.lock);
+        uint64_t count = latencies.count;
+        size_t n = count < LATENCY_WINDOW ? count : LATENCY_WINDOW;
+        memcpy(window, latencies.us, n * sizeof(double));
+        pthread_mutex_unlock(&latencies.lock);
+
+        double p50 = Imaged_percentile(window, n, 50);
+        double p99 = Imaged_percentile(window, n, 99);
+        FREE(window);
+
+        char *text = ALLOC(128);
+        *len = snprintf(text, 128,
+                        "requests %llu\np50_us %.1f\np99_us %.1f\n",
+                        (unsigned long long)count, p50, p99);
+        return text;
+}
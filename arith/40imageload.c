@@ -0,0 +1,229 @@
+/**************************************************************
+ *
+ *                     40imageload.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     A load generator for 40imaged. Opens -j connections, each on its
+ *     own thread, and sends the same image inline until -n requests have
+ *     been made in total. Prints client-side throughput and p50/p99
+ *     latency, followed by the server's own stats.
+ *
+ *     Usage: 40imageload [-s socket] [-n requests] [-j connections]
+ *                        -c|-d filename
+ *
+ ************************/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "imaged.h"
+
+/********** Load ********
+ *
+ * The work shared by every connection thread.
+ *
+ * Elements:
+ *      const char *path:     The server's socket.
+ *      Imaged_header req:    The request header to send.
+ *      const char *payload:  The image to send.
+ *      double *us:           One latency slot per request.
+ *      int nrequests:        The total number of requests.
+ *      int nconnections:     The number of connection threads.
+ *      int failures:         Requests that did not get an OK response.
+ ************************/
+typedef struct Load
+{
+        const char *path;
+        Imaged_header req;
+        const char *payload;
+        double *us;
+        int nrequests;
+        int nconnections;
+        int failures;
+} Load;
+
+/********** Connection ********
+ *
+ * The closure for one connection thread.
+ *
+ * Elements:
+ *      Load *load:     The shared work.
+ *      int index:      Which connection this is.
+ ************************/
+typedef struct Connection
+{
+        Load *load;
+        int index;
+} Connection;
+
+/********** now_us ********
+ *
+ * Gets the monotonic clock in microseconds.
+ ************************/
+static double now_us(void)
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+/********** run_connection ********
+ *
+ * Thread body: sends every nconnections-th request on one connection and
+ * records its latency.
+ *
+ * Parameters:
+ *      void *vconn:    The Connection for this thread.
+ *
+ * Return:
+ *      NULL.
+ ************************/
+static void *run_connection(void *vconn)
+{
+        Connection *conn = vconn;
+        Load *load = conn->load;
+        int failures = 0;
+
+        int sock = Imaged_connect(load->path);
+        if (sock < 0) {
+                failures = load->nrequests;
+        }
+
+        size_t cap = 65536;
+        char *scratch = ALLOC(cap);
+        for (int r = conn->index; sock >= 0 && r < load->nrequests;
+             r += load->nconnections) {
+                Imaged_header resp;
+                int fds[2];
+                int nfds;
+                double start = now_us();
+
+                if (Imaged_send(sock, &load->req, load->payload, NULL, 0) < 0
+                    || Imaged_recv(sock, &resp, fds, &nfds) < 0
+                    || resp.op != IMAGED_OK) {
+                        failures++;
+                        break;
+                }
+                if (resp.length > cap) {
+                        cap = resp.length;
+                        RESIZE(scratch, cap);
+                }
+                if (Imaged_read_full(sock, scratch, resp.length) < 0) {
+                        failures++;
+                        break;
+                }
+                load->us[r] = now_us() - start;
+        }
+
+        FREE(scratch);
+        if (sock >= 0) {
+                close(sock);
+        }
+        __atomic_add_fetch(&load->failures, failures, __ATOMIC_RELAXED);
+        return NULL;
+}
+
+/********** print_server_stats ********
+ *
+ * Asks the server for its stats and copies them to stdout.
+ *
+ * Parameters:
+ *      const char *path:       The server's socket.
+ ************************/
+static void print_server_stats(const char *path)
+{
+        int sock = Imaged_connect(path);
+        if (sock < 0) {
+                return;
+        }
+
+        Imaged_header req = {IMAGED_MAGIC, IMAGED_STATS, 0, 0};
+        Imaged_header resp;
+        int fds[2];
+        int nfds;
+        if (Imaged_send(sock, &req, NULL, NULL, 0) == 0 &&
+            Imaged_recv(sock, &resp, fds, &nfds) == 0) {
+                char *text = ALLOC(resp.length + 1);
+                if (Imaged_read_full(sock, text, resp.length) == 0) {
+                        text[resp.length] = '\0';
+                        printf("server:\n%s", text);
+                }
+                FREE(text);
+        }
+        close(sock);
+}
+
+int main(int argc, char *argv[])
+{
+        Load load = {IMAGED_DEFAULT_SOCKET, {IMAGED_MAGIC, IMAGED_COMPRESS,
+                     0, 0}, NULL, NULL, 1000, 4, 0};
+        int i;
+
+        for (i = 1; i < argc; i++) {
+                if (strcmp(argv[i], "-c") == 0) {
+                        load.req.op = IMAGED_COMPRESS;
+                } else if (strcmp(argv[i], "-d") == 0) {
+                        load.req.op = IMAGED_DECOMPRESS;
+                } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+                        load.path = argv[++i];
+                } else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+                        load.nrequests = atoi(argv[++i]);
+                } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+                        load.nconnections = atoi(argv[++i]);
+                } else {
+                        break;
+                }
+        }
+        if (argc - i != 1 || load.nrequests < 1 || load.nconnections < 1) {
+                fprintf(stderr, "Usage: %s [-s socket] [-n requests] "
+                        "[-j connections] -c|-d filename\n", argv[0]);
+                exit(1);
+        }
+
+        FILE *fp = fopen(argv[i], "r");
+        assert(fp != NULL);
+        size_t len;
+        char *payload = Imaged_slurp(fp, &len);
+        fclose(fp);
+        load.payload = payload;
+        load.req.length = len;
+        load.us = CALLOC(load.nrequests, sizeof(double));
+
+        pthread_t *threads = CALLOC(load.nconnections, sizeof(pthread_t));
+        Connection *conns = CALLOC(load.nconnections, sizeof(Connection));
+        double start = now_us();
+        for (int c = 0; c < load.nconnections; c++) {
+                conns[c].load = &load;
+                conns[c].index = c;
+                pthread_create(&threads[c], NULL, run_connection, &conns[c]);
+        }
+        for (int c = 0; c < load.nconnections; c++) {
+                pthread_join(threads[c], NULL);
+        }
+        double elapsed = (now_us() - start) / 1e6;
+
+        int ok = load.nrequests - load.failures;
+        printf("requests %d (failed %d) over %d connections in %.3f s\n",
+               load.nrequests, load.failures, load.nconnections, elapsed);
+        printf("throughput %.1f req/s, %.1f MB/s in\n", ok / elapsed,
+               ok * (double)len / elapsed / 1e6);
+        printf("p50_us %.1f\np99_us %.1f\n",
+               Imaged_percentile(load.us, load.nrequests, 50),
+               Imaged_percentile(load.us, load.nrequests, 99));
+        print_server_stats(load.path);
+
+        FREE(conns);
+        FREE(threads);
+        FREE(load.us);
+        FREE(payload);
+        return load.failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
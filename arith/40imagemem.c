@@ -0,0 +1,84 @@
+/**************************************************************
+ *
+ *                     40imagemem.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     A peak-memory regression test. Linked with the accounting
+ *     allocator (memacct.c), it compresses a reference image and then
+ *     decompresses the result, prints where the memory went in each, and
+ *     fails if the peak live bytes of either exceed a budget.
+ *
+ *     Usage: 40imagemem budget_kb file.ppm
+ *
+ ************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "assert.h"
+#include "compress40_io.h"
+#include "jobarena.h"
+#include "memacct.h"
+
+/********** measure ********
+ *
+ * Runs one codec direction under accounting and checks its peak. The
+ * thread's arena is released first, so memory the previous run left in
+ * it does not hide this run's largest allocations in the baseline.
+ *
+ * Parameters:
+ *      const char *what:       The name of the run.
+ *      void (*run)(FILE *, FILE *):  compress40_to or decompress40_to.
+ *      FILE *input:            The input stream.
+ *      FILE *output:           The output stream.
+ *      size_t budget:          The most live bytes allowed.
+ *
+ * Return:
+ *      int:                    1 if the peak was within budget, else 0.
+ ************************/
+static int measure(const char *what, void (*run)(FILE *, FILE *),
+                   FILE *input, FILE *output, size_t budget)
+{
+        JobArena_thread_release();
+        Memacct_reset();
+        size_t before = Memacct_live();
+        run(input, output);
+        size_t peak = Memacct_peak() - before;
+
+        printf("%s: peak %zu bytes, budget %zu bytes: %s\n", what, peak,
+               budget, peak <= budget ? "ok" : "OVER BUDGET");
+        Memacct_report(stdout);
+        return peak <= budget;
+}
+
+int main(int argc, char *argv[])
+{
+        if (argc != 3 || atol(argv[1]) <= 0) {
+                fprintf(stderr, "Usage: %s budget_kb file.ppm\n", argv[0]);
+                exit(1);
+        }
+        size_t budget = (size_t)atol(argv[1]) * 1024;
+
+        FILE *fp = fopen(argv[2], "r");
+        assert(fp != NULL);
+        char *compressed = NULL;
+        size_t len = 0;
+        FILE *out = open_memstream(&compressed, &len);
+        assert(out != NULL);
+        int ok = measure("compress", compress40_to, fp, out, budget);
+        fclose(out);
+        fclose(fp);
+
+        FILE *in = fmemopen(compressed, len, "r");
+        FILE *sink = fopen("/dev/null", "w");
+        assert(in != NULL && sink != NULL);
+        ok &= measure("decompress", decompress40_to, in, sink, budget);
+        fclose(sink);
+        fclose(in);
+        free(compressed);
+
+        return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
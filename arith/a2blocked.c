@@ -0,0 +1,253 @@
+/**************************************************************
+ *
+ *                     a2blocked.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file implements the UArray2b subclass of A2Methods_T.
+ *     It provides methods to operate on a blocked 2D unboxed array, whose
+ *     blocksize x blocksize tiles are each stored together. Only
+ *     block-major mapping is offered, since it is the order the cells
+ *     are stored in.
+ *
+ ************************/
+
+#include <stddef.h>
+
+#include <a2blocked.h>
+#include "uarray2b.h"
+
+typedef A2Methods_UArray2 A2; // private abbreviation
+
+/********** new ********
+ *
+ * Creates a new blocked 2D unboxed array with tiles of about 64KB.
+ *
+ * Parameters:
+ *      int width:      Number of columns in the array.
+ *      int height:     Number of rows in the array.
+ *      int size:       Size (in bytes) of each element.
+ *
+ * Return:
+ *      A new blocked 2D unboxed array.
+ *
+ * Expects:
+ *      width, height >= 0, and size >= 1.
+ *
+ * Notes:
+ *      Will CRE if memory allocation fails.
+ *      Will CRE if any expectation is violated.
+ *      Client is expected to free the array using the free method.
+ ************************/
+static A2Methods_UArray2 new(int width, int height, int size)
+{
+        return UArray2b_new_64K_block(width, height, size);
+}
+
+/********** new_with_blocksize ********
+ *
+ * Creates a new blocked 2D unboxed array.
+ *
+ * Parameters:
+ *      int width:      Number of columns in the array.
+ *      int height:     Number of rows in the array.
+ *      int size:       Size (in bytes) of each element.
+ *      int blocksize:  Number of cells on one side of a tile.
+ *
+ * Return:
+ *      A new blocked 2D unboxed array.
+ *
+ * Expects:
+ *      width, height >= 0, and size, blocksize >= 1.
+ *
+ * Notes:
+ *      Will CRE if memory allocation fails.
+ *      Will CRE if any expectation is violated.
+ *      Client is expected to free the array using the free method.
+ *      With a blocksize of 2, each 2x2 codec block is one tile, and a tile
+ *      of up to 16-byte elements sits in one cache line.
+ ************************/
+static A2Methods_UArray2 new_with_blocksize(int width, int height, int size,
+                                            int blocksize)
+{
+        return UArray2b_new(width, height, size, blocksize);
+}
+
+/********** a2free ********
+ *
+ * Frees a blocked 2D unboxed array and sets the caller's handle to NULL.
+ *
+ * Parameters:
+ *      A2 *array2p:    Pointer to the array to be freed.
+ *
+ * Expects:
+ *      *array2p, array2p must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+static void a2free(A2 *array2p)
+{
+        UArray2b_free((UArray2b_T *)array2p);
+}
+
+/********** width, height, size, blocksize ********
+ *
+ * Get the number of columns, the number of rows, the size of an element
+ * in bytes and the number of cells on one side of a tile.
+ *
+ * Expects:
+ *      array2 must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+static int width(A2 array2)
+{
+        return UArray2b_width(array2);
+}
+
+static int height(A2 array2)
+{
+        return UArray2b_height(array2);
+}
+
+static int size(A2 array2)
+{
+        return UArray2b_size(array2);
+}
+
+static int blocksize(A2 array2)
+{
+        return UArray2b_blocksize(array2);
+}
+
+/********** at ********
+ *
+ * Gets the element at the specified column and row.
+ *
+ * Parameters:
+ *      A2 array2:      The array where the element is located.
+ *      int col:        Column index of the element.
+ *      int row:        Row index of the element.
+ *
+ * Return:
+ *      A void pointer to the element.
+ *
+ * Expects:
+ *      array2 must not be NULL.
+ *      col and row must be within valid range
+ *      (0 <= col < width, 0 <= row < height).
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+static A2Methods_Object *at(A2 array2, int col, int row)
+{
+        return UArray2b_at(array2, col, row);
+}
+
+/********** map_block_major ********
+ *
+ * Applies a function to each element, tile by tile and row by row within
+ * each tile.
+ *
+ * Parameters:
+ *      A2 array2:                    The array to be mapped.
+ *      A2Methods_applyfun apply:     Function to be applied to each element.
+ *      void *cl:                     Closure pointer.
+ *
+ * Expects:
+ *      array2 and apply must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+static void map_block_major(A2 array2,
+                            A2Methods_applyfun apply,
+                            void *cl)
+{
+        UArray2b_map(array2, (UArray2b_applyfun *)apply, cl);
+}
+
+struct small_closure
+{
+        A2Methods_smallapplyfun *apply;
+        void *cl;
+};
+
+/* apply function for small_map_block_major */
+static void apply_small(int col,
+                        int row,
+                        UArray2b_T array2b,
+                        void *elem,
+                        void *vcl)
+{
+        struct small_closure *cl = vcl;
+        (void)col;
+        (void)row;
+        (void)array2b;
+        cl->apply(elem, cl->cl);
+}
+
+/********** small_map_block_major ********
+ *
+ * Applies a function to each element in block-major order, for mappings
+ * where the index of the element is not needed.
+ *
+ * Parameters:
+ *      A2 a2:                             The array to be mapped.
+ *      A2Methods_smallapplyfun apply:     Function to be applied to each
+ *                                         element.
+ *      void *cl:                          Closure pointer.
+ *
+ * Expects:
+ *      a2 and apply must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+static void small_map_block_major(A2 a2,
+                                  A2Methods_smallapplyfun apply,
+                                  void *cl)
+{
+        struct small_closure mycl = {apply, cl};
+        UArray2b_map(a2, apply_small, &mycl);
+}
+
+/********** A2Methods_T ********
+ *
+ * This structure represents a set of methods for manipulating blocked 2D
+ * unboxed arrays.
+ *
+ * Methods:
+ *      map_row_major:         Not implemented.
+ *      map_col_major:         Not implemented.
+ *      small_map_row_major:   Not implemented.
+ *      small_map_col_major:   Not implemented.
+ *      map_default:           Block-major.
+ *      small_map_default:     Block-major.
+ ************************/
+static struct A2Methods_T uarray2_methods_blocked_struct = {
+    new,
+    new_with_blocksize,
+    a2free,
+    width,
+    height,
+    size,
+    blocksize,
+    at,
+    NULL,            // map_row_major
+    NULL,            // map_col_major
+    map_block_major,
+    map_block_major, // map_default
+    NULL,            // small_map_row_major
+    NULL,            // small_map_col_major
+    small_map_block_major,
+    small_map_block_major, // small_map_default
+};
+
+// the exported pointer to the struct
+A2Methods_T uarray2_methods_blocked = &uarray2_methods_blocked_struct;
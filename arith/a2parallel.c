@@ -0,0 +1,322 @@
+/**************************************************************
+ *
+ *                     a2parallel.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for mapping over an A2Methods
+ *     array on several threads. Like Rmse_images, it cuts the array into
+ *     bands of a fixed number of rows, maps each band on its own (on a
+ *     thread pool when the array is big enough to pay for one) and then
+ *     reduces the bands in order. Each calling thread keeps its pool
+ *     between maps, so repeated maps do not start and join threads.
+ *
+ ************************/
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "a2row.h"
+#include "threadpool.h"
+#include "a2parallel.h"
+
+/* Rows per band, whatever the number of threads */
+#define BAND_ROWS 64
+
+/* Arrays with fewer cells than this are mapped on the calling thread */
+#define MIN_PARALLEL_CELLS (1 << 18)
+
+/* The calling thread's pool, remade when a map asks for a different
+ * number of threads; pool_key frees it when the thread exits */
+static pthread_key_t pool_key;
+static pthread_once_t pool_key_once = PTHREAD_ONCE_INIT;
+static __thread ThreadPool_T pool = NULL;
+
+/********** Band ********
+ *
+ * The rows one job maps.
+ *
+ * Elements:
+ *      const struct A2Methods_T *methods:      The array's methods.
+ *      A2Methods_UArray2 array2:               The array.
+ *      A2Methods_applyfun *apply:              The client's function.
+ *      int first_row, nrows:                   The rows to map.
+ *      int blocksize:                          The side of a tile, or 1
+ *                                              to map in row-major order.
+ *      void *cl:                               The band's closure.
+ ************************/
+typedef struct Band
+{
+        const struct A2Methods_T *methods;
+        A2Methods_UArray2 array2;
+        A2Methods_applyfun *apply;
+        int first_row, nrows;
+        int blocksize;
+        void *cl;
+} *Band;
+
+/********** map_band_rows ********
+ *
+ * Thread pool job: maps a Band in row-major order, stepping through each
+ * row with a pointer when the suite stores rows contiguously.
+ ************************/
+static void map_band_rows(void *arg)
+{
+        Band band = arg;
+        const struct A2Methods_T *methods = band->methods;
+        int width = methods->width(band->array2);
+        int size = methods->size(band->array2);
+
+        for (int row = band->first_row; row < band->first_row + band->nrows;
+             row++)
+        {
+                char *elem = A2Methods_row(methods, band->array2, row);
+                for (int col = 0; col < width; col++)
+                {
+                        if (elem != NULL)
+                        {
+                                band->apply(col, row, band->array2, elem,
+                                            band->cl);
+                                elem += size;
+                                continue;
+                        }
+                        band->apply(col, row, band->array2,
+                                    methods->at(band->array2, col, row),
+                                    band->cl);
+                }
+        }
+}
+
+/********** map_band_tiles ********
+ *
+ * Thread pool job: maps a Band of whole rows of tiles, tile by tile.
+ ************************/
+static void map_band_tiles(void *arg)
+{
+        Band band = arg;
+        const struct A2Methods_T *methods = band->methods;
+        int width = methods->width(band->array2);
+        int end = band->first_row + band->nrows;
+        int blocksize = band->blocksize;
+
+        for (int top = band->first_row; top < end; top += blocksize)
+        {
+                for (int left = 0; left < width; left += blocksize)
+                {
+                        for (int row = top; row < top + blocksize &&
+                                            row < end; row++)
+                        {
+                                for (int col = left; col < left + blocksize &&
+                                                     col < width; col++)
+                                {
+                                        band->apply(col, row, band->array2,
+                                                    methods->at(band->array2,
+                                                                col, row),
+                                                    band->cl);
+                                }
+                        }
+                }
+        }
+}
+
+/********** free_thread_pool ********
+ *
+ * Thread-exit destructor for the pool made by band_pool.
+ ************************/
+static void free_thread_pool(void *thread_pool)
+{
+        ThreadPool_T p = thread_pool;
+        ThreadPool_free(&p);
+}
+
+/********** make_pool_key ********
+ *
+ * Creates the key whose destructor frees each thread's pool.
+ ************************/
+static void make_pool_key(void)
+{
+        pthread_key_create(&pool_key, free_thread_pool);
+}
+
+/********** band_pool ********
+ *
+ * Gets the calling thread's pool, with the given number of threads.
+ *
+ * Parameters:
+ *      int threads:    The number of threads, more than 1.
+ *
+ * Return:
+ *      ThreadPool_T:   The pool.
+ ************************/
+static ThreadPool_T band_pool(int threads)
+{
+        if (pool != NULL && ThreadPool_size(pool) != threads)
+        {
+                pthread_setspecific(pool_key, NULL);
+                ThreadPool_free(&pool);
+        }
+        if (pool == NULL)
+        {
+                pthread_once(&pool_key_once, make_pool_key);
+                pool = ThreadPool_new(threads);
+                pthread_setspecific(pool_key, pool);
+        }
+        return pool;
+}
+
+/********** map_parallel ********
+ *
+ * Maps an array in bands of band_rows rows with a job, then reduces the
+ * bands' closures in order.
+ *
+ * Parameters:
+ *      const struct A2Methods_T *methods:      The array's methods.
+ *      A2Methods_UArray2 array2:               The array.
+ *      A2Methods_applyfun apply:               The client's function.
+ *      A2Methods_makecl *make:                 Makes a band's closure.
+ *      A2Methods_reducecl *reduce:             Folds one into cl.
+ *      void *cl:                               The caller's closure.
+ *      int threads:                            The most threads to use.
+ *      int blocksize:                          The side of a tile.
+ *      int band_rows:                          Rows per band, a multiple
+ *                                              of blocksize.
+ *      ThreadPool_job *job:                    Maps one Band.
+ ************************/
+static void map_parallel(const struct A2Methods_T *methods,
+                         A2Methods_UArray2 array2, A2Methods_applyfun apply,
+                         A2Methods_makecl *make, A2Methods_reducecl *reduce,
+                         void *cl, int threads, int blocksize, int band_rows,
+                         ThreadPool_job *job)
+{
+        assert(methods != NULL && array2 != NULL && apply != NULL);
+        assert(make != NULL && reduce != NULL);
+        assert(threads > 0);
+
+        int height = methods->height(array2);
+        size_t nbands = ((size_t)height + band_rows - 1) / band_rows;
+        if (nbands == 0)
+        {
+                return;
+        }
+
+        Band bands = CALLOC(nbands, sizeof *bands);
+        for (size_t i = 0; i < nbands; i++)
+        {
+                int first_row = i * band_rows;
+                bands[i].methods = methods;
+                bands[i].array2 = array2;
+                bands[i].apply = apply;
+                bands[i].first_row = first_row;
+                bands[i].nrows = height - first_row < band_rows
+                                         ? height - first_row
+                                         : band_rows;
+                bands[i].blocksize = blocksize;
+                bands[i].cl = make(cl);
+        }
+
+        /* The pool keeps the requested size even when there are fewer
+         * bands, so that maps of different heights share it */
+        if (threads == 1 || nbands == 1 ||
+            (size_t)methods->width(array2) * height < MIN_PARALLEL_CELLS)
+        {
+                for (size_t i = 0; i < nbands; i++)
+                {
+                        job(&bands[i]);
+                }
+        }
+        else
+        {
+                ThreadPool_T workers = band_pool(threads);
+                for (size_t i = 0; i < nbands; i++)
+                {
+                        ThreadPool_submit(workers, job, &bands[i]);
+                }
+                ThreadPool_wait(workers);
+        }
+
+        for (size_t i = 0; i < nbands; i++)
+        {
+                reduce(bands[i].cl, cl);
+        }
+        FREE(bands);
+}
+
+/********** A2Methods_map_row_major_parallel ********
+ *
+ * Applies a function to each element of an array, splitting the rows
+ * into bands that are mapped concurrently.
+ *
+ * Parameters:
+ *      const struct A2Methods_T *methods:
+ *                                      The array's methods.
+ *      A2Methods_UArray2 array2:       The array.
+ *      A2Methods_applyfun apply:       Function to be applied to each
+ *                                      element, with its band's closure.
+ *      A2Methods_makecl *make:         Makes a band's closure.
+ *      A2Methods_reducecl *reduce:     Folds a band's closure into cl.
+ *      void *cl:                       The caller's closure.
+ *      int threads:                    The most threads to map with;
+ *                                      small arrays use fewer.
+ *
+ * Expects:
+ *      methods, array2, apply, make and reduce must not be NULL, and
+ *      threads must be positive.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Within a band, elements are visited in row-major order.
+ *      make and reduce are called on the calling thread, make before any
+ *      band is mapped and reduce after every band is done.
+ *      Bands do not depend on the number of threads, so neither does the
+ *      result of a reduction that is deterministic for a given band
+ *      order.
+ ************************/
+void A2Methods_map_row_major_parallel(const struct A2Methods_T *methods,
+                                      A2Methods_UArray2 array2,
+                                      A2Methods_applyfun apply,
+                                      A2Methods_makecl *make,
+                                      A2Methods_reducecl *reduce, void *cl,
+                                      int threads)
+{
+        map_parallel(methods, array2, apply, make, reduce, cl, threads, 1,
+                     BAND_ROWS, map_band_rows);
+}
+
+/********** A2Methods_map_block_major_parallel ********
+ *
+ * Like A2Methods_map_row_major_parallel, but visits the elements of each
+ * band tile by tile, and row by row within a tile, where a tile is
+ * methods->blocksize(array2) cells on a side.
+ *
+ * Notes:
+ *      Bands are whole rows of tiles, so no tile is split between
+ *      threads.
+ *      Arrays with a blocksize of 1 are mapped as by
+ *      A2Methods_map_row_major_parallel.
+ ************************/
+void A2Methods_map_block_major_parallel(const struct A2Methods_T *methods,
+                                        A2Methods_UArray2 array2,
+                                        A2Methods_applyfun apply,
+                                        A2Methods_makecl *make,
+                                        A2Methods_reducecl *reduce,
+                                        void *cl, int threads)
+{
+        assert(methods != NULL && array2 != NULL);
+        int blocksize = methods->blocksize(array2);
+        if (blocksize <= 1)
+        {
+                A2Methods_map_row_major_parallel(methods, array2, apply, make,
+                                                 reduce, cl, threads);
+                return;
+        }
+
+        int band_rows = BAND_ROWS / blocksize > 1
+                                ? BAND_ROWS / blocksize * blocksize
+                                : blocksize;
+        map_parallel(methods, array2, apply, make, reduce, cl, threads,
+                     blocksize, band_rows, map_band_tiles);
+}
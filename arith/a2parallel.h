@@ -0,0 +1,96 @@
+/**************************************************************
+ *
+ *                     a2parallel.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for mapping over an A2Methods
+ *     array on several threads. The array is cut into bands of rows (or
+ *     of rows of tiles), and each band is mapped with a closure of its
+ *     own, made by the client's factory, so an apply function never
+ *     shares its closure with another thread and needs no locking. When
+ *     every band is done, the client's reduction folds the band closures
+ *     into the caller's closure, in band order.
+ *
+ *     The bands run on a thread pool that each calling thread makes on
+ *     its first parallel map and keeps until it exits, so repeated maps
+ *     do not start threads.
+ *
+ ************************/
+
+#ifndef A2PARALLEL_H
+#define A2PARALLEL_H
+
+#include "a2methods.h"
+
+/********** A2Methods_makecl ********
+ *
+ * Makes the closure a band is mapped with, given the caller's closure.
+ ************************/
+typedef void *A2Methods_makecl(void *cl);
+
+/********** A2Methods_reducecl ********
+ *
+ * Folds a band's closure into the caller's closure and frees it.
+ ************************/
+typedef void A2Methods_reducecl(void *band_cl, void *cl);
+
+/********** A2Methods_map_row_major_parallel ********
+ *
+ * Applies a function to each element of an array, splitting the rows
+ * into bands that are mapped concurrently.
+ *
+ * Parameters:
+ *      const struct A2Methods_T *methods:
+ *                                      The array's methods.
+ *      A2Methods_UArray2 array2:       The array.
+ *      A2Methods_applyfun apply:       Function to be applied to each
+ *                                      element, with its band's closure.
+ *      A2Methods_makecl *make:         Makes a band's closure.
+ *      A2Methods_reducecl *reduce:     Folds a band's closure into cl.
+ *      void *cl:                       The caller's closure.
+ *      int threads:                    The most threads to map with;
+ *                                      small arrays use fewer.
+ *
+ * Expects:
+ *      methods, array2, apply, make and reduce must not be NULL, and
+ *      threads must be positive.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Within a band, elements are visited in row-major order.
+ *      make and reduce are called on the calling thread, make before any
+ *      band is mapped and reduce after every band is done.
+ *      Bands do not depend on the number of threads, so neither does the
+ *      result of a reduction that is deterministic for a given band
+ *      order.
+ ************************/
+void A2Methods_map_row_major_parallel(const struct A2Methods_T *methods,
+                                      A2Methods_UArray2 array2,
+                                      A2Methods_applyfun apply,
+                                      A2Methods_makecl *make,
+                                      A2Methods_reducecl *reduce, void *cl,
+                                      int threads);
+
+/********** A2Methods_map_block_major_parallel ********
+ *
+ * Like A2Methods_map_row_major_parallel, but visits the elements of each
+ * band tile by tile, and row by row within a tile, where a tile is
+ * methods->blocksize(array2) cells on a side.
+ *
+ * Notes:
+ *      Bands are whole rows of tiles, so no tile is split between
+ *      threads.
+ *      Arrays with a blocksize of 1 are mapped as by
+ *      A2Methods_map_row_major_parallel.
+ ************************/
+void A2Methods_map_block_major_parallel(const struct A2Methods_T *methods,
+                                        A2Methods_UArray2 array2,
+                                        A2Methods_applyfun apply,
+                                        A2Methods_makecl *make,
+                                        A2Methods_reducecl *reduce,
+                                        void *cl, int threads);
+
+#endif
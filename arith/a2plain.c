@@ -14,6 +14,8 @@
 #include <string.h>
 
 #include <a2plain.h>
+#include "assert.h"
+#include "a2row.h"
 #include "uarray2.h"
 
 // define a private version of each function in A2Methods_T that we implement
@@ -67,7 +69,8 @@ static A2Methods_UArray2 new(int width, int height, int size)
  *      Will CRE if memory allocation fails.
  *      Will CRE if any expectation is violated.
  *      Client is expected to free the array using the UArray2_free method.
- *      Default blocksize size to 1.
+ *      A plain array is stored by rows, so blocksize is ignored and is
+ *      always 1; uarray2_methods_blocked stores tiles together.
  ************************/
 static A2Methods_UArray2 new_with_blocksize(int width, int height, int size,
                                             int blocksize)
@@ -418,3 +421,93 @@ static struct A2Methods_T uarray2_methods_plain_struct = {
 
 // finally the payoff: here is the exported pointer to the struct
 A2Methods_T uarray2_methods_plain = &uarray2_methods_plain_struct;
+
+/********** A2Methods_row ********
+ *
+ * Gets a row of an array, if the array's methods store rows contiguously.
+ *
+ * Parameters:
+ *      const struct A2Methods_T *methods:
+ *                                      The array's methods.
+ *      A2Methods_UArray2 array2:       The array.
+ *      int row:                        The row.
+ *
+ * Return:
+ *      A2Methods_Object *:             A pointer to the row's first
+ *                                      element, with the element in column
+ *                                      col at col * methods->size(array2)
+ *                                      bytes past it; or NULL if the suite
+ *                                      does not store rows contiguously or
+ *                                      the array has no columns.
+ *
+ * Expects:
+ *      methods and array2 must not be NULL, and 0 <= row < height.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Only uarray2_methods_plain stores rows contiguously; a client must
+ *      fall back to the at method when it gets NULL.
+ ************************/
+A2Methods_Object *A2Methods_row(const struct A2Methods_T *methods,
+                                A2Methods_UArray2 array2, int row)
+{
+        assert(methods != NULL && array2 != NULL);
+        if (methods != uarray2_methods_plain)
+        {
+                return NULL;
+        }
+        return UArray2_row(array2, row);
+}
+
+/********** A2Methods_map_2x2 ********
+ *
+ * Applies a function to each 2x2 block of an array, in row-major order of
+ * blocks.
+ *
+ * Parameters:
+ *      const struct A2Methods_T *methods:
+ *                                      The array's methods.
+ *      A2Methods_UArray2 array2:       The array.
+ *      A2Methods_apply2x2fun apply:    Function to be applied to each
+ *                                      block, given the block's column and
+ *                                      row (in blocks) and its four
+ *                                      elements: top-left, top-right,
+ *                                      bottom-left, bottom-right.
+ *      void *cl:                       Closure pointer.
+ *
+ * Expects:
+ *      methods, array2 and apply must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      An odd last column or row is not visited.
+ *      Plain arrays are mapped by UArray2_map_2x2, with no call to at.
+ ************************/
+void A2Methods_map_2x2(const struct A2Methods_T *methods,
+                       A2Methods_UArray2 array2, A2Methods_apply2x2fun apply,
+                       void *cl)
+{
+        assert(methods != NULL && array2 != NULL && apply != NULL);
+        if (methods == uarray2_methods_plain)
+        {
+                UArray2_map_2x2(array2, (UArray2_apply2x2fun *)apply, cl);
+                return;
+        }
+
+        int cols = methods->width(array2) / 2;
+        int rows = methods->height(array2) / 2;
+        for (int row = 0; row < rows; row++)
+        {
+                for (int col = 0; col < cols; col++)
+                {
+                        A2Methods_Object *elems[4];
+                        for (int k = 0; k < 4; k++)
+                        {
+                                elems[k] = methods->at(array2,
+                                                       2 * col + k % 2,
+                                                       2 * row + k / 2);
+                        }
+                        apply(col, row, array2, elems, cl);
+                }
+        }
+}
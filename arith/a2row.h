@@ -0,0 +1,82 @@
+/**************************************************************
+ *
+ *                     a2row.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains extensions to A2Methods_T for suites that store
+ *     each row of an array contiguously. A hot loop asks for a row once
+ *     and walks it with pointer arithmetic, instead of calling the suite's
+ *     at method, and its checks, for every element; 2x2 blocks are mapped
+ *     the same way. Other suites get the same results through at.
+ *
+ ************************/
+
+#ifndef A2ROW_H
+#define A2ROW_H
+
+#include "a2methods.h"
+
+/********** A2Methods_row ********
+ *
+ * Gets a row of an array, if the array's methods store rows contiguously.
+ *
+ * Parameters:
+ *      const struct A2Methods_T *methods:
+ *                                      The array's methods.
+ *      A2Methods_UArray2 array2:       The array.
+ *      int row:                        The row.
+ *
+ * Return:
+ *      A2Methods_Object *:             A pointer to the row's first
+ *                                      element, with the element in column
+ *                                      col at col * methods->size(array2)
+ *                                      bytes past it; or NULL if the suite
+ *                                      does not store rows contiguously or
+ *                                      the array has no columns.
+ *
+ * Expects:
+ *      methods and array2 must not be NULL, and 0 <= row < height.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Only uarray2_methods_plain stores rows contiguously; a client must
+ *      fall back to the at method when it gets NULL.
+ ************************/
+A2Methods_Object *A2Methods_row(const struct A2Methods_T *methods,
+                                A2Methods_UArray2 array2, int row);
+
+typedef void A2Methods_apply2x2fun(int col, int row, A2Methods_UArray2 array2,
+                                   A2Methods_Object *elems[4], void *cl);
+
+/********** A2Methods_map_2x2 ********
+ *
+ * Applies a function to each 2x2 block of an array, in row-major order of
+ * blocks.
+ *
+ * Parameters:
+ *      const struct A2Methods_T *methods:
+ *                                      The array's methods.
+ *      A2Methods_UArray2 array2:       The array.
+ *      A2Methods_apply2x2fun apply:    Function to be applied to each
+ *                                      block, given the block's column and
+ *                                      row (in blocks) and its four
+ *                                      elements: top-left, top-right,
+ *                                      bottom-left, bottom-right.
+ *      void *cl:                       Closure pointer.
+ *
+ * Expects:
+ *      methods, array2 and apply must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      An odd last column or row is not visited.
+ *      Plain arrays are mapped by UArray2_map_2x2, with no call to at.
+ ************************/
+void A2Methods_map_2x2(const struct A2Methods_T *methods,
+                       A2Methods_UArray2 array2, A2Methods_apply2x2fun apply,
+                       void *cl);
+
+#endif
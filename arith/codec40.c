@@ -0,0 +1,447 @@
+/**************************************************************
+ *
+ *                     codec40.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for libcompress40, the
+ *     in-memory version of the 40image codec. It runs the same block
+ *     pipeline as compress40.c (rgb2cav, dct, quantize, packword), so the
+ *     bytes it produces match compress40 exactly.
+ *
+ ************************/
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "codec40.h"
+#include "jobarena.h"
+#include "rgb2cav.h"
+#include "dct.h"
+#include "quantize.h"
+#include "packword.h"
+
+#define DENOMINATOR 255
+#define SCRATCH_CHUNK 512
+
+static const char MAGIC[] = "COMP40 Compressed image format 2\n";
+
+/********** Codec40_T ********
+ *
+ * The scratch space for coding one 2x2 block at a time.
+ *
+ * Elements:
+ *      JobArena_T arena:      Owns all of the scratch below.
+ *      RGB_block rgb_block:   The block's pixels.
+ *      CAV_block cav_block:   The block in component video.
+ *      DCT dct:               The block's DCT coefficients.
+ *      Quantized quantized:   The block's quantized coefficients.
+ ************************/
+struct Codec40_T
+{
+        JobArena_T arena;
+        RGB_block rgb_block;
+        CAV_block cav_block;
+        DCT dct;
+        Quantized quantized;
+};
+
+/********** Codec40_new ********
+ *
+ * Allocates a new codec context.
+ *
+ * Return:
+ *      Codec40_T:      A new context.
+ *
+ * Notes:
+ *      Will CRE if memory allocation fails.
+ *      Client is responsible for freeing the context with Codec40_free.
+ ************************/
+Codec40_T Codec40_new(void)
+{
+        Codec40_T codec;
+        NEW(codec);
+        codec->arena = JobArena_new(SCRATCH_CHUNK);
+        codec->rgb_block = RGB_block_arena_new(codec->arena);
+        codec->cav_block = CAV_block_arena_new(codec->arena);
+        codec->dct = DCT_arena_new(codec->arena);
+        codec->quantized = Quantized_arena_new(codec->arena);
+        return codec;
+}
+
+/********** Codec40_free ********
+ *
+ * Frees a codec context.
+ *
+ * Parameters:
+ *      Codec40_T *codec:  A pointer to the context to be freed.
+ *
+ * Expects:
+ *      codec and *codec must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      The pointer *codec will be set to NULL after freeing.
+ ************************/
+void Codec40_free(Codec40_T *codec)
+{
+        assert(codec != NULL);
+        assert(*codec != NULL);
+
+        JobArena_free(&(*codec)->arena);
+        FREE(*codec);
+}
+
+/********** header_length ********
+ *
+ * Gets the length of the header compress40 writes for an image.
+ *
+ * Parameters:
+ *      unsigned width:   The width of the image in pixels.
+ *      unsigned height:  The height of the image in pixels.
+ *
+ * Return:
+ *      size_t:           The length of the header in bytes.
+ ************************/
+static size_t header_length(unsigned width, unsigned height)
+{
+        return snprintf(NULL, 0, "%s%u %u\n", MAGIC, width & ~1, height & ~1);
+}
+
+/********** Codec40_encoded_size ********
+ *
+ * Gets the exact size of the compressed form of an image.
+ *
+ * Parameters:
+ *      unsigned width:   The width of the image in pixels.
+ *      unsigned height:  The height of the image in pixels.
+ *
+ * Return:
+ *      size_t:           The number of bytes Codec40_encode will write.
+ ************************/
+size_t Codec40_encoded_size(unsigned width, unsigned height)
+{
+        return header_length(width, height) +
+               4 * (size_t)(width / 2) * (height / 2);
+}
+
+/********** Codec40_encode ********
+ *
+ * Compresses an RGB image into a caller-supplied buffer. As with
+ * compress40, an odd last row or column is dropped.
+ *
+ * Parameters:
+ *      Codec40_T codec:            The context to use.
+ *      const unsigned char *rgb:   The first pixel of the image, as
+ *                                  red, green, blue bytes.
+ *      unsigned width:             The width of the image in pixels.
+ *      unsigned height:            The height of the image in pixels.
+ *      size_t stride:              The distance in bytes between the
+ *                                  starts of consecutive rows.
+ *      unsigned char *out:         The buffer to write to.
+ *      size_t capacity:            The size of out in bytes.
+ *
+ * Return:
+ *      size_t:                     The number of bytes written, or 0 if
+ *                                  capacity is too small.
+ *
+ * Expects:
+ *      codec, rgb and out must not be NULL.
+ *      stride must be at least 3 * width.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+size_t Codec40_encode(Codec40_T codec,
+                      const unsigned char *rgb,
+                      unsigned width,
+                      unsigned height,
+                      size_t stride,
+                      unsigned char *out,
+                      size_t capacity)
+{
+        assert(codec != NULL);
+        assert(rgb != NULL && out != NULL);
+        assert(stride >= 3 * (size_t)width);
+
+        size_t total = Codec40_encoded_size(width, height);
+        if (capacity < total)
+        {
+                return 0;
+        }
+
+        /* Format into a local buffer, since snprintf also writes a '\0' */
+        char header[64];
+        size_t hlen = snprintf(header, sizeof(header), "%s%u %u\n", MAGIC,
+                               width & ~1, height & ~1);
+        memcpy(out, header, hlen);
+        unsigned char *word = out + hlen;
+
+        /* Same block order as compress40: down each column of blocks */
+        for (size_t col = 0; col < width / 2; col++)
+        {
+                for (size_t row = 0; row < height / 2; row++)
+                {
+                        const unsigned char *top = rgb + row * 2 * stride +
+                                                   col * 6;
+                        const unsigned char *pixels[4] = {
+                                top, top + 3, top + stride, top + stride + 3};
+                        for (size_t k = 0; k < 4; k++)
+                        {
+                                const unsigned char *px = pixels[k];
+                                Pnm_rgb dst = codec->rgb_block->rgb[k];
+                                dst->red = px[0];
+                                dst->green = px[1];
+                                dst->blue = px[2];
+                        }
+
+                        RGBtoCAV_block(codec->cav_block, codec->rgb_block,
+                                       DENOMINATOR);
+                        computeDCT(codec->dct, codec->cav_block);
+                        quantize(codec->quantized, codec->dct);
+                        uint32_t packed = packWord(codec->quantized);
+
+                        word[0] = packed >> 24;
+                        word[1] = packed >> 16;
+                        word[2] = packed >> 8;
+                        word[3] = packed;
+                        word += 4;
+                }
+        }
+
+        return total;
+}
+
+/********** parse_unsigned ********
+ *
+ * Parses a decimal number from a bounded buffer.
+ *
+ * Parameters:
+ *      const unsigned char **p:   The cursor. Advanced past the digits.
+ *      const unsigned char *end:  One past the last readable byte.
+ *      unsigned *value:           Filled in with the number.
+ *
+ * Return:
+ *      int:                       1 if any digits were read, else 0.
+ ************************/
+static int parse_unsigned(const unsigned char **p,
+                          const unsigned char *end,
+                          unsigned *value)
+{
+        const unsigned char *start = *p;
+        uint64_t n = 0;
+        while (*p < end && isdigit(**p) && n <= UINT32_MAX)
+        {
+                n = n * 10 + (**p - '0');
+                (*p)++;
+        }
+        *value = n;
+        return *p > start && n <= UINT32_MAX;
+}
+
+/********** Codec40_decode_header ********
+ *
+ * Reads the dimensions of a compressed image.
+ *
+ * Parameters:
+ *      const unsigned char *in:  The compressed image.
+ *      size_t len:               The number of bytes in in.
+ *      unsigned *width:          Filled in with the width in pixels.
+ *      unsigned *height:         Filled in with the height in pixels.
+ *
+ * Return:
+ *      size_t:                   The length of the header in bytes, or 0
+ *                                if in does not start with a valid header.
+ *
+ * Expects:
+ *      in, width and height must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+size_t Codec40_decode_header(const unsigned char *in,
+                             size_t len,
+                             unsigned *width,
+                             unsigned *height)
+{
+        assert(in != NULL);
+        assert(width != NULL && height != NULL);
+
+        size_t mlen = sizeof(MAGIC) - 1;
+        if (len < mlen || memcmp(in, MAGIC, mlen) != 0)
+        {
+                return 0;
+        }
+
+        const unsigned char *p = in + mlen;
+        const unsigned char *end = in + len;
+        while (p < end && isspace(*p))
+        {
+                p++;
+        }
+        if (!parse_unsigned(&p, end, width))
+        {
+                return 0;
+        }
+        while (p < end && isspace(*p) && *p != '\n')
+        {
+                p++;
+        }
+        if (!parse_unsigned(&p, end, height) || p == end || *p != '\n')
+        {
+                return 0;
+        }
+        return p + 1 - in;
+}
+
+/********** Codec40_check ********
+ *
+ * Checks that a compressed image is whole and that every codeword in it
+ * is one Codec40_decode and decompress40 accept, without decoding it.
+ *
+ * Parameters:
+ *      const unsigned char *in:  The compressed image.
+ *      size_t len:               The number of bytes in in.
+ *      unsigned *width:          Filled in with the width in pixels.
+ *      unsigned *height:         Filled in with the height in pixels.
+ *
+ * Return:
+ *      size_t:                   The number of bytes of in the image
+ *                                takes, or 0 if in is truncated or
+ *                                malformed.
+ *
+ * Expects:
+ *      in, width and height must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+size_t Codec40_check(const unsigned char *in,
+                     size_t len,
+                     unsigned *width,
+                     unsigned *height)
+{
+        size_t hlen = Codec40_decode_header(in, len, width, height);
+        if (hlen == 0)
+        {
+                return 0;
+        }
+        size_t words = (size_t)(*width / 2) * (*height / 2);
+        if ((len - hlen) / 4 < words)
+        {
+                return 0;
+        }
+
+        struct Quantized q;
+        const unsigned char *word = in + hlen;
+        for (size_t i = 0; i < words; i++, word += 4)
+        {
+                uint32_t packed = (uint32_t)word[0] << 24 |
+                                  (uint32_t)word[1] << 16 |
+                                  (uint32_t)word[2] << 8 |
+                                  word[3];
+
+                /* -16 fits in 5 bits but is not a legal b, c, d */
+                unpackWord(&q, packed);
+                if (q.b < -15 || q.c < -15 || q.d < -15)
+                {
+                        return 0;
+                }
+        }
+        return hlen + 4 * words;
+}
+
+/********** Codec40_decode ********
+ *
+ * Decompresses an image into a caller-supplied pixel buffer, which must
+ * be large enough for the dimensions given by Codec40_decode_header.
+ *
+ * Parameters:
+ *      Codec40_T codec:          The context to use.
+ *      const unsigned char *in:  The compressed image.
+ *      size_t len:               The number of bytes in in.
+ *      unsigned char *rgb:       The first pixel of the output, written
+ *                                as red, green, blue bytes.
+ *      size_t stride:            The distance in bytes between the
+ *                                starts of consecutive output rows.
+ *
+ * Return:
+ *      size_t:                   The number of bytes of in consumed, or 0
+ *                                if in is truncated or malformed.
+ *
+ * Expects:
+ *      codec, in and rgb must not be NULL.
+ *      stride must be at least 3 * width.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      On failure the contents of rgb are unspecified.
+ ************************/
+size_t Codec40_decode(Codec40_T codec,
+                      const unsigned char *in,
+                      size_t len,
+                      unsigned char *rgb,
+                      size_t stride)
+{
+        assert(codec != NULL);
+        assert(in != NULL && rgb != NULL);
+
+        unsigned width, height;
+        size_t hlen = Codec40_decode_header(in, len, &width, &height);
+        if (hlen == 0)
+        {
+                return 0;
+        }
+        assert(stride >= 3 * (size_t)width);
+
+        size_t total = hlen + 4 * (size_t)(width / 2) * (height / 2);
+        if (len < total)
+        {
+                return 0;
+        }
+
+        Quantized q = codec->quantized;
+        const unsigned char *word = in + hlen;
+        for (size_t col = 0; col < width / 2; col++)
+        {
+                for (size_t row = 0; row < height / 2; row++)
+                {
+                        uint32_t packed = (uint32_t)word[0] << 24 |
+                                          (uint32_t)word[1] << 16 |
+                                          (uint32_t)word[2] << 8 |
+                                          word[3];
+                        word += 4;
+
+                        /* -16 fits in 5 bits but is not a legal b, c, d */
+                        unpackWord(q, packed);
+                        if (q->b < -15 || q->c < -15 || q->d < -15)
+                        {
+                                return 0;
+                        }
+                        dequantize(codec->dct, q);
+                        invertDCT(codec->cav_block, codec->dct);
+                        CAVtoRGB_block(codec->rgb_block, codec->cav_block,
+                                       DENOMINATOR);
+
+                        unsigned char *top = rgb + row * 2 * stride + col * 6;
+                        unsigned char *pixels[4] = {
+                                top, top + 3, top + stride, top + stride + 3};
+                        for (size_t k = 0; k < 4; k++)
+                        {
+                                unsigned char *px = pixels[k];
+                                Pnm_rgb src = codec->rgb_block->rgb[k];
+                                px[0] = src->red;
+                                px[1] = src->green;
+                                px[2] = src->blue;
+                        }
+                }
+        }
+
+        return total;
+}
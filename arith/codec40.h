@@ -0,0 +1,195 @@
+/**************************************************************
+ *
+ *                     codec40.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for libcompress40, an in-memory
+ *     version of the 40image codec. Images go buffer to buffer: pixels
+ *     are 8-bit interleaved RGB (denominator 255) in a caller-supplied
+ *     buffer with a caller-chosen stride, and the compressed bytes are
+ *     exactly what compress40 would write for the same image.
+ *
+ *     Nothing here touches stdout or global state; libcompress40.a is
+ *     built without the quantization telemetry of quantstats.h. Each
+ *     Codec40_T owns its own scratch space, so any number of threads may
+ *     code images at once as long as each uses its own Codec40_T.
+ *
+ ************************/
+
+#ifndef CODEC40_H
+#define CODEC40_H
+
+#include <stddef.h>
+
+/********** Codec40_T ********
+ *
+ * An opaque codec context holding the scratch space for one image at a
+ * time.
+ ************************/
+typedef struct Codec40_T *Codec40_T;
+
+/********** Codec40_new ********
+ *
+ * Allocates a new codec context.
+ *
+ * Return:
+ *      Codec40_T:      A new context.
+ *
+ * Notes:
+ *      Will CRE if memory allocation fails.
+ *      Client is responsible for freeing the context with Codec40_free.
+ ************************/
+Codec40_T Codec40_new(void);
+
+/********** Codec40_free ********
+ *
+ * Frees a codec context.
+ *
+ * Parameters:
+ *      Codec40_T *codec:  A pointer to the context to be freed.
+ *
+ * Expects:
+ *      codec and *codec must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      The pointer *codec will be set to NULL after freeing.
+ ************************/
+void Codec40_free(Codec40_T *codec);
+
+/********** Codec40_encoded_size ********
+ *
+ * Gets the exact size of the compressed form of an image.
+ *
+ * Parameters:
+ *      unsigned width:   The width of the image in pixels.
+ *      unsigned height:  The height of the image in pixels.
+ *
+ * Return:
+ *      size_t:           The number of bytes Codec40_encode will write.
+ ************************/
+size_t Codec40_encoded_size(unsigned width, unsigned height);
+
+/********** Codec40_encode ********
+ *
+ * Compresses an RGB image into a caller-supplied buffer. As with
+ * compress40, an odd last row or column is dropped.
+ *
+ * Parameters:
+ *      Codec40_T codec:            The context to use.
+ *      const unsigned char *rgb:   The first pixel of the image, as
+ *                                  red, green, blue bytes.
+ *      unsigned width:             The width of the image in pixels.
+ *      unsigned height:            The height of the image in pixels.
+ *      size_t stride:              The distance in bytes between the
+ *                                  starts of consecutive rows.
+ *      unsigned char *out:         The buffer to write to.
+ *      size_t capacity:            The size of out in bytes.
+ *
+ * Return:
+ *      size_t:                     The number of bytes written, or 0 if
+ *                                  capacity is too small.
+ *
+ * Expects:
+ *      codec, rgb and out must not be NULL.
+ *      stride must be at least 3 * width.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+size_t Codec40_encode(Codec40_T codec,
+                      const unsigned char *rgb,
+                      unsigned width,
+                      unsigned height,
+                      size_t stride,
+                      unsigned char *out,
+                      size_t capacity);
+
+/********** Codec40_decode_header ********
+ *
+ * Reads the dimensions of a compressed image.
+ *
+ * Parameters:
+ *      const unsigned char *in:  The compressed image.
+ *      size_t len:               The number of bytes in in.
+ *      unsigned *width:          Filled in with the width in pixels.
+ *      unsigned *height:         Filled in with the height in pixels.
+ *
+ * Return:
+ *      size_t:                   The length of the header in bytes, or 0
+ *                                if in does not start with a valid header.
+ *
+ * Expects:
+ *      in, width and height must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+size_t Codec40_decode_header(const unsigned char *in,
+                             size_t len,
+                             unsigned *width,
+                             unsigned *height);
+
+/********** Codec40_check ********
+ *
+ * Checks that a compressed image is whole and that every codeword in it
+ * is one Codec40_decode and decompress40 accept, without decoding it.
+ *
+ * Parameters:
+ *      const unsigned char *in:  The compressed image.
+ *      size_t len:               The number of bytes in in.
+ *      unsigned *width:          Filled in with the width in pixels.
+ *      unsigned *height:         Filled in with the height in pixels.
+ *
+ * Return:
+ *      size_t:                   The number of bytes of in the image
+ *                                takes, or 0 if in is truncated or
+ *                                malformed.
+ *
+ * Expects:
+ *      in, width and height must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+size_t Codec40_check(const unsigned char *in,
+                     size_t len,
+                     unsigned *width,
+                     unsigned *height);
+
+/********** Codec40_decode ********
+ *
+ * Decompresses an image into a caller-supplied pixel buffer, which must
+ * be large enough for the dimensions given by Codec40_decode_header.
+ *
+ * Parameters:
+ *      Codec40_T codec:          The context to use.
+ *      const unsigned char *in:  The compressed image.
+ *      size_t len:               The number of bytes in in.
+ *      unsigned char *rgb:       The first pixel of the output, written
+ *                                as red, green, blue bytes.
+ *      size_t stride:            The distance in bytes between the
+ *                                starts of consecutive output rows.
+ *
+ * Return:
+ *      size_t:                   The number of bytes of in consumed, or 0
+ *                                if in is truncated or malformed.
+ *
+ * Expects:
+ *      codec, in and rgb must not be NULL.
+ *      stride must be at least 3 * width.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      On failure the contents of rgb are unspecified.
+ ************************/
+size_t Codec40_decode(Codec40_T codec,
+                      const unsigned char *in,
+                      size_t len,
+                      unsigned char *rgb,
+                      size_t stride);
+
+#endif
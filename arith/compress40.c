@@ -1,3 +1,6 @@
+#include <limits.h>
+#include <pthread.h>
+
 #include "compress40.h"
 #include "assert.h"
 #include "pnm.h"
@@ -9,11 +12,327 @@
 #include "mem.h"
 #include "quantize.h"
 #include "packword.h"
-#include "bitpack.h"
+#include "compress40_io.h"
+#include "jobarena.h"
+#include "frame.h"
+#include "stats.h"
+#include "trace.h"
+#include "kernels.h"
+#include "threadpool.h"
+#include "tuning.h"
+
+/* The most scratch a thread's arena keeps between images, about two
+ * megapixels' worth; a larger image frees its scratch when it is done */
+#define ARENA_KEEP (32 * 1024 * 1024)
+
+/********** Band ********
+ *
+ * A band of rows for one thread to convert between the image and the
+ * frame.
+ *
+ * Elements:
+ *      Frame frame:            The frame.
+ *      Pnm_ppm image:          The image.
+ *      size_t first_row:       The first row of the band.
+ *      size_t nrows:           The number of rows in the band.
+ ************************/
+typedef struct Band
+{
+        Frame frame;
+        Pnm_ppm image;
+        size_t first_row;
+        size_t nrows;
+} *Band;
+
+/********** Strip ********
+ *
+ * A strip of columns of 2x2 blocks for one thread to code, with its own
+ * buffers so that strips can be coded concurrently.
+ *
+ * Elements:
+ *      Frame frame:            The frame being coded.
+ *      Kernels kernels:        The kernels to code with.
+ *      size_t first_col:       The first column of blocks in the strip.
+ *      size_t ncols:           The number of columns of blocks.
+ *      size_t rows:            The number of rows of blocks.
+ *      uint32_t *packed:       The strip's codewords, a column at a time.
+ *      unsigned char *bytes:   The codewords as big-endian bytes, in the
+ *                              order they are stored.
+ ************************/
+typedef struct Strip
+{
+        Frame frame;
+        Kernels kernels;
+        size_t first_col;
+        size_t ncols;
+        size_t rows;
+        uint32_t *packed;
+        unsigned char *bytes;
+} *Strip;
+
+/* The calling thread's pool, remade when Tuning_current.threads changes.
+ * Each thread keeps its own, so concurrent callers such as 40imaged's
+ * workers never share one; pool_key frees it when the thread exits. */
+static pthread_key_t pool_key;
+static pthread_once_t pool_key_once = PTHREAD_ONCE_INIT;
+static __thread ThreadPool_T pool = NULL;
+
+/********** free_thread_pool ********
+ *
+ * Thread-exit destructor for the pool made by codec_pool.
+ ************************/
+static void free_thread_pool(void *thread_pool)
+{
+        ThreadPool_T p = thread_pool;
+        ThreadPool_free(&p);
+}
+
+/********** make_pool_key ********
+ *
+ * Creates the key whose destructor frees each thread's pool.
+ ************************/
+static void make_pool_key(void)
+{
+        pthread_key_create(&pool_key, free_thread_pool);
+}
+
+/********** codec_pool ********
+ *
+ * Gets the calling thread's pool for Tuning_current.threads threads.
+ *
+ * Return:
+ *      ThreadPool_T:   The pool, or NULL if coding uses one thread.
+ ************************/
+static ThreadPool_T codec_pool(void)
+{
+        int threads = Tuning_current.threads;
+        if (pool != NULL && ThreadPool_size(pool) != threads)
+        {
+                pthread_setspecific(pool_key, NULL);
+                ThreadPool_free(&pool);
+        }
+        if (pool == NULL && threads > 1)
+        {
+                pthread_once(&pool_key_once, make_pool_key);
+                pool = ThreadPool_new(threads);
+                pthread_setspecific(pool_key, pool);
+        }
+        return pool;
+}
+
+/********** run_jobs ********
+ *
+ * Runs a job once for each of an array of arguments and waits for all of
+ * them to finish.
+ *
+ * Parameters:
+ *      ThreadPool_job *job:    The job to run.
+ *      void *args:             The arguments, one after another.
+ *      size_t size:            The size of one argument.
+ *      size_t n:               The number of arguments.
+ *
+ * Notes:
+ *      Jobs run on the calling thread if there is no pool or only one
+ *      job.
+ ************************/
+static void run_jobs(ThreadPool_job *job, void *args, size_t size, size_t n)
+{
+        ThreadPool_T threads = n > 1 ? codec_pool() : NULL;
+        for (size_t i = 0; i < n; i++)
+        {
+                void *arg = (char *)args + i * size;
+                if (threads == NULL)
+                {
+                        job(arg);
+                }
+                else
+                {
+                        ThreadPool_submit(threads, job, arg);
+                }
+        }
+        if (threads != NULL)
+        {
+                ThreadPool_wait(threads);
+        }
+}
+
+/********** from_ppm_band ********
+ *
+ * Converts a Band of the image into the frame.
+ ************************/
+static void from_ppm_band(void *arg)
+{
+        Band band = arg;
+        Frame_from_ppm_rows(band->frame, band->image, band->first_row,
+                            band->nrows);
+}
+
+/********** to_ppm_band ********
+ *
+ * Converts a Band of the frame back into the image.
+ ************************/
+static void to_ppm_band(void *arg)
+{
+        Band band = arg;
+        Frame_to_ppm_rows(band->image, band->frame, band->first_row,
+                          band->nrows);
+}
+
+/********** convert_bands ********
+ *
+ * Converts every row of a frame, split into one band per thread.
+ *
+ * Parameters:
+ *      JobArena_T arena:       Where to allocate the bands.
+ *      ThreadPool_job *job:    from_ppm_band or to_ppm_band.
+ *      Frame frame:            The frame.
+ *      Pnm_ppm image:          The image.
+ ************************/
+static void convert_bands(JobArena_T arena, ThreadPool_job *job, Frame frame,
+                          Pnm_ppm image)
+{
+        size_t n = Tuning_current.threads > 1 ? Tuning_current.threads : 1;
+        size_t per = (frame->height + n - 1) / n;
+        Band bands = JobArena_alloc(arena, n * sizeof *bands);
+
+        size_t count = 0;
+        for (size_t first = 0; first < frame->height; first += per)
+        {
+                bands[count].frame = frame;
+                bands[count].image = image;
+                bands[count].first_row = first;
+                bands[count].nrows = frame->height - first < per
+                                             ? frame->height - first
+                                             : per;
+                count++;
+        }
+        run_jobs(job, bands, sizeof *bands, count);
+}
+
+/********** new_strips ********
+ *
+ * Allocates one Strip per thread, each with buffers for
+ * Tuning_current.strip_cols columns.
+ *
+ * Parameters:
+ *      JobArena_T arena:       Where to allocate the strips.
+ *      Frame frame:            The frame to code.
+ *      size_t *count:          Filled in with the number of strips.
+ *
+ * Return:
+ *      Strip:                  The strips, not yet given columns.
+ ************************/
+static Strip new_strips(JobArena_T arena, Frame frame, size_t *count)
+{
+        size_t n = Tuning_current.threads > 1 ? Tuning_current.threads : 1;
+        size_t cols = Tuning_current.strip_cols > 0 ? Tuning_current.strip_cols
+                                                    : 1;
+        size_t rows = frame->height / 2;
+        Strip strips = JobArena_alloc(arena, n * sizeof *strips);
+        Kernels kernels = Kernels_active();
+
+        for (size_t i = 0; i < n; i++)
+        {
+                strips[i].frame = frame;
+                strips[i].kernels = kernels;
+                strips[i].first_col = 0;
+                strips[i].ncols = cols;
+                strips[i].rows = rows;
+                strips[i].packed = JobArena_alloc(arena, 4 * cols * rows + 4);
+                strips[i].bytes = JobArena_alloc(arena, 4 * cols * rows + 1);
+        }
+        *count = n;
+        return strips;
+}
+
+/********** next_wave ********
+ *
+ * Gives each strip its columns for the next wave: consecutive runs of up
+ * to strip_cols columns starting at col.
+ *
+ * Parameters:
+ *      Strip strips:   The strips.
+ *      size_t count:   The number of strips.
+ *      size_t col:     The first column of the wave.
+ *      size_t cols:    The number of columns in the frame.
+ *
+ * Return:
+ *      size_t:         The number of strips given columns.
+ ************************/
+static size_t next_wave(Strip strips, size_t count, size_t col, size_t cols)
+{
+        size_t per = Tuning_current.strip_cols > 0 ? Tuning_current.strip_cols
+                                                   : 1;
+        size_t n = 0;
+        for (; n < count && col < cols; n++, col += per)
+        {
+                strips[n].first_col = col;
+                strips[n].ncols = cols - col < per ? cols - col : per;
+        }
+        return n;
+}
+
+/********** encode_strip ********
+ *
+ * Codes each column of a Strip, then stores its words as big-endian
+ * bytes.
+ ************************/
+static void encode_strip(void *arg)
+{
+        Strip strip = arg;
+        for (size_t i = 0; i < strip->ncols; i++)
+        {
+                size_t col = strip->first_col + i;
+                uint32_t *packed = strip->packed + i * strip->rows;
+                unsigned char *bytes = strip->bytes + 4 * i * strip->rows;
+
+                Trace_begin("code", col);
+                strip->kernels->encode_blocks(packed, strip->frame, col,
+                                              strip->rows);
+                for (size_t row = 0; row < strip->rows; row++)
+                {
+                        unsigned char *word = bytes + 4 * row;
+                        word[0] = packed[row] >> 24;
+                        word[1] = packed[row] >> 16;
+                        word[2] = packed[row] >> 8;
+                        word[3] = packed[row];
+                }
+                Trace_end("code", col);
+        }
+}
+
+/********** decode_strip ********
+ *
+ * Assembles a Strip's big-endian bytes into words, then decodes each
+ * column into the frame.
+ ************************/
+static void decode_strip(void *arg)
+{
+        Strip strip = arg;
+        for (size_t i = 0; i < strip->ncols; i++)
+        {
+                size_t col = strip->first_col + i;
+                uint32_t *packed = strip->packed + i * strip->rows;
+                const unsigned char *bytes = strip->bytes + 4 * i * strip->rows;
+
+                Trace_begin("code", col);
+                for (size_t row = 0; row < strip->rows; row++)
+                {
+                        const unsigned char *word = bytes + 4 * row;
+                        packed[row] = (uint32_t)word[0] << 24 |
+                                      (uint32_t)word[1] << 16 |
+                                      (uint32_t)word[2] << 8 |
+                                      word[3];
+                }
+                strip->kernels->decode_blocks(strip->frame, packed, col,
+                                              strip->rows);
+                Trace_end("code", col);
+        }
+}
 
 /********** compress40 ********
  *
- * Compresses a PPM image to a 40image format.
+ * Compresses a PPM image to a 40image format on stdout.
  *
  * Parameters:
  *      FILE *input:    A pointer to the input file.
@@ -25,58 +344,98 @@
  *      Will CRE if any expectation is violated.
  ************************/
 void compress40(FILE *input)
+{
+        compress40_to(input, stdout);
+}
+
+/********** compress40_to ********
+ *
+ * Compresses a PPM image to a 40image format.
+ *
+ * Parameters:
+ *      FILE *input:    A pointer to the input file.
+ *      FILE *output:   A pointer to the stream the compressed image is
+ *                      written to.
+ *
+ * Expects:
+ *      input and output must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void compress40_to(FILE *input, FILE *output)
 {
         assert(input != NULL);
+        assert(output != NULL);
+        if (Stats_enabled)
+        {
+                Stats_reset();
+        }
+
+        uint64_t start = Stats_begin(STATS_READ);
+        Trace_begin("read", TRACE_NO_STRIP);
         Pnm_ppm image = Pnm_ppmread(input, uarray2_methods_plain);
+        Trace_end("read", TRACE_NO_STRIP);
+        Stats_end(STATS_READ, start);
 
         /* Print compressed image header */
-        printf("COMP40 Compressed image format 2\n%u %u\n", image->width & ~1, image->height & ~1);
-
-        /* Allocate memory for processing blocks */
-        /* Only allocate RGB wrapper to reuse existing structs from image */
-        RGB_block rgb_block;
-        NEW(rgb_block);
-        CAV_block cav_block = CAV_block_new();
-        DCT dct = DCT_new();
-        Quantized quantized = Quantized_new();
-
-        /* Iterate through 2×2 blocks */
-        for (size_t col = 0; col < image->width / 2; col++)
+        start = Stats_begin(STATS_WRITE);
+        int written = fprintf(output, "COMP40 Compressed image format 2\n%u %u\n", image->width & ~1, image->height & ~1);
+        Stats_end(STATS_WRITE, start);
+
+        /* Allocate scratch from this thread's arena */
+        JobArena_T arena = JobArena_thread();
+        Frame frame = Frame_arena_new(arena, image->width & ~1, image->height & ~1);
+        size_t rows = frame->height / 2, cols = frame->width / 2, count;
+        Strip strips = new_strips(arena, frame, &count);
+
+        /* Convert the whole image to planar component video */
+        start = Stats_begin(STATS_CONVERT);
+        Trace_begin("convert", TRACE_NO_STRIP);
+        convert_bands(arena, from_ppm_band, frame, image);
+        Trace_end("convert", TRACE_NO_STRIP);
+        Stats_end(STATS_CONVERT, start);
+
+        /* Code a wave of strips at once, then write them in column order */
+        for (size_t col = 0; col < cols;)
         {
-                for (size_t row = 0; row < image->height / 2; row++)
+                size_t n = next_wave(strips, count, col, cols);
+
+                start = Stats_begin(STATS_CODE);
+                run_jobs(encode_strip, strips, sizeof *strips, n);
+                Stats_end(STATS_CODE, start);
+                col = strips[n - 1].first_col + strips[n - 1].ncols;
+
+                start = Stats_begin(STATS_WRITE);
+                for (size_t i = 0; i < n; i++)
                 {
-                        for (size_t k = 0; k < 4; k++)
-                        {
-                                size_t i = k % 2, j = k / 2;
-                                Pnm_rgb rgb = image->methods->at(image->pixels, col * 2 + i, row * 2 + j);
-                                rgb_block->rgb[k] = rgb;
-                        }
-
-                        /* Process the block */
-                        RGBtoCAV_block(cav_block, rgb_block, image->denominator);
-                        computeDCT(dct, cav_block);
-                        quantize(quantized, dct);
-                        uint32_t packed = packWord(quantized);
-
-                        /* Output packed word as 4 bytes */
-                        for (int shift = 24; shift >= 0; shift -= 8)
-                        {
-                                putchar((packed >> shift) & 0xFF);
-                        }
+                        Trace_begin("write", strips[i].first_col);
+                        fwrite(strips[i].bytes, 4, strips[i].ncols * rows, output);
+                        Trace_end("write", strips[i].first_col);
                 }
+                Stats_end(STATS_WRITE, start);
+        }
+
+        if (Stats_enabled)
+        {
+                /* A pipe cannot tell us how much was read; count pixels */
+                long in = ftell(input);
+                size_t samples = 3 * (size_t)image->width * image->height;
+                size_t blocks = cols * rows;
+                Stats_image(image->width, image->height, blocks);
+                Stats_bytes(in >= 0 ? (size_t)in : samples * (image->denominator > 255 ? 2 : 1), written + 4 * blocks);
+                Stats_report(stderr, "compress");
         }
 
-        /* Free allocated memory */
-        Quantized_free(&quantized);
-        DCT_free(&dct);
-        CAV_block_free(&cav_block);
-        FREE(rgb_block);
+        /* Release the scratch, returning it to the system if this image
+         * needed more than a thread keeps, and free the image */
+        JobArena_trim(arena, ARENA_KEEP);
         Pnm_ppmfree(&image);
 }
 
 /********** decompress40 ********
  *
- * Decompresses a 40image format to a PPM image.
+ * Decompresses a 40image format to a PPM image on stdout.
  *
  * Parameters:
  *      FILE *input:    A pointer to the input file.
@@ -88,15 +447,46 @@ void compress40(FILE *input)
  *      Will CRE if any expectation is violated.
  ************************/
 void decompress40(FILE *input)
+{
+        decompress40_to(input, stdout);
+}
+
+/********** decompress40_to ********
+ *
+ * Decompresses a 40image format to a PPM image.
+ *
+ * Parameters:
+ *      FILE *input:    A pointer to the input file.
+ *      FILE *output:   A pointer to the stream the PPM image is written to.
+ *
+ * Expects:
+ *      input and output must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void decompress40_to(FILE *input, FILE *output)
 {
         assert(input != NULL);
+        assert(output != NULL);
+        if (Stats_enabled)
+        {
+                Stats_reset();
+        }
 
         /* Read header */
+        uint64_t start = Stats_begin(STATS_READ);
+        Trace_begin("read", TRACE_NO_STRIP);
         unsigned height, width;
-        int read = fscanf(input, "COMP40 Compressed image format 2\n%u %u", &width, &height);
+        int header = 0;
+        int read = fscanf(input, "COMP40 Compressed image format 2\n%u %u%n", &width, &height, &header);
         assert(read == 2);
         int c = getc(input);
         assert(c == '\n');
+        /* The image's UArray2 takes each dimension as an int */
+        assert(width <= INT_MAX && height <= INT_MAX);
+        Trace_end("read", TRACE_NO_STRIP);
+        Stats_end(STATS_READ, start);
 
         /* Allocate and initialize image */
         Pnm_ppm image;
@@ -107,45 +497,58 @@ void decompress40(FILE *input)
         image->methods = uarray2_methods_plain;
         image->pixels = image->methods->new(width, height, 12);
 
-        /* Allocate memory for processing blocks */
-        RGB_block rgb_block = RGB_block_new();
-        CAV_block cav_block = CAV_block_new();
-        DCT dct = DCT_new();
-        Quantized quantized = Quantized_new();
+        /* Allocate scratch from this thread's arena */
+        JobArena_T arena = JobArena_thread();
+        Frame frame = Frame_arena_new(arena, width & ~1, height & ~1);
+        size_t rows = frame->height / 2, cols = frame->width / 2, count;
+        Strip strips = new_strips(arena, frame, &count);
 
-        /* Read and decompress image */
-        for (size_t col = 0; col < width / 2; col++)
+        /* Read a wave of strips in column order, then decode them at once */
+        for (size_t col = 0; col < cols;)
         {
-                for (size_t row = 0; row < height / 2; row++)
+                size_t n = next_wave(strips, count, col, cols);
+
+                start = Stats_begin(STATS_READ);
+                for (size_t i = 0; i < n; i++)
                 {
-                        /* Read packed word */
-                        uint32_t packed = 0;
-                        for (int shift = 24; shift >= 0; shift -= 8)
-                        {
-                                packed = Bitpack_newu(packed, 8, shift, getc(input));
-                        }
-                        unpackWord(quantized, packed);
-                        dequantize(dct, quantized);
-                        invertDCT(cav_block, dct);
-                        CAVtoRGB_block(rgb_block, cav_block, image->denominator);
-
-                        /* Reconstruct 2×2 RGB block */
-                        for (size_t k = 0; k < 4; k++)
-                        {
-                                size_t i = k % 2, j = k / 2;
-                                Pnm_rgb rgb = image->methods->at(image->pixels, col * 2 + i, row * 2 + j);
-                                *rgb = *(rgb_block->rgb[k]);
-                        }
+                        Trace_begin("read", strips[i].first_col);
+                        size_t got = fread(strips[i].bytes, 4, strips[i].ncols * rows, input);
+                        assert(got == strips[i].ncols * rows);
+                        Trace_end("read", strips[i].first_col);
                 }
+                Stats_end(STATS_READ, start);
+
+                start = Stats_begin(STATS_CODE);
+                run_jobs(decode_strip, strips, sizeof *strips, n);
+                Stats_end(STATS_CODE, start);
+                col = strips[n - 1].first_col + strips[n - 1].ncols;
         }
 
+        /* Convert the whole frame back to RGB */
+        start = Stats_begin(STATS_CONVERT);
+        Trace_begin("convert", TRACE_NO_STRIP);
+        convert_bands(arena, to_ppm_band, frame, image);
+        Trace_end("convert", TRACE_NO_STRIP);
+        Stats_end(STATS_CONVERT, start);
+
         /* Output decompressed image */
-        Pnm_ppmwrite(stdout, image);
+        start = Stats_begin(STATS_WRITE);
+        Trace_begin("write", TRACE_NO_STRIP);
+        Pnm_ppmwrite(output, image);
+        Trace_end("write", TRACE_NO_STRIP);
+        Stats_end(STATS_WRITE, start);
+
+        if (Stats_enabled)
+        {
+                size_t blocks = cols * rows;
+                int ppm_header = snprintf(NULL, 0, "P6\n%u %u\n%u\n", width, height, image->denominator);
+                Stats_image(width, height, blocks);
+                Stats_bytes(header + 1 + 4 * blocks, ppm_header + 3 * (size_t)width * height);
+                Stats_report(stderr, "decompress");
+        }
 
-        /* Free allocated memory */
-        Quantized_free(&quantized);
-        DCT_free(&dct);
-        CAV_block_free(&cav_block);
-        RGB_block_free(&rgb_block);
+        /* Release the scratch, returning it to the system if this image
+         * needed more than a thread keeps, and free the image */
+        JobArena_trim(arena, ARENA_KEEP);
         Pnm_ppmfree(&image);
 }
@@ -0,0 +1,53 @@
+/**************************************************************
+ *
+ *                     compress40_io.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for versions of compress40 and
+ *     decompress40 that write to a caller-supplied stream instead of
+ *     stdout, so that several images can be coded at once by one process.
+ *
+ ************************/
+
+#ifndef COMPRESS40_IO_H
+#define COMPRESS40_IO_H
+
+#include <stdio.h>
+
+/********** compress40_to ********
+ *
+ * Compresses a PPM image to a 40image format.
+ *
+ * Parameters:
+ *      FILE *input:    A pointer to the input file.
+ *      FILE *output:   A pointer to the stream the compressed image is
+ *                      written to.
+ *
+ * Expects:
+ *      input and output must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void compress40_to(FILE *input, FILE *output);
+
+/********** decompress40_to ********
+ *
+ * Decompresses a 40image format to a PPM image.
+ *
+ * Parameters:
+ *      FILE *input:    A pointer to the input file.
+ *      FILE *output:   A pointer to the stream the PPM image is written to.
+ *
+ * Expects:
+ *      input and output must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void decompress40_to(FILE *input, FILE *output);
+
+#endif
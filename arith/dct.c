@@ -96,6 +96,91 @@ void invertDCT(CAV_block block,
         block->cav[3]->Y = dct->a + dct->b + dct->c + dct->d;
 }
 
+/********** computeDCT_frame ********
+ *
+ * Computes the Discrete Cosine Transform (DCT) of one 2x2 block of a
+ * planar frame, giving the same coefficients as computeDCT would for the
+ * same samples.
+ *
+ * Parameters:
+ *      DCT dct:        A DCT structure to store the computed DCT values.
+ *      Frame frame:    The frame holding the block.
+ *      size_t col:     The column of the block, in blocks.
+ *      size_t row:     The row of the block, in blocks.
+ *
+ * Expects:
+ *      dct and frame must not be NULL.
+ *      The block must lie inside the frame.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void computeDCT_frame(DCT dct,
+                      Frame frame,
+                      size_t col,
+                      size_t row)
+{
+        assert(dct != NULL);
+        assert(frame != NULL);
+        assert(col * 2 + 1 < frame->width && row * 2 + 1 < frame->height);
+
+        /* Sample k of the block is at top + k % 2, or bottom + k % 2 */
+        size_t top = row * 2 * frame->stride + col * 2;
+        size_t bottom = top + frame->stride;
+        const float *Y = frame->Y, *P_b = frame->P_b, *P_r = frame->P_r;
+
+        /* Same sums, in the same order, as computeDCT */
+        dct->Pbar_b = (P_b[bottom + 1] + P_b[bottom] + P_b[top + 1] + P_b[top]) / 4.0;
+        dct->Pbar_r = (P_r[bottom + 1] + P_r[bottom] + P_r[top + 1] + P_r[top]) / 4.0;
+
+        dct->a = (Y[bottom + 1] + Y[bottom] + Y[top + 1] + Y[top]) / 4.0;
+        dct->b = (Y[bottom + 1] + Y[bottom] - Y[top + 1] - Y[top]) / 4.0;
+        dct->c = (Y[bottom + 1] - Y[bottom] + Y[top + 1] - Y[top]) / 4.0;
+        dct->d = (Y[bottom + 1] - Y[bottom] - Y[top + 1] + Y[top]) / 4.0;
+}
+
+/********** invertDCT_frame ********
+ *
+ * Computes the inverse Discrete Cosine Transform (DCT) of a DCT
+ * structure into one 2x2 block of a planar frame, giving the same
+ * samples as invertDCT would.
+ *
+ * Parameters:
+ *      Frame frame:    The frame to store the block in.
+ *      DCT dct:        A DCT structure containing the DCT coefficients.
+ *      size_t col:     The column of the block, in blocks.
+ *      size_t row:     The row of the block, in blocks.
+ *
+ * Expects:
+ *      frame and dct must not be NULL.
+ *      The block must lie inside the frame.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void invertDCT_frame(Frame frame,
+                     DCT dct,
+                     size_t col,
+                     size_t row)
+{
+        assert(frame != NULL);
+        assert(dct != NULL);
+        assert(col * 2 + 1 < frame->width && row * 2 + 1 < frame->height);
+
+        size_t top = row * 2 * frame->stride + col * 2;
+        size_t bottom = top + frame->stride;
+
+        frame->P_b[top] = frame->P_b[top + 1] = dct->Pbar_b;
+        frame->P_b[bottom] = frame->P_b[bottom + 1] = dct->Pbar_b;
+        frame->P_r[top] = frame->P_r[top + 1] = dct->Pbar_r;
+        frame->P_r[bottom] = frame->P_r[bottom + 1] = dct->Pbar_r;
+
+        frame->Y[top] = dct->a - dct->b - dct->c + dct->d;
+        frame->Y[top + 1] = dct->a - dct->b + dct->c - dct->d;
+        frame->Y[bottom] = dct->a + dct->b - dct->c - dct->d;
+        frame->Y[bottom + 1] = dct->a + dct->b + dct->c + dct->d;
+}
+
 /********** DCT_new ********
  *
  * Allocates memory for a new DCT structure.
@@ -140,4 +225,31 @@ void DCT_free(DCT *dct)
 
         FREE(*dct);
         dct = NULL;
-}
\ No newline at end of file
+}
+
+/********** DCT_arena_new ********
+ *
+ * Allocates a new DCT structure from an arena.
+ *
+ * Parameters:
+ *      JobArena_T arena:  The arena to allocate from.
+ *
+ * Returns:
+ *      DCT: A new DCT structure.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      The structure lives until the arena is reset or freed; it must not
+ *      be passed to DCT_free.
+ ************************/
+DCT DCT_arena_new(JobArena_T arena)
+{
+        assert(arena != NULL);
+
+        DCT dct;
+        JOBARENA_NEW(arena, dct);
+        return dct;
+}
@@ -17,6 +17,8 @@
 
 #include <stdio.h>
 #include "rgb2cav.h"
+#include "frame.h"
+#include "jobarena.h"
 
 /********** DCT ********
  *
@@ -83,6 +85,54 @@ void computeDCT(DCT dct,
 void invertDCT(CAV_block block,
                DCT dct);
 
+/********** computeDCT_frame ********
+ *
+ * Computes the Discrete Cosine Transform (DCT) of one 2x2 block of a
+ * planar frame, giving the same coefficients as computeDCT would for the
+ * same samples.
+ *
+ * Parameters:
+ *      DCT dct:        A DCT structure to store the computed DCT values.
+ *      Frame frame:    The frame holding the block.
+ *      size_t col:     The column of the block, in blocks.
+ *      size_t row:     The row of the block, in blocks.
+ *
+ * Expects:
+ *      dct and frame must not be NULL.
+ *      The block must lie inside the frame.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void computeDCT_frame(DCT dct,
+                      Frame frame,
+                      size_t col,
+                      size_t row);
+
+/********** invertDCT_frame ********
+ *
+ * Computes the inverse Discrete Cosine Transform (DCT) of a DCT
+ * structure into one 2x2 block of a planar frame, giving the same
+ * samples as invertDCT would.
+ *
+ * Parameters:
+ *      Frame frame:    The frame to store the block in.
+ *      DCT dct:        A DCT structure containing the DCT coefficients.
+ *      size_t col:     The column of the block, in blocks.
+ *      size_t row:     The row of the block, in blocks.
+ *
+ * Expects:
+ *      frame and dct must not be NULL.
+ *      The block must lie inside the frame.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void invertDCT_frame(Frame frame,
+                     DCT dct,
+                     size_t col,
+                     size_t row);
+
 /********** DCT_new ********
  *
  * Allocates memory for a new DCT structure.
@@ -117,4 +167,24 @@ DCT DCT_new();
  ************************/
 void DCT_free(DCT *dct);
 
+/********** DCT_arena_new ********
+ *
+ * Allocates a new DCT structure from an arena.
+ *
+ * Parameters:
+ *      JobArena_T arena:  The arena to allocate from.
+ *
+ * Returns:
+ *      DCT: A new DCT structure.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      The structure lives until the arena is reset or freed; it must not
+ *      be passed to DCT_free.
+ ************************/
+DCT DCT_arena_new(JobArena_T arena);
+
 #endif
\ No newline at end of file
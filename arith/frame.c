@@ -0,0 +1,302 @@
+/**************************************************************
+ *
+ *                     frame.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for the planar component
+ *     video frame. The row conversions repeat the arithmetic of RGBtoCAV
+ *     and CAVtoRGB expression for expression, so the planar pipeline
+ *     produces the same bytes as the block pipeline.
+ *
+ ************************/
+
+#include "assert.h"
+#include "a2row.h"
+#include "frame.h"
+#include "kernels.h"
+
+/* The number of floats in FRAME_ALIGN bytes */
+#define ALIGN_FLOATS (FRAME_ALIGN / sizeof(float))
+
+/********** Frame_arena_new ********
+ *
+ * Allocates a frame and its planes from an arena.
+ *
+ * Parameters:
+ *      JobArena_T arena:  The arena to allocate from.
+ *      unsigned width:    The width of the frame in pixels.
+ *      unsigned height:   The height of the frame in pixels.
+ *
+ * Returns:
+ *      Frame: A new frame. The samples are not initialized.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated or allocation fails.
+ *      The frame lives until the arena is reset or freed.
+ ************************/
+Frame Frame_arena_new(JobArena_T arena, unsigned width, unsigned height)
+{
+        assert(arena != NULL);
+
+        Frame frame;
+        JOBARENA_NEW(arena, frame);
+        frame->width = width;
+        frame->height = height;
+        frame->stride = (width + ALIGN_FLOATS - 1) & ~(ALIGN_FLOATS - 1);
+
+        size_t plane = frame->stride * height * sizeof(float);
+        frame->Y = JobArena_alloc_aligned(arena, plane, FRAME_ALIGN);
+        frame->P_b = JobArena_alloc_aligned(arena, plane, FRAME_ALIGN);
+        frame->P_r = JobArena_alloc_aligned(arena, plane, FRAME_ALIGN);
+        return frame;
+}
+
+/********** Frame_from_rgb_row ********
+ *
+ * Converts a row of pixels from RGB to component video. This is the
+ * reference rgb_to_frame kernel.
+ *
+ * Parameters:
+ *      float *Y, *P_b, *P_r:        Where to store the n samples.
+ *      const struct Pnm_rgb *rgb:   The n pixels.
+ *      size_t n:                    The number of pixels.
+ *      int denominator:             The image's maxval.
+ *
+ * Expects:
+ *      No pointer may be NULL, and denominator must be positive.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Frame_from_rgb_row(float *Y, float *P_b, float *P_r,
+                        const struct Pnm_rgb *rgb, size_t n, int denominator)
+{
+        assert(Y != NULL && P_b != NULL && P_r != NULL);
+        assert(rgb != NULL);
+        assert(denominator > 0);
+
+        for (size_t col = 0; col < n; col++)
+        {
+                float red = (float)rgb[col].red / denominator;
+                float green = (float)rgb[col].green / denominator;
+                float blue = (float)rgb[col].blue / denominator;
+
+                float y = 0.299 * red + 0.587 * green + 0.114 * blue;
+                float pb = -0.168736 * red - 0.331264 * green + 0.5 * blue;
+                float pr = 0.5 * red - 0.418688 * green - 0.081312 * blue;
+
+                Y[col] = y < 0 ? 0 : (y > 1 ? 1 : y);
+                P_b[col] = pb < -0.5 ? -0.5 : (pb > 0.5 ? 0.5 : pb);
+                P_r[col] = pr < -0.5 ? -0.5 : (pr > 0.5 ? 0.5 : pr);
+        }
+}
+
+/********** Frame_to_rgb_row ********
+ *
+ * Converts a row of samples from component video to RGB. This is the
+ * reference frame_to_rgb kernel.
+ *
+ * Parameters:
+ *      struct Pnm_rgb *rgb:         Where to store the n pixels.
+ *      const float *Y, *P_b, *P_r:  The n samples.
+ *      size_t n:                    The number of pixels.
+ *      int denominator:             The image's maxval.
+ *
+ * Expects:
+ *      No pointer may be NULL, and denominator must be positive.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Frame_to_rgb_row(struct Pnm_rgb *rgb, const float *Y, const float *P_b,
+                      const float *P_r, size_t n, int denominator)
+{
+        assert(rgb != NULL);
+        assert(Y != NULL && P_b != NULL && P_r != NULL);
+        assert(denominator > 0);
+
+        for (size_t col = 0; col < n; col++)
+        {
+                float red = Y[col] + 1.402 * P_r[col];
+                float green = Y[col] - 0.344136 * P_b[col] -
+                              0.714136 * P_r[col];
+                float blue = Y[col] + 1.772 * P_b[col];
+
+                red = red < 0 ? 0 : (red > 1 ? 1 : red);
+                green = green < 0 ? 0 : (green > 1 ? 1 : green);
+                blue = blue < 0 ? 0 : (blue > 1 ? 1 : blue);
+
+                rgb[col].red = red * denominator;
+                rgb[col].green = green * denominator;
+                rgb[col].blue = blue * denominator;
+        }
+}
+
+/********** Frame_from_ppm ********
+ *
+ * Converts the top-left width x height pixels of an image from RGB to
+ * component video, filling every sample of the frame. Each sample is
+ * bit-for-bit what RGBtoCAV computes for the same pixel.
+ *
+ * Parameters:
+ *      Frame frame:     The frame to fill.
+ *      Pnm_ppm image:   The image to convert.
+ *
+ * Expects:
+ *      frame and image must not be NULL.
+ *      image must be at least as wide and as tall as frame.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Rows that A2Methods_row hands out are converted a whole row at a
+ *      time by the active kernels; other images a pixel at a time by the
+ *      reference kernel.
+ ************************/
+void Frame_from_ppm(Frame frame, Pnm_ppm image)
+{
+        assert(frame != NULL);
+        Frame_from_ppm_rows(frame, image, 0, frame->height);
+}
+
+/********** Frame_from_ppm_rows ********
+ *
+ * Like Frame_from_ppm, but converts only some rows, so that bands of
+ * rows can be converted concurrently.
+ *
+ * Parameters:
+ *      Frame frame:        The frame to fill.
+ *      Pnm_ppm image:      The image to convert.
+ *      size_t first_row:   The first row to convert.
+ *      size_t nrows:       The number of rows to convert.
+ *
+ * Expects:
+ *      frame and image must not be NULL.
+ *      image must be at least as wide and as tall as frame.
+ *      The rows must be within the frame.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Rows are converted as in Frame_from_ppm.
+ ************************/
+void Frame_from_ppm_rows(Frame frame, Pnm_ppm image, size_t first_row,
+                         size_t nrows)
+{
+        assert(frame != NULL);
+        assert(image != NULL);
+        assert(image->width >= frame->width);
+        assert(image->height >= frame->height);
+        assert(first_row + nrows <= frame->height);
+
+        int denominator = image->denominator;
+        assert(denominator > 0);
+        Kernels kernels = Kernels_active();
+
+        for (size_t row = first_row; row < first_row + nrows; row++)
+        {
+                float *Y = frame->Y + row * frame->stride;
+                float *P_b = frame->P_b + row * frame->stride;
+                float *P_r = frame->P_r + row * frame->stride;
+                struct Pnm_rgb *pixels = A2Methods_row(image->methods,
+                                                       image->pixels, row);
+
+                if (pixels != NULL)
+                {
+                        kernels->rgb_to_frame(Y, P_b, P_r, pixels,
+                                              frame->width, denominator);
+                        continue;
+                }
+                for (size_t col = 0; col < frame->width; col++)
+                {
+                        Frame_from_rgb_row(&Y[col], &P_b[col], &P_r[col],
+                                           image->methods->at(image->pixels,
+                                                              col, row),
+                                           1, denominator);
+                }
+        }
+}
+
+/********** Frame_to_ppm ********
+ *
+ * Converts a frame from component video to RGB, filling the top-left
+ * width x height pixels of an image. Each pixel is bit-for-bit what
+ * CAVtoRGB computes for the same samples.
+ *
+ * Parameters:
+ *      Pnm_ppm image:   The image to fill.
+ *      Frame frame:     The frame to convert.
+ *
+ * Expects:
+ *      image and frame must not be NULL.
+ *      image must be at least as wide and as tall as frame.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Rows are converted as in Frame_from_ppm.
+ ************************/
+void Frame_to_ppm(Pnm_ppm image, Frame frame)
+{
+        assert(frame != NULL);
+        Frame_to_ppm_rows(image, frame, 0, frame->height);
+}
+
+/********** Frame_to_ppm_rows ********
+ *
+ * Like Frame_to_ppm, but converts only some rows, so that bands of rows
+ * can be converted concurrently.
+ *
+ * Parameters:
+ *      Pnm_ppm image:      The image to fill.
+ *      Frame frame:        The frame to convert.
+ *      size_t first_row:   The first row to convert.
+ *      size_t nrows:       The number of rows to convert.
+ *
+ * Expects:
+ *      image and frame must not be NULL.
+ *      image must be at least as wide and as tall as frame.
+ *      The rows must be within the frame.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Frame_to_ppm_rows(Pnm_ppm image, Frame frame, size_t first_row,
+                       size_t nrows)
+{
+        assert(image != NULL);
+        assert(frame != NULL);
+        assert(image->width >= frame->width);
+        assert(image->height >= frame->height);
+        assert(first_row + nrows <= frame->height);
+
+        int denominator = image->denominator;
+        assert(denominator > 0);
+        Kernels kernels = Kernels_active();
+
+        for (size_t row = first_row; row < first_row + nrows; row++)
+        {
+                const float *Y = frame->Y + row * frame->stride;
+                const float *P_b = frame->P_b + row * frame->stride;
+                const float *P_r = frame->P_r + row * frame->stride;
+                struct Pnm_rgb *pixels = A2Methods_row(image->methods,
+                                                       image->pixels, row);
+
+                if (pixels != NULL)
+                {
+                        kernels->frame_to_rgb(pixels, Y, P_b, P_r,
+                                              frame->width, denominator);
+                        continue;
+                }
+                for (size_t col = 0; col < frame->width; col++)
+                {
+                        Frame_to_rgb_row(image->methods->at(image->pixels,
+                                                            col, row),
+                                         &Y[col], &P_b[col], &P_r[col], 1,
+                                         denominator);
+                }
+        }
+}
@@ -0,0 +1,200 @@
+/**************************************************************
+ *
+ *                     frame.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for the planar component video
+ *     frame. A frame holds a whole image as three separate, contiguous
+ *     float planes (Y, Pb and Pr) instead of one struct per pixel, so the
+ *     color conversion runs as its own pass over the image and the DCT
+ *     pass reads straight from the planes.
+ *
+ ************************/
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stddef.h>
+#include "pnm.h"
+#include "jobarena.h"
+
+/* The alignment of every plane and of every row within a plane */
+#define FRAME_ALIGN 64
+
+/********** Frame ********
+ *
+ * An image in component video, one plane per component. The sample for
+ * pixel (col, row) of a plane is at plane[row * stride + col].
+ *
+ * Elements:
+ *      unsigned width:    The width of the frame in pixels.
+ *      unsigned height:   The height of the frame in pixels.
+ *      size_t stride:     The distance in floats between the starts of
+ *                         consecutive rows. Rows are padded so that each
+ *                         starts on a FRAME_ALIGN boundary.
+ *      float *Y:          The luma plane.
+ *      float *P_b:        The blue-difference chroma plane.
+ *      float *P_r:        The red-difference chroma plane.
+ ************************/
+typedef struct Frame
+{
+        unsigned width;
+        unsigned height;
+        size_t stride;
+        float *Y;
+        float *P_b;
+        float *P_r;
+} *Frame;
+
+/********** Frame_arena_new ********
+ *
+ * Allocates a frame and its planes from an arena.
+ *
+ * Parameters:
+ *      JobArena_T arena:  The arena to allocate from.
+ *      unsigned width:    The width of the frame in pixels.
+ *      unsigned height:   The height of the frame in pixels.
+ *
+ * Returns:
+ *      Frame: A new frame. The samples are not initialized.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated or allocation fails.
+ *      The frame lives until the arena is reset or freed.
+ ************************/
+Frame Frame_arena_new(JobArena_T arena, unsigned width, unsigned height);
+
+/********** Frame_from_rgb_row ********
+ *
+ * Converts a row of pixels from RGB to component video. This is the
+ * reference rgb_to_frame kernel.
+ *
+ * Parameters:
+ *      float *Y, *P_b, *P_r:        Where to store the n samples.
+ *      const struct Pnm_rgb *rgb:   The n pixels.
+ *      size_t n:                    The number of pixels.
+ *      int denominator:             The image's maxval.
+ *
+ * Expects:
+ *      No pointer may be NULL, and denominator must be positive.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Frame_from_rgb_row(float *Y, float *P_b, float *P_r,
+                        const struct Pnm_rgb *rgb, size_t n, int denominator);
+
+/********** Frame_to_rgb_row ********
+ *
+ * Converts a row of samples from component video to RGB. This is the
+ * reference frame_to_rgb kernel.
+ *
+ * Parameters:
+ *      struct Pnm_rgb *rgb:         Where to store the n pixels.
+ *      const float *Y, *P_b, *P_r:  The n samples.
+ *      size_t n:                    The number of pixels.
+ *      int denominator:             The image's maxval.
+ *
+ * Expects:
+ *      No pointer may be NULL, and denominator must be positive.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Frame_to_rgb_row(struct Pnm_rgb *rgb, const float *Y, const float *P_b,
+                      const float *P_r, size_t n, int denominator);
+
+/********** Frame_from_ppm ********
+ *
+ * Converts the top-left width x height pixels of an image from RGB to
+ * component video, filling every sample of the frame. Each sample is
+ * bit-for-bit what RGBtoCAV computes for the same pixel.
+ *
+ * Parameters:
+ *      Frame frame:     The frame to fill.
+ *      Pnm_ppm image:   The image to convert.
+ *
+ * Expects:
+ *      frame and image must not be NULL.
+ *      image must be at least as wide and as tall as frame.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Rows that A2Methods_row hands out are converted a whole row at a
+ *      time by the active kernels; other images a pixel at a time by the
+ *      reference kernel.
+ ************************/
+void Frame_from_ppm(Frame frame, Pnm_ppm image);
+
+/********** Frame_from_ppm_rows ********
+ *
+ * Like Frame_from_ppm, but converts only some rows, so that bands of
+ * rows can be converted concurrently.
+ *
+ * Parameters:
+ *      Frame frame:        The frame to fill.
+ *      Pnm_ppm image:      The image to convert.
+ *      size_t first_row:   The first row to convert.
+ *      size_t nrows:       The number of rows to convert.
+ *
+ * Expects:
+ *      frame and image must not be NULL.
+ *      image must be at least as wide and as tall as frame.
+ *      The rows must be within the frame.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Rows are converted as in Frame_from_ppm.
+ ************************/
+void Frame_from_ppm_rows(Frame frame, Pnm_ppm image, size_t first_row,
+                         size_t nrows);
+
+/********** Frame_to_ppm ********
+ *
+ * Converts a frame from component video to RGB, filling the top-left
+ * width x height pixels of an image. Each pixel is bit-for-bit what
+ * CAVtoRGB computes for the same samples.
+ *
+ * Parameters:
+ *      Pnm_ppm image:   The image to fill.
+ *      Frame frame:     The frame to convert.
+ *
+ * Expects:
+ *      image and frame must not be NULL.
+ *      image must be at least as wide and as tall as frame.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Rows are converted as in Frame_from_ppm.
+ ************************/
+void Frame_to_ppm(Pnm_ppm image, Frame frame);
+
+/********** Frame_to_ppm_rows ********
+ *
+ * Like Frame_to_ppm, but converts only some rows, so that bands of rows
+ * can be converted concurrently.
+ *
+ * Parameters:
+ *      Pnm_ppm image:      The image to fill.
+ *      Frame frame:        The frame to convert.
+ *      size_t first_row:   The first row to convert.
+ *      size_t nrows:       The number of rows to convert.
+ *
+ * Expects:
+ *      image and frame must not be NULL.
+ *      image must be at least as wide and as tall as frame.
+ *      The rows must be within the frame.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Frame_to_ppm_rows(Pnm_ppm image, Frame frame, size_t first_row,
+                       size_t nrows);
+
+#endif
@@ -0,0 +1,382 @@
+/**************************************************************
+ *
+ *                     imaged.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for the wire protocol spoken
+ *     by the 40imaged codec server and its clients.
+ *
+ ************************/
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "imaged.h"
+
+#define MAX_FDS 2
+
+/********** Imaged_connect ********
+ *
+ * Connects to a 40imaged server.
+ *
+ * Parameters:
+ *      const char *path:  The path of the server's socket.
+ *
+ * Return:
+ *      int:               The connected socket, or -1 on failure.
+ *
+ * Expects:
+ *      path must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Imaged_connect(const char *path)
+{
+        assert(path != NULL);
+
+        struct sockaddr_un addr;
+        if (strlen(path) >= sizeof(addr.sun_path))
+        {
+                return -1;
+        }
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strcpy(addr.sun_path, path);
+
+        int sock = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (sock < 0)
+        {
+                return -1;
+        }
+        if (connect(sock, (struct sockaddr *)&addr, sizeof(addr)) < 0)
+        {
+                close(sock);
+                return -1;
+        }
+        return sock;
+}
+
+/********** Imaged_send ********
+ *
+ * Sends a header, any file descriptors, and an inline payload.
+ *
+ * Parameters:
+ *      int sock:                  The connected socket.
+ *      const Imaged_header *hdr:  The header to send.
+ *      const void *payload:       hdr->length bytes to send after the
+ *                                 header, or NULL if there are none.
+ *      const int *fds:            The descriptors to pass, or NULL.
+ *      int nfds:                  The number of descriptors in fds.
+ *
+ * Return:
+ *      int:                       0 on success, -1 on failure.
+ *
+ * Expects:
+ *      hdr must not be NULL.
+ *      nfds must be between 0 and 2.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Imaged_send(int sock,
+                const Imaged_header *hdr,
+                const void *payload,
+                const int *fds,
+                int nfds)
+{
+        assert(hdr != NULL);
+        assert(nfds >= 0 && nfds <= MAX_FDS);
+        assert(nfds == 0 || fds != NULL);
+
+        struct iovec iov = {(void *)hdr, sizeof(*hdr)};
+        union
+        {
+                struct cmsghdr align;
+                char buf[CMSG_SPACE(MAX_FDS * sizeof(int))];
+        } control;
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+
+        if (nfds > 0)
+        {
+                memset(&control, 0, sizeof(control));
+                msg.msg_control = control.buf;
+                msg.msg_controllen = CMSG_SPACE(nfds * sizeof(int));
+                struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+                cmsg->cmsg_level = SOL_SOCKET;
+                cmsg->cmsg_type = SCM_RIGHTS;
+                cmsg->cmsg_len = CMSG_LEN(nfds * sizeof(int));
+                memcpy(CMSG_DATA(cmsg), fds, nfds * sizeof(int));
+        }
+
+        ssize_t sent;
+        do
+        {
+                sent = sendmsg(sock, &msg, MSG_NOSIGNAL);
+        } while (sent < 0 && errno == EINTR);
+        if (sent < 0)
+        {
+                return -1;
+        }
+        /* The descriptors went with the first byte; send the rest plain */
+        if ((size_t)sent < sizeof(*hdr) &&
+            Imaged_write_full(sock, (const char *)hdr + sent,
+                              sizeof(*hdr) - sent) < 0)
+        {
+                return -1;
+        }
+
+        if (payload != NULL && hdr->length > 0)
+        {
+                return Imaged_write_full(sock, payload, hdr->length);
+        }
+        return 0;
+}
+
+/********** Imaged_recv ********
+ *
+ * Receives a header and any file descriptors attached to it. The payload,
+ * if any, is left on the socket for the caller to read.
+ *
+ * Parameters:
+ *      int sock:            The connected socket.
+ *      Imaged_header *hdr:  Filled in with the received header.
+ *      int *fds:            Filled in with the received descriptors.
+ *      int *nfds:           Filled in with the number of descriptors.
+ *
+ * Return:
+ *      int:                 0 on success, -1 on failure or end of stream.
+ *
+ * Expects:
+ *      hdr, fds and nfds must not be NULL; fds must hold 2 descriptors.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      A header with the wrong magic is reported as a failure.
+ ************************/
+int Imaged_recv(int sock,
+                Imaged_header *hdr,
+                int *fds,
+                int *nfds)
+{
+        assert(hdr != NULL);
+        assert(fds != NULL && nfds != NULL);
+
+        struct iovec iov = {hdr, sizeof(*hdr)};
+        union
+        {
+                struct cmsghdr align;
+                char buf[CMSG_SPACE(MAX_FDS * sizeof(int))];
+        } control;
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.buf;
+        msg.msg_controllen = sizeof(control.buf);
+
+        ssize_t got;
+        do
+        {
+                got = recvmsg(sock, &msg, MSG_CMSG_CLOEXEC);
+        } while (got < 0 && errno == EINTR);
+        if (got <= 0)
+        {
+                return -1;
+        }
+
+        *nfds = 0;
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL;
+             cmsg = CMSG_NXTHDR(&msg, cmsg))
+        {
+                if (cmsg->cmsg_level != SOL_SOCKET ||
+                    cmsg->cmsg_type != SCM_RIGHTS)
+                {
+                        continue;
+                }
+                int n = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                int *passed = (int *)CMSG_DATA(cmsg);
+                for (int i = 0; i < n; i++)
+                {
+                        if (*nfds < MAX_FDS)
+                        {
+                                fds[(*nfds)++] = passed[i];
+                        }
+                        else
+                        {
+                                close(passed[i]);
+                        }
+                }
+        }
+
+        if ((size_t)got < sizeof(*hdr) &&
+            Imaged_read_full(sock, (char *)hdr + got,
+                             sizeof(*hdr) - got) < 0)
+        {
+                return -1;
+        }
+        return hdr->magic == IMAGED_MAGIC ? 0 : -1;
+}
+
+/********** Imaged_read_full ********
+ *
+ * Reads exactly len bytes, retrying short reads.
+ *
+ * Parameters:
+ *      int fd:     The descriptor to read from.
+ *      void *buf:  The buffer to fill.
+ *      size_t len: The number of bytes to read.
+ *
+ * Return:
+ *      int:        0 on success, -1 on failure or early end of stream.
+ ************************/
+int Imaged_read_full(int fd, void *buf, size_t len)
+{
+        char *p = buf;
+        while (len > 0)
+        {
+                ssize_t got = read(fd, p, len);
+                if (got < 0 && errno == EINTR)
+                {
+                        continue;
+                }
+                if (got <= 0)
+                {
+                        return -1;
+                }
+                p += got;
+                len -= got;
+        }
+        return 0;
+}
+
+/********** Imaged_write_full ********
+ *
+ * Writes exactly len bytes, retrying short writes.
+ *
+ * Parameters:
+ *      int fd:           The descriptor to write to.
+ *      const void *buf:  The bytes to write.
+ *      size_t len:       The number of bytes to write.
+ *
+ * Return:
+ *      int:              0 on success, -1 on failure.
+ ************************/
+int Imaged_write_full(int fd, const void *buf, size_t len)
+{
+        const char *p = buf;
+        while (len > 0)
+        {
+                ssize_t put = send(fd, p, len, MSG_NOSIGNAL);
+                if (put < 0 && errno == ENOTSOCK)
+                {
+                        put = write(fd, p, len);
+                }
+                if (put < 0 && errno == EINTR)
+                {
+                        continue;
+                }
+                if (put <= 0)
+                {
+                        return -1;
+                }
+                p += put;
+                len -= put;
+        }
+        return 0;
+}
+
+/********** Imaged_slurp ********
+ *
+ * Reads a stream to its end, for sending an image inline.
+ *
+ * Parameters:
+ *      FILE *fp:       The stream to read.
+ *      size_t *len:    Filled in with the number of bytes read.
+ *
+ * Return:
+ *      char *:         The bytes read.
+ *
+ * Expects:
+ *      fp and len must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Client is responsible for freeing the bytes with FREE.
+ ************************/
+char *Imaged_slurp(FILE *fp, size_t *len)
+{
+        assert(fp != NULL && len != NULL);
+
+        size_t cap = 65536;
+        char *buf = ALLOC(cap);
+        *len = 0;
+
+        size_t got;
+        while ((got = fread(buf + *len, 1, cap - *len, fp)) > 0)
+        {
+                *len += got;
+                if (*len == cap)
+                {
+                        cap *= 2;
+                        RESIZE(buf, cap);
+                }
+        }
+        return buf;
+}
+
+/********** compare_doubles ********
+ *
+ * qsort comparison function for doubles in ascending order.
+ ************************/
+static int compare_doubles(const void *a, const void *b)
+{
+        double x = *(const double *)a;
+        double y = *(const double *)b;
+        return (x > y) - (x < y);
+}
+
+/********** Imaged_percentile ********
+ *
+ * Computes a percentile of a set of samples by nearest rank.
+ *
+ * Parameters:
+ *      double *samples:  The samples. Sorted in place.
+ *      size_t n:         The number of samples.
+ *      double p:         The percentile, between 0 and 100.
+ *
+ * Return:
+ *      double:           The sample at rank p, or 0 if n is 0.
+ *
+ * Expects:
+ *      samples must not be NULL if n is greater than 0.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+double Imaged_percentile(double *samples, size_t n, double p)
+{
+        assert(n == 0 || samples != NULL);
+        assert(p >= 0 && p <= 100);
+        if (n == 0)
+        {
+                return 0;
+        }
+
+        qsort(samples, n, sizeof(*samples), compare_doubles);
+        size_t rank = (size_t)(p / 100.0 * n + 0.5);
+        rank = rank == 0 ? 1 : (rank > n ? n : rank);
+        return samples[rank - 1];
+}
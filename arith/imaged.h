@@ -0,0 +1,205 @@
+/**************************************************************
+ *
+ *                     imaged.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for the wire protocol spoken by
+ *     the 40imaged codec server and its clients over a Unix domain socket.
+ *
+ *     Every message starts with an Imaged_header. A request carries the
+ *     operation in op; a response carries a status in op. Unless the
+ *     matching IMAGED_FD_* flag is set, the image travels inline as
+ *     length bytes right after the header. File descriptors travel as
+ *     SCM_RIGHTS ancillary data attached to the header: the input fd
+ *     first, then the output fd. When IMAGED_FD_OUT is set the response
+ *     has no payload and length is the number of bytes written to the
+ *     output fd (0 if that fd is not seekable). All integers are in host
+ *     byte order, since both ends are on the same machine.
+ *
+ ************************/
+
+#ifndef IMAGED_H
+#define IMAGED_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdint.h>
+
+#define IMAGED_MAGIC 0x4d493034u        /* "40IM" */
+#define IMAGED_DEFAULT_SOCKET "/tmp/40imaged.sock"
+
+/* Request operations */
+#define IMAGED_COMPRESS   1
+#define IMAGED_DECOMPRESS 2
+#define IMAGED_STATS      3
+
+/* Response statuses */
+#define IMAGED_OK    0
+#define IMAGED_ERROR 1
+
+/* Request flags */
+#define IMAGED_FD_IN  0x1
+#define IMAGED_FD_OUT 0x2
+
+/********** Imaged_header ********
+ *
+ * The fixed-size header that starts every request and response.
+ *
+ * Elements:
+ *      uint32_t magic:    Always IMAGED_MAGIC.
+ *      uint16_t op:       The operation (request) or status (response).
+ *      uint16_t flags:    IMAGED_FD_* flags.
+ *      uint64_t length:   The number of payload bytes that follow.
+ ************************/
+typedef struct Imaged_header
+{
+        uint32_t magic;
+        uint16_t op;
+        uint16_t flags;
+        uint64_t length;
+} Imaged_header;
+
+/********** Imaged_connect ********
+ *
+ * Connects to a 40imaged server.
+ *
+ * Parameters:
+ *      const char *path:  The path of the server's socket.
+ *
+ * Return:
+ *      int:               The connected socket, or -1 on failure.
+ *
+ * Expects:
+ *      path must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Imaged_connect(const char *path);
+
+/********** Imaged_send ********
+ *
+ * Sends a header, any file descriptors, and an inline payload.
+ *
+ * Parameters:
+ *      int sock:                  The connected socket.
+ *      const Imaged_header *hdr:  The header to send.
+ *      const void *payload:       hdr->length bytes to send after the
+ *                                 header, or NULL if there are none.
+ *      const int *fds:            The descriptors to pass, or NULL.
+ *      int nfds:                  The number of descriptors in fds.
+ *
+ * Return:
+ *      int:                       0 on success, -1 on failure.
+ *
+ * Expects:
+ *      hdr must not be NULL.
+ *      nfds must be between 0 and 2.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Imaged_send(int sock,
+                const Imaged_header *hdr,
+                const void *payload,
+                const int *fds,
+                int nfds);
+
+/********** Imaged_recv ********
+ *
+ * Receives a header and any file descriptors attached to it. The payload,
+ * if any, is left on the socket for the caller to read.
+ *
+ * Parameters:
+ *      int sock:            The connected socket.
+ *      Imaged_header *hdr:  Filled in with the received header.
+ *      int *fds:            Filled in with the received descriptors.
+ *      int *nfds:           Filled in with the number of descriptors.
+ *
+ * Return:
+ *      int:                 0 on success, -1 on failure or end of stream.
+ *
+ * Expects:
+ *      hdr, fds and nfds must not be NULL; fds must hold 2 descriptors.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      A header with the wrong magic is reported as a failure.
+ ************************/
+int Imaged_recv(int sock,
+                Imaged_header *hdr,
+                int *fds,
+                int *nfds);
+
+/********** Imaged_read_full ********
+ *
+ * Reads exactly len bytes, retrying short reads.
+ *
+ * Parameters:
+ *      int fd:     The descriptor to read from.
+ *      void *buf:  The buffer to fill.
+ *      size_t len: The number of bytes to read.
+ *
+ * Return:
+ *      int:        0 on success, -1 on failure or early end of stream.
+ ************************/
+int Imaged_read_full(int fd, void *buf, size_t len);
+
+/********** Imaged_write_full ********
+ *
+ * Writes exactly len bytes, retrying short writes.
+ *
+ * Parameters:
+ *      int fd:           The descriptor to write to.
+ *      const void *buf:  The bytes to write.
+ *      size_t len:       The number of bytes to write.
+ *
+ * Return:
+ *      int:              0 on success, -1 on failure.
+ ************************/
+int Imaged_write_full(int fd, const void *buf, size_t len);
+
+/********** Imaged_slurp ********
+ *
+ * Reads a stream to its end, for sending an image inline.
+ *
+ * Parameters:
+ *      FILE *fp:       The stream to read.
+ *      size_t *len:    Filled in with the number of bytes read.
+ *
+ * Return:
+ *      char *:         The bytes read.
+ *
+ * Expects:
+ *      fp and len must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Client is responsible for freeing the bytes with FREE.
+ ************************/
+char *Imaged_slurp(FILE *fp, size_t *len);
+
+/********** Imaged_percentile ********
+ *
+ * Computes a percentile of a set of samples by nearest rank.
+ *
+ * Parameters:
+ *      double *samples:  The samples. Sorted in place.
+ *      size_t n:         The number of samples.
+ *      double p:         The percentile, between 0 and 100.
+ *
+ * Return:
+ *      double:           The sample at rank p, or 0 if n is 0.
+ *
+ * Expects:
+ *      samples must not be NULL if n is greater than 0.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+double Imaged_percentile(double *samples, size_t n, double p);
+
+#endif
@@ -0,0 +1,386 @@
+/**************************************************************
+ *
+ *                     jobarena.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for the per-job bump
+ *     allocator. An arena is a singly linked list of chunks; allocation
+ *     bumps a cursor through the current chunk and moves on to the next
+ *     one (allocating it only if the list has run out).
+ *
+ ************************/
+
+#include <pthread.h>
+#include <stdint.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "jobarena.h"
+
+#define THREAD_CHUNK_SIZE (256 * 1024)
+
+/********** Chunk ********
+ *
+ * One block of memory obtained from the system.
+ *
+ * Elements:
+ *      struct Chunk *next:   The next chunk in the arena.
+ *      size_t size:          The number of usable bytes after the header.
+ ************************/
+typedef struct Chunk
+{
+        struct Chunk *next;
+        size_t size;
+} *Chunk;
+
+/********** JobArena_T ********
+ *
+ * Elements:
+ *      Chunk first:          The first chunk, or NULL.
+ *      Chunk current:        The chunk being bumped through.
+ *      uintptr_t cursor:     The next free byte in current.
+ *      uintptr_t limit:      One past the last byte of current.
+ *      size_t chunk_size:    The default size of a new chunk.
+ *      size_t chunks:        Chunks requested from the system so far.
+ ************************/
+struct JobArena_T
+{
+        Chunk first;
+        Chunk current;
+        uintptr_t cursor;
+        uintptr_t limit;
+        size_t chunk_size;
+        size_t chunks;
+};
+
+static pthread_key_t thread_key;
+static pthread_once_t thread_key_once = PTHREAD_ONCE_INIT;
+static __thread JobArena_T thread_arena = NULL;
+
+/********** chunk_start ********
+ *
+ * Gets the first usable byte of a chunk.
+ ************************/
+static uintptr_t chunk_start(Chunk chunk)
+{
+        return (uintptr_t)(chunk + 1);
+}
+
+/********** JobArena_new ********
+ *
+ * Creates an empty arena.
+ *
+ * Parameters:
+ *      size_t chunk_size:  The size in bytes of each chunk requested from
+ *                          the system. Larger allocations get a chunk of
+ *                          their own.
+ *
+ * Return:
+ *      JobArena_T:         A new arena.
+ *
+ * Expects:
+ *      chunk_size must be greater than 0.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated or allocation fails.
+ *      Client is responsible for freeing the arena with JobArena_free.
+ ************************/
+JobArena_T JobArena_new(size_t chunk_size)
+{
+        assert(chunk_size > 0);
+
+        JobArena_T arena;
+        NEW(arena);
+        arena->first = NULL;
+        arena->current = NULL;
+        arena->cursor = 0;
+        arena->limit = 0;
+        arena->chunk_size = chunk_size;
+        arena->chunks = 0;
+        return arena;
+}
+
+/********** advance ********
+ *
+ * Moves the arena on to a chunk with room for an allocation, reusing the
+ * chunks after the current one before asking the system for a new one.
+ *
+ * Parameters:
+ *      JobArena_T arena:   The arena.
+ *      size_t nbytes:      The size of the allocation.
+ *      size_t align:       The alignment of the allocation.
+ ************************/
+static void advance(JobArena_T arena, size_t nbytes, size_t align)
+{
+        size_t need = nbytes + align;
+        Chunk prev = arena->current;
+        Chunk next = prev == NULL ? arena->first : prev->next;
+
+        /* A chunk too small for this allocation is skipped, not lost */
+        while (next != NULL && next->size < need)
+        {
+                prev = next;
+                next = next->next;
+        }
+
+        if (next == NULL)
+        {
+                size_t size = need > arena->chunk_size ? need
+                                                       : arena->chunk_size;
+                next = ALLOC(sizeof(*next) + size);
+                next->size = size;
+                next->next = NULL;
+                if (prev == NULL)
+                {
+                        arena->first = next;
+                }
+                else
+                {
+                        prev->next = next;
+                }
+                arena->chunks++;
+        }
+
+        arena->current = next;
+        arena->cursor = chunk_start(next);
+        arena->limit = arena->cursor + next->size;
+}
+
+/********** JobArena_alloc_aligned ********
+ *
+ * Allocates memory with a given alignment.
+ *
+ * Parameters:
+ *      JobArena_T arena:   The arena to allocate from.
+ *      size_t nbytes:      The number of bytes wanted.
+ *      size_t align:       The alignment wanted.
+ *
+ * Return:
+ *      void *:             The memory, valid until the arena is reset or
+ *                          freed. Not zeroed.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *      align must be a power of two.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated or allocation fails.
+ ************************/
+void *JobArena_alloc_aligned(JobArena_T arena, size_t nbytes, size_t align)
+{
+        assert(arena != NULL);
+        assert(align > 0 && (align & (align - 1)) == 0);
+
+        uintptr_t p = (arena->cursor + align - 1) & ~(uintptr_t)(align - 1);
+        if (arena->current == NULL || p + nbytes > arena->limit)
+        {
+                advance(arena, nbytes, align);
+                p = (arena->cursor + align - 1) & ~(uintptr_t)(align - 1);
+        }
+        arena->cursor = p + nbytes;
+        return (void *)p;
+}
+
+/********** JobArena_alloc ********
+ *
+ * Allocates memory aligned to JOBARENA_ALIGN bytes.
+ *
+ * Parameters:
+ *      JobArena_T arena:   The arena to allocate from.
+ *      size_t nbytes:      The number of bytes wanted.
+ *
+ * Return:
+ *      void *:             The memory, valid until the arena is reset or
+ *                          freed. Not zeroed.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated or allocation fails.
+ ************************/
+void *JobArena_alloc(JobArena_T arena, size_t nbytes)
+{
+        return JobArena_alloc_aligned(arena, nbytes, JOBARENA_ALIGN);
+}
+
+/********** JobArena_reset ********
+ *
+ * Releases everything allocated from the arena at once. The chunks are
+ * kept and reused by later allocations.
+ *
+ * Parameters:
+ *      JobArena_T arena:   The arena to reset.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void JobArena_reset(JobArena_T arena)
+{
+        assert(arena != NULL);
+
+        arena->current = arena->first;
+        if (arena->first != NULL)
+        {
+                arena->cursor = chunk_start(arena->first);
+                arena->limit = arena->cursor + arena->first->size;
+        }
+}
+
+/********** JobArena_trim ********
+ *
+ * Resets the arena like JobArena_reset, but keeps only the chunks that
+ * fit in a byte budget and frees the rest, so that one very large job
+ * does not leave its scratch held for good.
+ *
+ * Parameters:
+ *      JobArena_T arena:   The arena to trim.
+ *      size_t keep:        The most chunk bytes to keep. Chunks are kept
+ *                          in order until the next one would exceed it.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void JobArena_trim(JobArena_T arena, size_t keep)
+{
+        assert(arena != NULL);
+
+        Chunk *link = &arena->first;
+        size_t kept = 0;
+        while (*link != NULL && kept + (*link)->size <= keep)
+        {
+                kept += (*link)->size;
+                link = &(*link)->next;
+        }
+
+        Chunk chunk = *link;
+        *link = NULL;
+        while (chunk != NULL)
+        {
+                Chunk next = chunk->next;
+                FREE(chunk);
+                chunk = next;
+        }
+        JobArena_reset(arena);
+}
+
+/********** JobArena_chunks ********
+ *
+ * Gets the number of chunks the arena has requested from the system
+ * since it was created.
+ *
+ * Parameters:
+ *      JobArena_T arena:   The arena to query.
+ *
+ * Return:
+ *      size_t:             The number of chunk allocations.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+size_t JobArena_chunks(JobArena_T arena)
+{
+        assert(arena != NULL);
+        return arena->chunks;
+}
+
+/********** JobArena_free ********
+ *
+ * Frees an arena and all of its chunks.
+ *
+ * Parameters:
+ *      JobArena_T *arena:  A pointer to the arena to be freed.
+ *
+ * Expects:
+ *      arena and *arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      The pointer *arena will be set to NULL after freeing.
+ ************************/
+void JobArena_free(JobArena_T *arena)
+{
+        assert(arena != NULL);
+        assert(*arena != NULL);
+
+        Chunk chunk = (*arena)->first;
+        while (chunk != NULL)
+        {
+                Chunk next = chunk->next;
+                FREE(chunk);
+                chunk = next;
+        }
+        FREE(*arena);
+}
+
+/********** free_thread_arena ********
+ *
+ * Thread-exit destructor for the arena made by JobArena_thread.
+ ************************/
+static void free_thread_arena(void *arena)
+{
+        JobArena_T a = arena;
+        JobArena_free(&a);
+}
+
+/********** make_thread_key ********
+ *
+ * Creates the key whose destructor frees each thread's arena.
+ ************************/
+static void make_thread_key(void)
+{
+        pthread_key_create(&thread_key, free_thread_arena);
+}
+
+/********** JobArena_thread ********
+ *
+ * Gets the calling thread's own arena, creating it on first use. It is
+ * freed automatically when the thread exits.
+ *
+ * Return:
+ *      JobArena_T:         The calling thread's arena.
+ *
+ * Notes:
+ *      Will CRE if allocation fails.
+ *      Client must not free the returned arena.
+ ************************/
+JobArena_T JobArena_thread(void)
+{
+        if (thread_arena == NULL)
+        {
+                pthread_once(&thread_key_once, make_thread_key);
+                thread_arena = JobArena_new(THREAD_CHUNK_SIZE);
+                pthread_setspecific(thread_key, thread_arena);
+        }
+        return thread_arena;
+}
+
+/********** JobArena_thread_release ********
+ *
+ * Frees the calling thread's arena, if it has one, so that the memory
+ * it holds goes back to the system. The next JobArena_thread call makes
+ * a new one.
+ *
+ * Notes:
+ *      Nothing allocated from the thread's arena may be used afterwards.
+ ************************/
+void JobArena_thread_release(void)
+{
+        if (thread_arena != NULL)
+        {
+                pthread_setspecific(thread_key, NULL);
+                JobArena_free(&thread_arena);
+        }
+}
@@ -0,0 +1,197 @@
+/**************************************************************
+ *
+ *                     jobarena.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for a bump allocator that owns the
+ *     scratch memory of one coding job. Allocations are never freed one
+ *     at a time; JobArena_reset rewinds the whole arena, keeping its
+ *     chunks, so a worker that codes image after image stops calling the
+ *     system allocator after the first one.
+ *
+ *     CII's Arena is not used because its free-chunk list is shared by
+ *     every arena without locking, and it cannot hand out 64-byte aligned
+ *     memory.
+ *
+ ************************/
+
+#ifndef JOBARENA_H
+#define JOBARENA_H
+
+#include <stddef.h>
+
+/********** JobArena_T ********
+ *
+ * An opaque handle to a bump allocator.
+ ************************/
+typedef struct JobArena_T *JobArena_T;
+
+/* The alignment of JobArena_alloc, enough for any scalar type */
+#define JOBARENA_ALIGN 16
+
+/* Allocates one object for pointer p, like NEW in mem.h */
+#define JOBARENA_NEW(arena, p) \
+        ((p) = JobArena_alloc((arena), sizeof *(p)))
+
+/********** JobArena_new ********
+ *
+ * Creates an empty arena.
+ *
+ * Parameters:
+ *      size_t chunk_size:  The size in bytes of each chunk requested from
+ *                          the system. Larger allocations get a chunk of
+ *                          their own.
+ *
+ * Return:
+ *      JobArena_T:         A new arena.
+ *
+ * Expects:
+ *      chunk_size must be greater than 0.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated or allocation fails.
+ *      Client is responsible for freeing the arena with JobArena_free.
+ ************************/
+JobArena_T JobArena_new(size_t chunk_size);
+
+/********** JobArena_alloc ********
+ *
+ * Allocates memory aligned to JOBARENA_ALIGN bytes.
+ *
+ * Parameters:
+ *      JobArena_T arena:   The arena to allocate from.
+ *      size_t nbytes:      The number of bytes wanted.
+ *
+ * Return:
+ *      void *:             The memory, valid until the arena is reset or
+ *                          freed. Not zeroed.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated or allocation fails.
+ ************************/
+void *JobArena_alloc(JobArena_T arena, size_t nbytes);
+
+/********** JobArena_alloc_aligned ********
+ *
+ * Allocates memory with a given alignment.
+ *
+ * Parameters:
+ *      JobArena_T arena:   The arena to allocate from.
+ *      size_t nbytes:      The number of bytes wanted.
+ *      size_t align:       The alignment wanted.
+ *
+ * Return:
+ *      void *:             The memory, valid until the arena is reset or
+ *                          freed. Not zeroed.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *      align must be a power of two.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated or allocation fails.
+ ************************/
+void *JobArena_alloc_aligned(JobArena_T arena, size_t nbytes, size_t align);
+
+/********** JobArena_reset ********
+ *
+ * Releases everything allocated from the arena at once. The chunks are
+ * kept and reused by later allocations.
+ *
+ * Parameters:
+ *      JobArena_T arena:   The arena to reset.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void JobArena_reset(JobArena_T arena);
+
+/********** JobArena_trim ********
+ *
+ * Resets the arena like JobArena_reset, but keeps only the chunks that
+ * fit in a byte budget and frees the rest, so that one very large job
+ * does not leave its scratch held for good.
+ *
+ * Parameters:
+ *      JobArena_T arena:   The arena to trim.
+ *      size_t keep:        The most chunk bytes to keep. Chunks are kept
+ *                          in order until the next one would exceed it.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void JobArena_trim(JobArena_T arena, size_t keep);
+
+/********** JobArena_chunks ********
+ *
+ * Gets the number of chunks the arena has requested from the system
+ * since it was created.
+ *
+ * Parameters:
+ *      JobArena_T arena:   The arena to query.
+ *
+ * Return:
+ *      size_t:             The number of chunk allocations.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+size_t JobArena_chunks(JobArena_T arena);
+
+/********** JobArena_free ********
+ *
+ * Frees an arena and all of its chunks.
+ *
+ * Parameters:
+ *      JobArena_T *arena:  A pointer to the arena to be freed.
+ *
+ * Expects:
+ *      arena and *arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      The pointer *arena will be set to NULL after freeing.
+ ************************/
+void JobArena_free(JobArena_T *arena);
+
+/********** JobArena_thread ********
+ *
+ * Gets the calling thread's own arena, creating it on first use. It is
+ * freed automatically when the thread exits.
+ *
+ * Return:
+ *      JobArena_T:         The calling thread's arena.
+ *
+ * Notes:
+ *      Will CRE if allocation fails.
+ *      Client must not free the returned arena.
+ ************************/
+JobArena_T JobArena_thread(void);
+
+/********** JobArena_thread_release ********
+ *
+ * Frees the calling thread's arena, if it has one, so that the memory
+ * it holds goes back to the system. The next JobArena_thread call makes
+ * a new one.
+ *
+ * Notes:
+ *      Nothing allocated from the thread's arena may be used afterwards.
+ ************************/
+void JobArena_thread_release(void);
+
+#endif
@@ -0,0 +1,922 @@
+/**************************************************************
+ *
+ *                     kerneldiff.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     A differential harness for the kernel variants in kernels.c. Every
+ *     kernel a variant overrides is run, side by side with the reference
+ *     kernel, on the same randomized inputs; so is the whole decode path
+ *     (unpack, dequantize, invert DCT, CAV to RGB) whenever a variant
+ *     overrides any part of it. The batch kernels run on whole batches
+ *     of cases gathered into arrays, and a frame column of one block per
+ *     case. For each stage it reports the number of cases whose results
+ *     differ in any bit, the largest error in each output channel, and
+ *     the throughput of both kernels.
+ *
+ *     With -x, the stages whose input is a codeword (pack, unpack, decode
+ *     and their batch forms) instead run on all 2^32 codewords. Decode
+ *     skips codewords whose b, c or d is -16, which the encoder never
+ *     writes.
+ *
+ *     Usage: kerneldiff [-n cases] [-s seed] [-x] [-a] [variant ...]
+ *            -a also checks the kernels a variant takes from the
+ *               reference, so "kerneldiff -a reference" checks the
+ *               harness itself.
+ *            With no variants, every registered variant this CPU can
+ *            run is checked; naming one it cannot run is an error.
+ *            Exits 1 if any result differs.
+ *
+ ************************/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "pnm.h"
+#include "kernels.h"
+#include "timer.h"
+
+#define BATCH 4096
+#define MAX_VALUES 12
+#define MAX_REPORTED 5
+
+/* Stage.kernel for the decode path, which uses four kernels */
+#define DECODE ((size_t)-1)
+
+/********** Case ********
+ *
+ * The input of one test case and the output of both kernels. Index 0 of
+ * each output is the reference's, index 1 the variant's.
+ *
+ * Elements:
+ *      int denominator:                The RGB maxval.
+ *      struct Pnm_rgb rgb_in[4]:       Input pixels.
+ *      struct CAV cav_in[4]:           Input component video.
+ *      struct DCT dct_in:              Input coefficients.
+ *      struct Quantized q_in:          Input quantized values.
+ *      uint32_t word_in:               Input codeword.
+ *      int skipped:                    Nonzero if the case was not run.
+ *      struct Pnm_rgb rgb_out[2][4]:   Output pixels.
+ *      struct CAV cav_out[2][4]:       Output component video.
+ *      struct DCT dct_out[2]:          Output coefficients.
+ *      struct Quantized q_out[2]:      Output quantized values.
+ *      uint32_t word_out[2]:           Output codeword.
+ *      struct RGB_block rgb_in_block:  Points into rgb_in.
+ *      struct CAV_block cav_in_block:  Points into cav_in.
+ *      struct RGB_block rgb_out_block[2]:  Point into rgb_out.
+ *      struct CAV_block cav_out_block[2]:  Point into cav_out.
+ ************************/
+typedef struct Case
+{
+        int denominator;
+        struct Pnm_rgb rgb_in[4];
+        struct CAV cav_in[4];
+        struct DCT dct_in;
+        struct Quantized q_in;
+        uint32_t word_in;
+        int skipped;
+
+        struct Pnm_rgb rgb_out[2][4];
+        struct CAV cav_out[2][4];
+        struct DCT dct_out[2];
+        struct Quantized q_out[2];
+        uint32_t word_out[2];
+
+        struct RGB_block rgb_in_block;
+        struct CAV_block cav_in_block;
+        struct RGB_block rgb_out_block[2];
+        struct CAV_block cav_out_block[2];
+} Case;
+
+/********** Stage ********
+ *
+ * One thing that can be checked.
+ *
+ * Elements:
+ *      const char *name:       The name printed in the report.
+ *      size_t kernel:          offsetof the kernel in struct Kernels, or
+ *                              DECODE.
+ *      int exhaustive:         Nonzero if -x runs it on every codeword.
+ *      int nchannels:          The number of output channels.
+ *      const char *channels[]: Their names. Output value v is in channel
+ *                              v % nchannels.
+ *      int nvalues:            The number of output values per case.
+ *      generate:               Fills in case c's input; index is the
+ *                              codeword when running exhaustively, and
+ *                              otherwise the case number.
+ *      gather:                 For batch kernels, copies the inputs of n
+ *                              cases into the batch arrays; else NULL.
+ *      run:                    Runs kernel set k on n cases, storing
+ *                              output number which.
+ *      scatter:                For batch kernels, copies output number
+ *                              which back into the n cases; else NULL.
+ *      values:                 Gets output number which as doubles.
+ *      describe:               Prints the input of case c.
+ ************************/
+typedef struct Stage
+{
+        const char *name;
+        size_t kernel;
+        int exhaustive;
+        int nchannels;
+        const char *channels[6];
+        int nvalues;
+        void (*generate)(Case *c, uint64_t *rng, uint64_t index,
+                         int exhaustive);
+        void (*gather)(Case *cases, int n);
+        void (*run)(Kernels k, Case *cases, int n, int which);
+        void (*scatter)(Case *cases, int n, int which);
+        void (*values)(Case *c, int which, double *out);
+        void (*describe)(Case *c, FILE *out);
+} Stage;
+
+/* Inputs and both outputs of the batch kernels; case i's pixels or
+ * samples are at 4 * i through 4 * i + 3 */
+static struct Pnm_rgb batch_rgb_in[4 * BATCH];
+static struct Pnm_rgb batch_rgb_out[2][4 * BATCH];
+static float batch_planes_in[3][4 * BATCH];
+static float batch_planes_out[2][3][4 * BATCH];
+static struct Quantized batch_q_in[BATCH];
+static struct Quantized batch_q_out[2][BATCH];
+static uint32_t batch_words_in[BATCH];
+static uint32_t batch_words_out[2][BATCH];
+
+/********** next ********
+ *
+ * Advances a splitmix64 generator.
+ ************************/
+static uint64_t next(uint64_t *rng)
+{
+        uint64_t x = (*rng += 0x9e3779b97f4a7c15ULL);
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+}
+
+/********** uniform ********
+ *
+ * Gets a random float in [lo, hi).
+ ************************/
+static float uniform(uint64_t *rng, float lo, float hi)
+{
+        return lo + (hi - lo) * (float)((next(rng) >> 40) / 16777216.0);
+}
+
+/* Input generators; the ranges go a little past the valid ones so that
+ * the clamps are exercised too */
+
+static void gen_rgb(Case *c, uint64_t *rng, uint64_t index, int exhaustive)
+{
+        static const int DENOMINATORS[] = {255, 1023, 65535};
+        (void)index;
+        (void)exhaustive;
+        uint64_t r = next(rng);
+        c->denominator = r & 1 ? DENOMINATORS[(r >> 1) % 3]
+                               : (int)((r >> 1) % 65535) + 1;
+        for (int i = 0; i < 4; i++)
+        {
+                c->rgb_in[i].red = next(rng) % (c->denominator + 1);
+                c->rgb_in[i].green = next(rng) % (c->denominator + 1);
+                c->rgb_in[i].blue = next(rng) % (c->denominator + 1);
+        }
+}
+
+static void gen_cav(Case *c, uint64_t *rng, uint64_t index, int exhaustive)
+{
+        (void)index;
+        (void)exhaustive;
+        c->denominator = next(rng) & 1 ? 255 : 65535;
+        for (int i = 0; i < 4; i++)
+        {
+                c->cav_in[i].Y = uniform(rng, -0.1, 1.1);
+                c->cav_in[i].P_b = uniform(rng, -0.6, 0.6);
+                c->cav_in[i].P_r = uniform(rng, -0.6, 0.6);
+        }
+}
+
+static void gen_dct(Case *c, uint64_t *rng, uint64_t index, int exhaustive)
+{
+        (void)index;
+        (void)exhaustive;
+        c->dct_in.a = uniform(rng, -0.1, 1.1);
+        c->dct_in.b = uniform(rng, -0.4, 0.4);
+        c->dct_in.c = uniform(rng, -0.4, 0.4);
+        c->dct_in.d = uniform(rng, -0.4, 0.4);
+        c->dct_in.Pbar_b = uniform(rng, -0.6, 0.6);
+        c->dct_in.Pbar_r = uniform(rng, -0.6, 0.6);
+}
+
+/********** row_denominator ********
+ *
+ * The row kernels take one maxval per call, so every case of a batch
+ * shares one: 255, 1023, 65535 or some other, in turn.
+ ************************/
+static int row_denominator(uint64_t index)
+{
+        static const int DENOMINATORS[] = {255, 1023, 65535};
+        uint64_t batch = index / BATCH;
+        return batch % 4 < 3 ? DENOMINATORS[batch % 4]
+                             : (int)(batch * 7919 % 65535) + 1;
+}
+
+static void gen_rgb_row(Case *c, uint64_t *rng, uint64_t index,
+                        int exhaustive)
+{
+        gen_rgb(c, rng, index, exhaustive);
+        c->denominator = row_denominator(index);
+        for (int i = 0; i < 4; i++)
+        {
+                c->rgb_in[i].red %= c->denominator + 1;
+                c->rgb_in[i].green %= c->denominator + 1;
+                c->rgb_in[i].blue %= c->denominator + 1;
+        }
+}
+
+static void gen_cav_row(Case *c, uint64_t *rng, uint64_t index,
+                        int exhaustive)
+{
+        gen_cav(c, rng, index, exhaustive);
+        c->denominator = row_denominator(index);
+}
+
+/********** gen_quantized ********
+ *
+ * Random valid quantized values, or exhaustively the fields of codeword
+ * index (so b, c and d may be -16).
+ ************************/
+static void gen_quantized(Case *c, uint64_t *rng, uint64_t index,
+                          int exhaustive)
+{
+        if (exhaustive)
+        {
+                c->q_in.a = index >> 23;
+                c->q_in.b = (int)((index >> 18) & 31) - 16;
+                c->q_in.c = (int)((index >> 13) & 31) - 16;
+                c->q_in.d = (int)((index >> 8) & 31) - 16;
+                c->q_in.Pbar_b = (index >> 4) & 15;
+                c->q_in.Pbar_r = index & 15;
+                return;
+        }
+        uint64_t r = next(rng);
+        c->q_in.a = r % 512;
+        c->q_in.b = (int)((r >> 9) % 31) - 15;
+        c->q_in.c = (int)((r >> 14) % 31) - 15;
+        c->q_in.d = (int)((r >> 19) % 31) - 15;
+        c->q_in.Pbar_b = (r >> 24) % 16;
+        c->q_in.Pbar_r = (r >> 28) % 16;
+}
+
+static void gen_word(Case *c, uint64_t *rng, uint64_t index, int exhaustive)
+{
+        c->word_in = exhaustive ? (uint32_t)index : (uint32_t)next(rng);
+}
+
+/* Runners */
+
+static void run_rgb_to_cav(Kernels k, Case *cases, int n, int which)
+{
+        for (int i = 0; i < n; i++)
+        {
+                k->rgb_to_cav(&cases[i].cav_out_block[which],
+                              &cases[i].rgb_in_block, cases[i].denominator);
+        }
+}
+
+static void run_cav_to_rgb(Kernels k, Case *cases, int n, int which)
+{
+        for (int i = 0; i < n; i++)
+        {
+                k->cav_to_rgb(&cases[i].rgb_out_block[which],
+                              &cases[i].cav_in_block, cases[i].denominator);
+        }
+}
+
+static void run_compute_dct(Kernels k, Case *cases, int n, int which)
+{
+        for (int i = 0; i < n; i++)
+        {
+                k->compute_dct(&cases[i].dct_out[which],
+                               &cases[i].cav_in_block);
+        }
+}
+
+static void run_invert_dct(Kernels k, Case *cases, int n, int which)
+{
+        for (int i = 0; i < n; i++)
+        {
+                k->invert_dct(&cases[i].cav_out_block[which],
+                              &cases[i].dct_in);
+        }
+}
+
+static void run_quantize(Kernels k, Case *cases, int n, int which)
+{
+        for (int i = 0; i < n; i++)
+        {
+                k->quantize(&cases[i].q_out[which], &cases[i].dct_in);
+        }
+}
+
+static void run_dequantize(Kernels k, Case *cases, int n, int which)
+{
+        for (int i = 0; i < n; i++)
+        {
+                k->dequantize(&cases[i].dct_out[which], &cases[i].q_in);
+        }
+}
+
+static void run_pack(Kernels k, Case *cases, int n, int which)
+{
+        for (int i = 0; i < n; i++)
+        {
+                cases[i].word_out[which] = k->pack(&cases[i].q_in);
+        }
+}
+
+static void run_unpack(Kernels k, Case *cases, int n, int which)
+{
+        for (int i = 0; i < n; i++)
+        {
+                k->unpack(&cases[i].q_out[which], cases[i].word_in);
+        }
+}
+
+/********** run_decode ********
+ *
+ * Decodes each codeword to four pixels of maxval 255, skipping codewords
+ * that dequantize would reject.
+ ************************/
+static void run_decode(Kernels k, Case *cases, int n, int which)
+{
+        for (int i = 0; i < n; i++)
+        {
+                Case *c = &cases[i];
+                Quantized q = &c->q_out[which];
+
+                k->unpack(q, c->word_in);
+                c->skipped = q->b < -15 || q->c < -15 || q->d < -15;
+                if (c->skipped)
+                {
+                        continue;
+                }
+                k->dequantize(&c->dct_out[which], q);
+                k->invert_dct(&c->cav_out_block[which], &c->dct_out[which]);
+                k->cav_to_rgb(&c->rgb_out_block[which],
+                              &c->cav_out_block[which], 255);
+        }
+}
+
+/* Batch gatherers, runners and scatterers */
+
+/********** column_frame ********
+ *
+ * Makes a frame 2 samples wide of n blocks, one per case, on planes.
+ ************************/
+static struct Frame column_frame(float planes[3][4 * BATCH], int n)
+{
+        struct Frame frame = {2, 2 * n, 2, planes[0], planes[1], planes[2]};
+        return frame;
+}
+
+static void gather_rgb(Case *cases, int n)
+{
+        for (int i = 0; i < n; i++)
+        {
+                memcpy(&batch_rgb_in[4 * i], cases[i].rgb_in,
+                       sizeof(cases[i].rgb_in));
+        }
+}
+
+static void gather_cav(Case *cases, int n)
+{
+        for (int i = 0; i < n; i++)
+        {
+                for (int k = 0; k < 4; k++)
+                {
+                        batch_planes_in[0][4 * i + k] = cases[i].cav_in[k].Y;
+                        batch_planes_in[1][4 * i + k] = cases[i].cav_in[k].P_b;
+                        batch_planes_in[2][4 * i + k] = cases[i].cav_in[k].P_r;
+                }
+        }
+}
+
+static void gather_quantized(Case *cases, int n)
+{
+        for (int i = 0; i < n; i++)
+        {
+                batch_q_in[i] = cases[i].q_in;
+        }
+}
+
+static void gather_words(Case *cases, int n)
+{
+        for (int i = 0; i < n; i++)
+        {
+                batch_words_in[i] = cases[i].word_in;
+        }
+}
+
+/********** gather_decodable ********
+ *
+ * Gathers codewords, skipping (and replacing with 0) those that
+ * dequantize would reject.
+ ************************/
+static void gather_decodable(Case *cases, int n)
+{
+        for (int i = 0; i < n; i++)
+        {
+                uint32_t word = cases[i].word_in;
+                cases[i].skipped = ((word >> 18) & 31) == 16 ||
+                                   ((word >> 13) & 31) == 16 ||
+                                   ((word >> 8) & 31) == 16;
+                batch_words_in[i] = cases[i].skipped ? 0 : word;
+        }
+}
+
+static void run_rgb_to_frame(Kernels k, Case *cases, int n, int which)
+{
+        float (*out)[4 * BATCH] = batch_planes_out[which];
+        k->rgb_to_frame(out[0], out[1], out[2], batch_rgb_in, 4 * n,
+                        cases[0].denominator);
+}
+
+static void run_frame_to_rgb(Kernels k, Case *cases, int n, int which)
+{
+        k->frame_to_rgb(batch_rgb_out[which], batch_planes_in[0],
+                        batch_planes_in[1], batch_planes_in[2], 4 * n,
+                        cases[0].denominator);
+}
+
+static void run_encode_blocks(Kernels k, Case *cases, int n, int which)
+{
+        (void)cases;
+        struct Frame frame = column_frame(batch_planes_in, n);
+        k->encode_blocks(batch_words_out[which], &frame, 0, n);
+}
+
+static void run_decode_blocks(Kernels k, Case *cases, int n, int which)
+{
+        (void)cases;
+        struct Frame frame = column_frame(batch_planes_out[which], n);
+        k->decode_blocks(&frame, batch_words_in, 0, n);
+}
+
+static void run_pack_batch(Kernels k, Case *cases, int n, int which)
+{
+        (void)cases;
+        k->pack_batch(batch_words_out[which], batch_q_in, n);
+}
+
+static void run_unpack_batch(Kernels k, Case *cases, int n, int which)
+{
+        (void)cases;
+        k->unpack_batch(batch_q_out[which], batch_words_in, n);
+}
+
+static void scatter_rgb(Case *cases, int n, int which)
+{
+        for (int i = 0; i < n; i++)
+        {
+                memcpy(cases[i].rgb_out[which], &batch_rgb_out[which][4 * i],
+                       sizeof(cases[i].rgb_out[which]));
+        }
+}
+
+static void scatter_planes(Case *cases, int n, int which)
+{
+        float (*out)[4 * BATCH] = batch_planes_out[which];
+        for (int i = 0; i < n; i++)
+        {
+                for (int k = 0; k < 4; k++)
+                {
+                        cases[i].cav_out[which][k].Y = out[0][4 * i + k];
+                        cases[i].cav_out[which][k].P_b = out[1][4 * i + k];
+                        cases[i].cav_out[which][k].P_r = out[2][4 * i + k];
+                }
+        }
+}
+
+static void scatter_words(Case *cases, int n, int which)
+{
+        for (int i = 0; i < n; i++)
+        {
+                cases[i].word_out[which] = batch_words_out[which][i];
+        }
+}
+
+static void scatter_quantized(Case *cases, int n, int which)
+{
+        for (int i = 0; i < n; i++)
+        {
+                cases[i].q_out[which] = batch_q_out[which][i];
+        }
+}
+
+/* Output values */
+
+static void values_rgb(Case *c, int which, double *out)
+{
+        for (int i = 0; i < 4; i++)
+        {
+                out[3 * i] = c->rgb_out[which][i].red;
+                out[3 * i + 1] = c->rgb_out[which][i].green;
+                out[3 * i + 2] = c->rgb_out[which][i].blue;
+        }
+}
+
+static void values_cav(Case *c, int which, double *out)
+{
+        for (int i = 0; i < 4; i++)
+        {
+                out[3 * i] = c->cav_out[which][i].Y;
+                out[3 * i + 1] = c->cav_out[which][i].P_b;
+                out[3 * i + 2] = c->cav_out[which][i].P_r;
+        }
+}
+
+static void values_dct(Case *c, int which, double *out)
+{
+        DCT dct = &c->dct_out[which];
+        out[0] = dct->a;
+        out[1] = dct->b;
+        out[2] = dct->c;
+        out[3] = dct->d;
+        out[4] = dct->Pbar_b;
+        out[5] = dct->Pbar_r;
+}
+
+static void values_quantized(Case *c, int which, double *out)
+{
+        Quantized q = &c->q_out[which];
+        out[0] = q->a;
+        out[1] = q->b;
+        out[2] = q->c;
+        out[3] = q->d;
+        out[4] = q->Pbar_b;
+        out[5] = q->Pbar_r;
+}
+
+static void values_word(Case *c, int which, double *out)
+{
+        out[0] = c->word_out[which];
+}
+
+/* Input descriptions, for reporting mismatches */
+
+static void describe_rgb(Case *c, FILE *out)
+{
+        fprintf(out, "maxval %d, rgb", c->denominator);
+        for (int i = 0; i < 4; i++)
+        {
+                fprintf(out, " (%u %u %u)", c->rgb_in[i].red,
+                        c->rgb_in[i].green, c->rgb_in[i].blue);
+        }
+}
+
+static void describe_cav(Case *c, FILE *out)
+{
+        fprintf(out, "maxval %d, cav", c->denominator);
+        for (int i = 0; i < 4; i++)
+        {
+                fprintf(out, " (%.9g %.9g %.9g)", c->cav_in[i].Y,
+                        c->cav_in[i].P_b, c->cav_in[i].P_r);
+        }
+}
+
+static void describe_dct(Case *c, FILE *out)
+{
+        fprintf(out, "dct (%.9g %.9g %.9g %.9g %.9g %.9g)", c->dct_in.a,
+                c->dct_in.b, c->dct_in.c, c->dct_in.d, c->dct_in.Pbar_b,
+                c->dct_in.Pbar_r);
+}
+
+static void describe_quantized(Case *c, FILE *out)
+{
+        fprintf(out, "quantized (%u %d %d %d %u %u)", c->q_in.a, c->q_in.b,
+                c->q_in.c, c->q_in.d, c->q_in.Pbar_b, c->q_in.Pbar_r);
+}
+
+static void describe_word(Case *c, FILE *out)
+{
+        fprintf(out, "codeword 0x%08x", (unsigned)c->word_in);
+}
+
+static const Stage STAGES[] = {
+        {"rgb_to_cav", offsetof(struct Kernels, rgb_to_cav), 0,
+         3, {"Y", "Pb", "Pr"}, 12,
+         gen_rgb, NULL, run_rgb_to_cav, NULL, values_cav, describe_rgb},
+        {"cav_to_rgb", offsetof(struct Kernels, cav_to_rgb), 0,
+         3, {"r", "g", "b"}, 12,
+         gen_cav, NULL, run_cav_to_rgb, NULL, values_rgb, describe_cav},
+        {"compute_dct", offsetof(struct Kernels, compute_dct), 0,
+         6, {"a", "b", "c", "d", "Pb", "Pr"}, 6,
+         gen_cav, NULL, run_compute_dct, NULL, values_dct, describe_cav},
+        {"invert_dct", offsetof(struct Kernels, invert_dct), 0,
+         3, {"Y", "Pb", "Pr"}, 12,
+         gen_dct, NULL, run_invert_dct, NULL, values_cav, describe_dct},
+        {"quantize", offsetof(struct Kernels, quantize), 0,
+         6, {"a", "b", "c", "d", "Pb", "Pr"}, 6,
+         gen_dct, NULL, run_quantize, NULL, values_quantized, describe_dct},
+        {"dequantize", offsetof(struct Kernels, dequantize), 0,
+         6, {"a", "b", "c", "d", "Pb", "Pr"}, 6,
+         gen_quantized, NULL, run_dequantize, NULL, values_dct,
+         describe_quantized},
+        {"pack", offsetof(struct Kernels, pack), 1,
+         1, {"word"}, 1,
+         gen_quantized, NULL, run_pack, NULL, values_word,
+         describe_quantized},
+        {"unpack", offsetof(struct Kernels, unpack), 1,
+         6, {"a", "b", "c", "d", "Pb", "Pr"}, 6,
+         gen_word, NULL, run_unpack, NULL, values_quantized, describe_word},
+        {"decode", DECODE, 1,
+         3, {"r", "g", "b"}, 12,
+         gen_word, NULL, run_decode, NULL, values_rgb, describe_word},
+        {"rgb_to_frame", offsetof(struct Kernels, rgb_to_frame), 0,
+         3, {"Y", "Pb", "Pr"}, 12,
+         gen_rgb_row, gather_rgb, run_rgb_to_frame, scatter_planes,
+         values_cav, describe_rgb},
+        {"frame_to_rgb", offsetof(struct Kernels, frame_to_rgb), 0,
+         3, {"r", "g", "b"}, 12,
+         gen_cav_row, gather_cav, run_frame_to_rgb, scatter_rgb,
+         values_rgb, describe_cav},
+        {"encode_blocks", offsetof(struct Kernels, encode_blocks), 0,
+         1, {"word"}, 1,
+         gen_cav, gather_cav, run_encode_blocks, scatter_words,
+         values_word, describe_cav},
+        {"decode_blocks", offsetof(struct Kernels, decode_blocks), 1,
+         3, {"Y", "Pb", "Pr"}, 12,
+         gen_word, gather_decodable, run_decode_blocks, scatter_planes,
+         values_cav, describe_word},
+        {"pack_batch", offsetof(struct Kernels, pack_batch), 1,
+         1, {"word"}, 1,
+         gen_quantized, gather_quantized, run_pack_batch, scatter_words,
+         values_word, describe_quantized},
+        {"unpack_batch", offsetof(struct Kernels, unpack_batch), 1,
+         6, {"a", "b", "c", "d", "Pb", "Pr"}, 6,
+         gen_word, gather_words, run_unpack_batch, scatter_quantized,
+         values_quantized, describe_word},
+};
+
+#define NUM_STAGES (sizeof(STAGES) / sizeof(STAGES[0]))
+
+/********** stage_applies ********
+ *
+ * Tells whether variant v has its own version of any kernel the stage
+ * uses.
+ ************************/
+static int stage_applies(const Stage *stage, int v)
+{
+        if (stage->kernel != DECODE)
+        {
+                return Kernels_overrides(v, stage->kernel);
+        }
+        return Kernels_overrides(v, offsetof(struct Kernels, unpack)) ||
+               Kernels_overrides(v, offsetof(struct Kernels, dequantize)) ||
+               Kernels_overrides(v, offsetof(struct Kernels, invert_dct)) ||
+               Kernels_overrides(v, offsetof(struct Kernels, cav_to_rgb));
+}
+
+/********** init_case ********
+ *
+ * Points a case's blocks at its own arrays.
+ ************************/
+static void init_case(Case *c)
+{
+        for (int i = 0; i < 4; i++)
+        {
+                c->rgb_in_block.rgb[i] = &c->rgb_in[i];
+                c->cav_in_block.cav[i] = &c->cav_in[i];
+                for (int w = 0; w < 2; w++)
+                {
+                        c->rgb_out_block[w].rgb[i] = &c->rgb_out[w][i];
+                        c->cav_out_block[w].cav[i] = &c->cav_out[w][i];
+                }
+        }
+}
+
+/********** check_stage ********
+ *
+ * Runs one stage of variant v against the reference and prints a line
+ * of results, preceded by the first few mismatches.
+ *
+ * Parameters:
+ *      const Stage *stage:     The stage.
+ *      Kernels ref:            The reference kernels.
+ *      Kernels var:            The variant's kernels.
+ *      Case *cases:            BATCH cases of scratch space.
+ *      uint64_t ncases:        The number of random cases, unless
+ *                              running exhaustively.
+ *      uint64_t seed:          The seed for the inputs.
+ *      int exhaustive:         Nonzero to run every codeword if the stage
+ *                              allows it.
+ *
+ * Return:
+ *      uint64_t:               The number of mismatching cases.
+ ************************/
+static uint64_t check_stage(const Stage *stage, Kernels ref, Kernels var,
+                            Case *cases, uint64_t ncases, uint64_t seed,
+                            int exhaustive)
+{
+        exhaustive = exhaustive && stage->exhaustive;
+        uint64_t total = exhaustive ? (uint64_t)1 << 32 : ncases;
+        uint64_t rng = seed, done = 0, run = 0, mismatches = 0;
+        uint64_t ref_ns = 0, var_ns = 0;
+        double max_error[6] = {0};
+        double want[MAX_VALUES], got[MAX_VALUES];
+
+        while (done < total)
+        {
+                int n = total - done < BATCH ? (int)(total - done) : BATCH;
+                for (int i = 0; i < n; i++)
+                {
+                        cases[i].skipped = 0;
+                        stage->generate(&cases[i], &rng, done + i,
+                                        exhaustive);
+                }
+
+                if (stage->gather != NULL)
+                {
+                        stage->gather(cases, n);
+                }
+
+                uint64_t t0 = Timer_ns();
+                stage->run(ref, cases, n, 0);
+                uint64_t t1 = Timer_ns();
+                stage->run(var, cases, n, 1);
+                uint64_t t2 = Timer_ns();
+                ref_ns += t1 - t0;
+                var_ns += t2 - t1;
+
+                if (stage->scatter != NULL)
+                {
+                        stage->scatter(cases, n, 0);
+                        stage->scatter(cases, n, 1);
+                }
+
+                for (int i = 0; i < n; i++)
+                {
+                        if (cases[i].skipped)
+                        {
+                                continue;
+                        }
+                        run++;
+                        stage->values(&cases[i], 0, want);
+                        stage->values(&cases[i], 1, got);
+
+                        int differs = -1;
+                        for (int v = 0; v < stage->nvalues; v++)
+                        {
+                                double error = fabs(want[v] - got[v]);
+                                int ch = v % stage->nchannels;
+                                if (error > max_error[ch])
+                                {
+                                        max_error[ch] = error;
+                                }
+                                /* Bitwise, so -0 vs 0 and NaN count */
+                                if (differs < 0 && memcmp(&want[v], &got[v],
+                                                          sizeof(double)))
+                                {
+                                        differs = v;
+                                }
+                        }
+                        if (differs >= 0 && mismatches++ < MAX_REPORTED)
+                        {
+                                printf("  MISMATCH %s: ", stage->name);
+                                stage->describe(&cases[i], stdout);
+                                printf(": %s[%d] reference %.9g, %s %.9g\n",
+                                       stage->channels[differs %
+                                                       stage->nchannels],
+                                       differs / stage->nchannels,
+                                       want[differs], var->name,
+                                       got[differs]);
+                        }
+                }
+                done += n;
+        }
+
+        printf("  %-13s %11llu %11llu  ", stage->name,
+               (unsigned long long)run, (unsigned long long)mismatches);
+        for (int ch = 0; ch < stage->nchannels; ch++)
+        {
+                printf(" %s %.3g", stage->channels[ch], max_error[ch]);
+        }
+        double ref_rate = ref_ns ? done * 1e3 / ref_ns : 0;
+        double var_rate = var_ns ? done * 1e3 / var_ns : 0;
+        printf("\n  %-13s %10.1f Mcase/s reference, %.1f Mcase/s %s "
+               "(%.2fx)\n", "", ref_rate, var_rate, var->name,
+               ref_rate > 0 ? var_rate / ref_rate : 0);
+        return mismatches;
+}
+
+/********** check_variant ********
+ *
+ * Checks every stage variant v overrides (or every stage, if all is
+ * set).
+ *
+ * Return:
+ *      uint64_t:       The total number of mismatching cases.
+ ************************/
+static uint64_t check_variant(int v, Case *cases, uint64_t ncases,
+                              uint64_t seed, int exhaustive, int all)
+{
+        struct Kernels ref, var;
+        uint64_t mismatches = 0;
+        int checked = 0;
+
+        Kernels_at(0, &ref);
+        Kernels_at(v, &var);
+        printf("%s:\n  %-13s %11s %11s   %s\n", var.name, "stage", "cases",
+               "mismatches", "max error per channel");
+        for (size_t s = 0; s < NUM_STAGES; s++)
+        {
+                if (all || stage_applies(&STAGES[s], v))
+                {
+                        mismatches += check_stage(&STAGES[s], &ref, &var,
+                                                  cases, ncases, seed,
+                                                  exhaustive);
+                        checked++;
+                }
+        }
+        if (checked == 0)
+        {
+                printf("  (overrides nothing; use -a to check anyway)\n");
+        }
+        return mismatches;
+}
+
+int main(int argc, char *argv[])
+{
+        uint64_t ncases = 1000000, seed = 1;
+        int exhaustive = 0, all = 0;
+        int i;
+
+        for (i = 1; i < argc; i++) {
+                if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+                        ncases = strtoull(argv[++i], NULL, 10);
+                } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+                        seed = strtoull(argv[++i], NULL, 10);
+                } else if (strcmp(argv[i], "-x") == 0) {
+                        exhaustive = 1;
+                } else if (strcmp(argv[i], "-a") == 0) {
+                        all = 1;
+                } else if (argv[i][0] == '-') {
+                        fprintf(stderr, "Usage: %s [-n cases] [-s seed] "
+                                "[-x] [-a] [variant ...]\n", argv[0]);
+                        exit(1);
+                } else {
+                        break;
+                }
+        }
+
+        Case *cases = CALLOC(BATCH, sizeof(Case));
+        for (int c = 0; c < BATCH; c++) {
+                init_case(&cases[c]);
+        }
+
+        uint64_t mismatches = 0;
+        if (i == argc) {
+                for (int v = 1; v < Kernels_count(); v++) {
+                        if (!Kernels_supported(v)) {
+                                struct Kernels var;
+                                Kernels_at(v, &var);
+                                printf("%s: skipped (CPU lacks %s)\n",
+                                       var.name, var.name);
+                                continue;
+                        }
+                        mismatches += check_variant(v, cases, ncases, seed,
+                                                    exhaustive, all);
+                }
+        }
+        for (; i < argc; i++) {
+                int v = Kernels_find(argv[i]);
+                if (v < 0) {
+                        fprintf(stderr, "%s: no variant named %s\n",
+                                argv[0], argv[i]);
+                        exit(1);
+                }
+                if (!Kernels_supported(v)) {
+                        fprintf(stderr, "%s: this CPU cannot run %s\n",
+                                argv[0], argv[i]);
+                        exit(1);
+                }
+                mismatches += check_variant(v, cases, ncases, seed,
+                                            exhaustive, all);
+        }
+
+        FREE(cases);
+        if (mismatches > 0) {
+                printf("kerneldiff: %llu mismatches\n",
+                       (unsigned long long)mismatches);
+                return EXIT_FAILURE;
+        }
+        printf("kerneldiff: ok\n");
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,427 @@
+/**************************************************************
+ *
+ *                     kernels.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for the kernel registry, the
+ *     choice of the active set, and the sets that are not built per
+ *     instruction set:
+ *
+ *             reference  the scalar pipeline, unchanged
+ *             direct     codewords packed and unpacked with plain shifts
+ *                        and masks instead of Bitpack calls, and
+ *                        dequantized by table lookup
+ *
+ *     The per-instruction-set sets (scalar, sse4, avx2, avx512) are in
+ *     kernels_isa.c and are registered after these, best last. To add a
+ *     variant, write its kernels and add an entry to VARIANTS or
+ *     Kernels_isa; kerneldiff then checks it.
+ *
+ ************************/
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "assert.h"
+#include "arith40.h"
+#include "kernels.h"
+#include "packword.h"
+
+/* Dequantized a, indexed by a, and b, c or d, indexed by value + 15 */
+static float a_table[512];
+static float bcd_table[31];
+static pthread_once_t tables_once = PTHREAD_ONCE_INIT;
+
+/********** init_tables ********
+ *
+ * Fills the dequantization tables with exactly the values that
+ * inv_quantize_a and inv_quantize_bcd compute.
+ ************************/
+static void init_tables(void)
+{
+        for (int i = 0; i < 512; i++)
+        {
+                a_table[i] = i / 511.0;
+        }
+        for (int i = -15; i <= 15; i++)
+        {
+                bcd_table[i + 15] = i / 50.0;
+        }
+}
+
+/********** pack_direct ********
+ *
+ * packWord with shifts and masks.
+ *
+ * Expects:
+ *      q must not be NULL, and its fields must be in range.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+static uint32_t pack_direct(Quantized q)
+{
+        assert(q != NULL);
+        assert(q->a < 512 && q->Pbar_b < 16 && q->Pbar_r < 16);
+        assert(q->b >= -16 && q->b <= 15);
+        assert(q->c >= -16 && q->c <= 15);
+        assert(q->d >= -16 && q->d <= 15);
+
+        return (uint32_t)q->a << 23 |
+               ((uint32_t)q->b & 31) << 18 |
+               ((uint32_t)q->c & 31) << 13 |
+               ((uint32_t)q->d & 31) << 8 |
+               q->Pbar_b << 4 |
+               q->Pbar_r;
+}
+
+/********** signed5 ********
+ *
+ * Sign-extends the 5-bit field of word whose least significant bit is
+ * at lsb.
+ ************************/
+static inline int signed5(uint32_t word, unsigned lsb)
+{
+        return (int)(((word >> lsb) & 31) ^ 16) - 16;
+}
+
+/********** unpack_direct ********
+ *
+ * unpackWord with shifts and masks.
+ ************************/
+static void unpack_direct(Quantized q, uint32_t word)
+{
+        q->a = word >> 23;
+        q->b = signed5(word, 18);
+        q->c = signed5(word, 13);
+        q->d = signed5(word, 8);
+        q->Pbar_b = (word >> 4) & 15;
+        q->Pbar_r = word & 15;
+}
+
+/********** dequantize_table ********
+ *
+ * dequantize by table lookup.
+ *
+ * Expects:
+ *      dct and q must not be NULL, and q's fields must be in range.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+static void dequantize_table(DCT dct, Quantized q)
+{
+        assert(dct != NULL);
+        assert(q != NULL);
+        assert(q->a < 512);
+        assert(q->b >= -15 && q->b <= 15);
+        assert(q->c >= -15 && q->c <= 15);
+        assert(q->d >= -15 && q->d <= 15);
+        pthread_once(&tables_once, init_tables);
+
+        dct->a = a_table[q->a];
+        dct->b = bcd_table[q->b + 15];
+        dct->c = bcd_table[q->c + 15];
+        dct->d = bcd_table[q->d + 15];
+        dct->Pbar_b = Arith40_chroma_of_index(q->Pbar_b);
+        dct->Pbar_r = Arith40_chroma_of_index(q->Pbar_r);
+}
+
+/********** encode_blocks_reference ********
+ *
+ * The reference encode_blocks kernel.
+ ************************/
+static void encode_blocks_reference(uint32_t *words, Frame frame, size_t col,
+                                    size_t nrows)
+{
+        struct DCT dct;
+        struct Quantized q;
+
+        for (size_t row = 0; row < nrows; row++)
+        {
+                computeDCT_frame(&dct, frame, col, row);
+                quantize(&q, &dct);
+                words[row] = packWord(&q);
+        }
+}
+
+/********** decode_blocks_reference ********
+ *
+ * The reference decode_blocks kernel.
+ ************************/
+static void decode_blocks_reference(Frame frame, const uint32_t *words,
+                                    size_t col, size_t nrows)
+{
+        struct DCT dct;
+        struct Quantized q;
+
+        for (size_t row = 0; row < nrows; row++)
+        {
+                unpackWord(&q, words[row]);
+                dequantize(&dct, &q);
+                invertDCT_frame(frame, &dct, col, row);
+        }
+}
+
+/********** pack_batch_reference ********
+ *
+ * The reference pack_batch kernel.
+ ************************/
+static void pack_batch_reference(uint32_t *words, const struct Quantized *q,
+                                 size_t n)
+{
+        for (size_t i = 0; i < n; i++)
+        {
+                struct Quantized copy = q[i];
+                words[i] = packWord(&copy);
+        }
+}
+
+/********** unpack_batch_reference ********
+ *
+ * The reference unpack_batch kernel.
+ ************************/
+static void unpack_batch_reference(struct Quantized *q, const uint32_t *words,
+                                   size_t n)
+{
+        for (size_t i = 0; i < n; i++)
+        {
+                unpackWord(&q[i], words[i]);
+        }
+}
+
+static const struct Kernels VARIANTS[] = {
+        {
+                "reference", NULL, RGBtoCAV_block, CAVtoRGB_block,
+                computeDCT, invertDCT, quantize, dequantize, packWord,
+                unpackWord, Frame_from_rgb_row, Frame_to_rgb_row,
+                encode_blocks_reference, decode_blocks_reference,
+                pack_batch_reference, unpack_batch_reference
+        },
+        {
+                "direct", NULL, NULL, NULL, NULL, NULL, NULL,
+                dequantize_table, pack_direct, unpack_direct, NULL, NULL,
+                NULL, NULL, NULL, NULL
+        },
+};
+
+#define NUM_VARIANTS ((int)(sizeof(VARIANTS) / sizeof(VARIANTS[0])))
+
+static struct Kernels active;
+static pthread_once_t active_once = PTHREAD_ONCE_INIT;
+
+/********** variant ********
+ *
+ * Gets registered set i, as registered.
+ ************************/
+static const struct Kernels *variant(int i)
+{
+        assert(i >= 0 && i < NUM_VARIANTS + Kernels_isa_count);
+        if (i < NUM_VARIANTS)
+        {
+                return &VARIANTS[i];
+        }
+        return &Kernels_isa[i - NUM_VARIANTS];
+}
+
+/********** choose_active ********
+ *
+ * Sets active to the set named by COMP40_KERNEL, or else to the last
+ * registered set the CPU supports.
+ ************************/
+static void choose_active(void)
+{
+        int chosen = -1;
+        for (int i = 0; i < Kernels_count(); i++)
+        {
+                if (Kernels_supported(i))
+                {
+                        chosen = i;
+                }
+        }
+
+        const char *forced = getenv("COMP40_KERNEL");
+        if (forced != NULL && *forced != '\0')
+        {
+                int i = Kernels_find(forced);
+                if (i < 0)
+                {
+                        fprintf(stderr, "COMP40_KERNEL: no kernels named %s; "
+                                "using %s\n", forced, variant(chosen)->name);
+                }
+                else if (!Kernels_supported(i))
+                {
+                        fprintf(stderr, "COMP40_KERNEL: this CPU cannot run "
+                                "%s; using %s\n", forced,
+                                variant(chosen)->name);
+                }
+                else
+                {
+                        chosen = i;
+                }
+        }
+        Kernels_at(chosen, &active);
+}
+
+/********** Kernels_count ********
+ *
+ * Gets the number of registered kernel sets.
+ *
+ * Return:
+ *      int:            The count; set 0 is always the reference.
+ ************************/
+int Kernels_count(void)
+{
+        return NUM_VARIANTS + Kernels_isa_count;
+}
+
+/********** Kernels_at ********
+ *
+ * Gets a registered kernel set, with every NULL kernel filled in from
+ * the reference set.
+ *
+ * Parameters:
+ *      int i:          The index of the set.
+ *      Kernels out:    Where to store the set.
+ *
+ * Expects:
+ *      i must be in [0, Kernels_count()) and out must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Kernels_at(int i, Kernels out)
+{
+        assert(out != NULL);
+
+        const struct Kernels *v = variant(i), *ref = &VARIANTS[0];
+        *out = *v;
+
+#define INHERIT(kernel) \
+        if (out->kernel == NULL) \
+        { \
+                out->kernel = ref->kernel; \
+        }
+
+        INHERIT(rgb_to_cav);
+        INHERIT(cav_to_rgb);
+        INHERIT(compute_dct);
+        INHERIT(invert_dct);
+        INHERIT(quantize);
+        INHERIT(dequantize);
+        INHERIT(pack);
+        INHERIT(unpack);
+        INHERIT(rgb_to_frame);
+        INHERIT(frame_to_rgb);
+        INHERIT(encode_blocks);
+        INHERIT(decode_blocks);
+        INHERIT(pack_batch);
+        INHERIT(unpack_batch);
+#undef INHERIT
+}
+
+/********** Kernels_supported ********
+ *
+ * Tells whether the CPU can run a registered kernel set.
+ *
+ * Parameters:
+ *      int i:          The index of the set.
+ *
+ * Return:
+ *      int:            Nonzero if set i can run here.
+ *
+ * Expects:
+ *      i must be in [0, Kernels_count()).
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Kernels_supported(int i)
+{
+        const struct Kernels *v = variant(i);
+        return v->supported == NULL || v->supported();
+}
+
+/********** Kernels_overrides ********
+ *
+ * Tells whether a registered set has its own version of a kernel.
+ *
+ * Parameters:
+ *      int i:          The index of the set.
+ *      size_t offset:  The offsetof the kernel in struct Kernels.
+ *
+ * Return:
+ *      int:            Nonzero if set i is not the reference and its
+ *                      kernel at offset is not NULL.
+ *
+ * Expects:
+ *      i must be in [0, Kernels_count()).
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Kernels_overrides(int i, size_t offset)
+{
+        assert(offset >= offsetof(struct Kernels, rgb_to_cav));
+        assert(offset <= offsetof(struct Kernels, unpack_batch));
+
+        void (*kernel)(void);
+        memcpy(&kernel, (const char *)variant(i) + offset, sizeof(kernel));
+        return i != 0 && kernel != NULL;
+}
+
+/********** Kernels_find ********
+ *
+ * Finds a registered kernel set by name.
+ *
+ * Parameters:
+ *      const char *name:       The name to look for.
+ *
+ * Return:
+ *      int:                    The index of the set, or -1 if none has
+ *                              that name.
+ *
+ * Expects:
+ *      name must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Kernels_find(const char *name)
+{
+        assert(name != NULL);
+
+        for (int i = 0; i < Kernels_count(); i++)
+        {
+                if (strcmp(variant(i)->name, name) == 0)
+                {
+                        return i;
+                }
+        }
+        return -1;
+}
+
+/********** Kernels_active ********
+ *
+ * Gets the kernel set the codec runs. The first call chooses it: the set
+ * named by COMP40_KERNEL if that is set, otherwise the last registered
+ * set the CPU supports.
+ *
+ * Return:
+ *      Kernels:        The active set, with no NULL kernels.
+ *
+ * Notes:
+ *      An unknown or unsupported COMP40_KERNEL is reported on stderr and
+ *      ignored.
+ ************************/
+Kernels Kernels_active(void)
+{
+        pthread_once(&active_once, choose_active);
+        return &active;
+}
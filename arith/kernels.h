@@ -0,0 +1,191 @@
+/**************************************************************
+ *
+ *                     kernels.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for the kernel registry: named
+ *     sets of codec kernels. The reference set is the scalar pipeline in
+ *     rgb2cav.c, frame.c, dct.c, quantize.c and packword.c; every other
+ *     set is a faster variant that must give exactly the same results,
+ *     which kerneldiff checks. A variant may leave a kernel NULL to use
+ *     the reference one.
+ *
+ *     The codec runs the active set, which is the last registered set the
+ *     CPU supports, chosen once at startup. Setting the environment
+ *     variable COMP40_KERNEL to a set's name forces that set instead.
+ *
+ ************************/
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <stdint.h>
+#include "rgb2cav.h"
+#include "dct.h"
+#include "quantize.h"
+#include "frame.h"
+
+/********** Kernels ********
+ *
+ * One named set of kernels.
+ *
+ * Elements:
+ *      const char *name:       The name variants are selected by.
+ *      supported:              Returns nonzero if the CPU can run the
+ *                              set; NULL if every CPU can.
+ *      rgb_to_cav:             Like RGBtoCAV_block.
+ *      cav_to_rgb:             Like CAVtoRGB_block.
+ *      compute_dct:            Like computeDCT.
+ *      invert_dct:             Like invertDCT.
+ *      quantize:               Like quantize.
+ *      dequantize:             Like dequantize.
+ *      pack:                   Like packWord.
+ *      unpack:                 Like unpackWord.
+ *      rgb_to_frame:           Like Frame_from_rgb_row.
+ *      frame_to_rgb:           Like Frame_to_rgb_row.
+ *      encode_blocks:          Codes nrows blocks of column col of a
+ *                              frame to words, as computeDCT_frame,
+ *                              quantize and packWord would.
+ *      decode_blocks:          Decodes nrows words into column col of a
+ *                              frame, as unpackWord, dequantize and
+ *                              invertDCT_frame would.
+ *      pack_batch:             packWord on n blocks.
+ *      unpack_batch:           unpackWord on n words.
+ ************************/
+typedef struct Kernels
+{
+        const char *name;
+        int (*supported)(void);
+        void (*rgb_to_cav)(CAV_block cav_block, RGB_block rgb_block,
+                           int denominator);
+        void (*cav_to_rgb)(RGB_block rgb_block, CAV_block cav_block,
+                           int denominator);
+        void (*compute_dct)(DCT dct, CAV_block block);
+        void (*invert_dct)(CAV_block block, DCT dct);
+        void (*quantize)(Quantized q, DCT dct);
+        void (*dequantize)(DCT dct, Quantized q);
+        uint32_t (*pack)(Quantized q);
+        void (*unpack)(Quantized q, uint32_t word);
+        void (*rgb_to_frame)(float *Y, float *P_b, float *P_r,
+                             const struct Pnm_rgb *rgb, size_t n,
+                             int denominator);
+        void (*frame_to_rgb)(struct Pnm_rgb *rgb, const float *Y,
+                             const float *P_b, const float *P_r, size_t n,
+                             int denominator);
+        void (*encode_blocks)(uint32_t *words, Frame frame, size_t col,
+                              size_t nrows);
+        void (*decode_blocks)(Frame frame, const uint32_t *words,
+                              size_t col, size_t nrows);
+        void (*pack_batch)(uint32_t *words, const struct Quantized *q,
+                           size_t n);
+        void (*unpack_batch)(struct Quantized *q, const uint32_t *words,
+                             size_t n);
+} *Kernels;
+
+/* The sets built for each instruction set, defined in kernels_isa.c and
+ * registered after the ones in kernels.c; use Kernels_at to get them */
+extern const struct Kernels Kernels_isa[];
+extern const int Kernels_isa_count;
+
+/********** Kernels_count ********
+ *
+ * Gets the number of registered kernel sets.
+ *
+ * Return:
+ *      int:            The count; set 0 is always the reference.
+ ************************/
+int Kernels_count(void);
+
+/********** Kernels_at ********
+ *
+ * Gets a registered kernel set, with every NULL kernel filled in from
+ * the reference set.
+ *
+ * Parameters:
+ *      int i:          The index of the set.
+ *      Kernels out:    Where to store the set.
+ *
+ * Expects:
+ *      i must be in [0, Kernels_count()) and out must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Kernels_at(int i, Kernels out);
+
+/********** Kernels_supported ********
+ *
+ * Tells whether the CPU can run a registered kernel set.
+ *
+ * Parameters:
+ *      int i:          The index of the set.
+ *
+ * Return:
+ *      int:            Nonzero if set i can run here.
+ *
+ * Expects:
+ *      i must be in [0, Kernels_count()).
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Kernels_supported(int i);
+
+/********** Kernels_overrides ********
+ *
+ * Tells whether a registered set has its own version of a kernel.
+ *
+ * Parameters:
+ *      int i:          The index of the set.
+ *      size_t offset:  The offsetof the kernel in struct Kernels.
+ *
+ * Return:
+ *      int:            Nonzero if set i is not the reference and its
+ *                      kernel at offset is not NULL.
+ *
+ * Expects:
+ *      i must be in [0, Kernels_count()).
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Kernels_overrides(int i, size_t offset);
+
+/********** Kernels_find ********
+ *
+ * Finds a registered kernel set by name.
+ *
+ * Parameters:
+ *      const char *name:       The name to look for.
+ *
+ * Return:
+ *      int:                    The index of the set, or -1 if none has
+ *                              that name.
+ *
+ * Expects:
+ *      name must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Kernels_find(const char *name);
+
+/********** Kernels_active ********
+ *
+ * Gets the kernel set the codec runs. The first call chooses it: the set
+ * named by COMP40_KERNEL if that is set, otherwise the last registered
+ * set the CPU supports.
+ *
+ * Return:
+ *      Kernels:        The active set, with no NULL kernels.
+ *
+ * Notes:
+ *      An unknown or unsupported COMP40_KERNEL is reported on stderr and
+ *      ignored.
+ ************************/
+Kernels Kernels_active(void);
+
+#endif
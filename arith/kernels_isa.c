@@ -0,0 +1,104 @@
+/**************************************************************
+ *
+ *                     kernels_isa.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the kernel sets built once per instruction set
+ *     from kernels_template.h:
+ *
+ *             scalar     the baseline instruction set of the build
+ *             sse4       SSE4.2
+ *             avx2       AVX2
+ *             avx512     AVX-512 F, BW, DQ and VL
+ *
+ *     Only the batch kernels differ; the per-block kernels are the
+ *     reference ones. Sets other than scalar are built only for x86,
+ *     where CPUID (through __builtin_cpu_supports) tells which ones the
+ *     machine can run.
+ *
+ *     The Makefile compiles this file with optimization and with
+ *     -ffp-contract=off; see kernels_template.h.
+ *
+ ************************/
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "assert.h"
+#include "arith40.h"
+#include "kernels.h"
+#include "quantstats.h"
+
+#define KERNEL(name) name##_scalar
+#include "kernels_template.h"
+#undef KERNEL
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#pragma GCC push_options
+#pragma GCC target("sse4.2")
+#define KERNEL(name) name##_sse4
+#include "kernels_template.h"
+#undef KERNEL
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#define KERNEL(name) name##_avx2
+#include "kernels_template.h"
+#undef KERNEL
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512dq,avx512vl")
+#define KERNEL(name) name##_avx512
+#include "kernels_template.h"
+#undef KERNEL
+#pragma GCC pop_options
+
+static int has_sse4(void)
+{
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.2");
+}
+
+static int has_avx2(void)
+{
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+}
+
+static int has_avx512(void)
+{
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx512f") &&
+               __builtin_cpu_supports("avx512bw") &&
+               __builtin_cpu_supports("avx512dq") &&
+               __builtin_cpu_supports("avx512vl");
+}
+
+#endif
+
+/* One entry per instruction set; the per-block kernels stay NULL */
+#define ISA_KERNELS(isa, supported) \
+        { \
+                #isa, supported, NULL, NULL, NULL, NULL, NULL, NULL, NULL, \
+                NULL, rgb_to_frame_##isa, frame_to_rgb_##isa, \
+                encode_blocks_##isa, decode_blocks_##isa, \
+                pack_batch_##isa, unpack_batch_##isa \
+        }
+
+const struct Kernels Kernels_isa[] = {
+        ISA_KERNELS(scalar, NULL),
+#if defined(__x86_64__) || defined(__i386__)
+        ISA_KERNELS(sse4, has_sse4),
+        ISA_KERNELS(avx2, has_avx2),
+        ISA_KERNELS(avx512, has_avx512),
+#endif
+};
+
+const int Kernels_isa_count = sizeof(Kernels_isa) / sizeof(Kernels_isa[0]);
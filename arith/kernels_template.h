@@ -0,0 +1,213 @@
+/**************************************************************
+ *
+ *                     kernels_template.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     The batch kernels built once per instruction set. kernels_isa.c
+ *     includes this file once for each, with KERNEL(name) defined to give
+ *     that copy's functions their own names and a target pragma in force,
+ *     so that the compiler vectorizes each copy for its instruction set.
+ *
+ *     Every expression repeats the reference kernel's, with its float and
+ *     double conversions in the same places. kernels_isa.c is compiled
+ *     without floating-point contraction, so no copy fuses a multiply and
+ *     an add, and every copy gives the reference's results bit for bit.
+ *
+ *     This file deliberately has no include guard.
+ *
+ ************************/
+
+/* Blocks coded per call to the batch packers */
+#ifndef KERNEL_CHUNK
+#define KERNEL_CHUNK 64
+#endif
+
+static void KERNEL(rgb_to_frame)(float *restrict Y, float *restrict P_b,
+                                 float *restrict P_r,
+                                 const struct Pnm_rgb *restrict rgb,
+                                 size_t n, int denominator)
+{
+        assert(denominator > 0);
+
+        for (size_t col = 0; col < n; col++)
+        {
+                float red = (float)rgb[col].red / denominator;
+                float green = (float)rgb[col].green / denominator;
+                float blue = (float)rgb[col].blue / denominator;
+
+                float y = 0.299 * red + 0.587 * green + 0.114 * blue;
+                float pb = -0.168736 * red - 0.331264 * green + 0.5 * blue;
+                float pr = 0.5 * red - 0.418688 * green - 0.081312 * blue;
+
+                Y[col] = y < 0 ? 0 : (y > 1 ? 1 : y);
+                P_b[col] = pb < -0.5 ? -0.5 : (pb > 0.5 ? 0.5 : pb);
+                P_r[col] = pr < -0.5 ? -0.5 : (pr > 0.5 ? 0.5 : pr);
+        }
+}
+
+static void KERNEL(frame_to_rgb)(struct Pnm_rgb *restrict rgb,
+                                 const float *restrict Y,
+                                 const float *restrict P_b,
+                                 const float *restrict P_r,
+                                 size_t n, int denominator)
+{
+        assert(denominator > 0);
+
+        for (size_t col = 0; col < n; col++)
+        {
+                float red = Y[col] + 1.402 * P_r[col];
+                float green = Y[col] - 0.344136 * P_b[col] -
+                              0.714136 * P_r[col];
+                float blue = Y[col] + 1.772 * P_b[col];
+
+                red = red < 0 ? 0 : (red > 1 ? 1 : red);
+                green = green < 0 ? 0 : (green > 1 ? 1 : green);
+                blue = blue < 0 ? 0 : (blue > 1 ? 1 : blue);
+
+                rgb[col].red = red * denominator;
+                rgb[col].green = green * denominator;
+                rgb[col].blue = blue * denominator;
+        }
+}
+
+static void KERNEL(pack_batch)(uint32_t *restrict words,
+                               const struct Quantized *restrict q, size_t n)
+{
+        for (size_t i = 0; i < n; i++)
+        {
+                words[i] = (uint32_t)q[i].a << 23 |
+                           ((uint32_t)q[i].b & 31) << 18 |
+                           ((uint32_t)q[i].c & 31) << 13 |
+                           ((uint32_t)q[i].d & 31) << 8 |
+                           q[i].Pbar_b << 4 |
+                           q[i].Pbar_r;
+        }
+}
+
+static void KERNEL(unpack_batch)(struct Quantized *restrict q,
+                                 const uint32_t *restrict words, size_t n)
+{
+        for (size_t i = 0; i < n; i++)
+        {
+                uint32_t word = words[i];
+                q[i].a = word >> 23;
+                q[i].b = (int)(((word >> 18) & 31) ^ 16) - 16;
+                q[i].c = (int)(((word >> 13) & 31) ^ 16) - 16;
+                q[i].d = (int)(((word >> 8) & 31) ^ 16) - 16;
+                q[i].Pbar_b = (word >> 4) & 15;
+                q[i].Pbar_r = word & 15;
+        }
+}
+
+/********** KERNEL(quantize_bcd) ********
+ *
+ * quantize_bcd, and below it quantize_a, as in quantize.c.
+ ************************/
+static inline int KERNEL(quantize_bcd)(float in)
+{
+        in = in < -0.3 ? -0.3 : in;
+        in = in > 0.3 ? 0.3 : in;
+        return (int)roundf(in * 50);
+}
+
+static inline unsigned KERNEL(quantize_a)(float in)
+{
+        in = in < 0 ? 0 : in;
+        in = in > 1 ? 1 : in;
+        return (unsigned)roundf(in * 511);
+}
+
+static void KERNEL(encode_blocks)(uint32_t *words, Frame frame, size_t col,
+                                  size_t nrows)
+{
+        assert(frame != NULL);
+        assert(nrows == 0 ||
+               (col * 2 + 1 < frame->width && nrows * 2 <= frame->height));
+
+        const float *Y = frame->Y, *P_b = frame->P_b, *P_r = frame->P_r;
+        struct Quantized q[KERNEL_CHUNK];
+
+        for (size_t first = 0; first < nrows; first += KERNEL_CHUNK)
+        {
+                size_t n = nrows - first < KERNEL_CHUNK ? nrows - first
+                                                        : KERNEL_CHUNK;
+                for (size_t i = 0; i < n; i++)
+                {
+                        size_t top = (first + i) * 2 * frame->stride + col * 2;
+                        size_t bottom = top + frame->stride;
+                        struct DCT dct;
+
+                        dct.Pbar_b = (P_b[bottom + 1] + P_b[bottom] +
+                                      P_b[top + 1] + P_b[top]) / 4.0;
+                        dct.Pbar_r = (P_r[bottom + 1] + P_r[bottom] +
+                                      P_r[top + 1] + P_r[top]) / 4.0;
+                        dct.a = (Y[bottom + 1] + Y[bottom] + Y[top + 1] +
+                                 Y[top]) / 4.0;
+                        dct.b = (Y[bottom + 1] + Y[bottom] - Y[top + 1] -
+                                 Y[top]) / 4.0;
+                        dct.c = (Y[bottom + 1] - Y[bottom] + Y[top + 1] -
+                                 Y[top]) / 4.0;
+                        dct.d = (Y[bottom + 1] - Y[bottom] - Y[top + 1] +
+                                 Y[top]) / 4.0;
+
+                        q[i].a = KERNEL(quantize_a)(dct.a);
+                        q[i].b = KERNEL(quantize_bcd)(dct.b);
+                        q[i].c = KERNEL(quantize_bcd)(dct.c);
+                        q[i].d = KERNEL(quantize_bcd)(dct.d);
+                        q[i].Pbar_b = Arith40_index_of_chroma(dct.Pbar_b);
+                        q[i].Pbar_r = Arith40_index_of_chroma(dct.Pbar_r);
+
+                        if (Quantstats_enabled)
+                        {
+                                Quantstats_record(&dct, &q[i]);
+                        }
+                }
+                KERNEL(pack_batch)(words + first, q, n);
+        }
+}
+
+static void KERNEL(decode_blocks)(Frame frame, const uint32_t *words,
+                                  size_t col, size_t nrows)
+{
+        assert(frame != NULL);
+        assert(nrows == 0 ||
+               (col * 2 + 1 < frame->width && nrows * 2 <= frame->height));
+
+        float *Y = frame->Y, *P_b = frame->P_b, *P_r = frame->P_r;
+        struct Quantized q[KERNEL_CHUNK];
+
+        for (size_t first = 0; first < nrows; first += KERNEL_CHUNK)
+        {
+                size_t n = nrows - first < KERNEL_CHUNK ? nrows - first
+                                                        : KERNEL_CHUNK;
+                KERNEL(unpack_batch)(q, words + first, n);
+                for (size_t i = 0; i < n; i++)
+                {
+                        /* dequantize would reject these */
+                        assert(q[i].b >= -15 && q[i].c >= -15 &&
+                               q[i].d >= -15);
+
+                        size_t top = (first + i) * 2 * frame->stride + col * 2;
+                        size_t bottom = top + frame->stride;
+                        float a = q[i].a / 511.0;
+                        float b = q[i].b / 50.0;
+                        float c = q[i].c / 50.0;
+                        float d = q[i].d / 50.0;
+                        float pb = Arith40_chroma_of_index(q[i].Pbar_b);
+                        float pr = Arith40_chroma_of_index(q[i].Pbar_r);
+
+                        P_b[top] = P_b[top + 1] = pb;
+                        P_b[bottom] = P_b[bottom + 1] = pb;
+                        P_r[top] = P_r[top + 1] = pr;
+                        P_r[bottom] = P_r[bottom + 1] = pr;
+
+                        Y[top] = a - b - c + d;
+                        Y[top + 1] = a - b + c - d;
+                        Y[bottom] = a + b - c - d;
+                        Y[bottom + 1] = a + b + c + d;
+                }
+        }
+}
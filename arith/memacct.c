@@ -0,0 +1,502 @@
+/**************************************************************
+ *
+ *                     memacct.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for the accounting allocator.
+ *     Live blocks are kept in an open-addressing hash table from pointer
+ *     to size, so that a FREE of memory this allocator did not hand out
+ *     (e.g. memory a library got from malloc) is passed through without
+ *     disturbing the counts. The tables themselves use plain malloc.
+ *     Large UArray2 buffers, which are mapped rather than allocated, are
+ *     counted through the UArray2_mapped hook.
+ *
+ *     One mutex guards everything; this allocator is for measurement, not
+ *     for production runs.
+ *
+ ************************/
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "assert.h"
+#include "except.h"
+#include "mem.h"
+#include "memacct.h"
+#include "stats.h"
+#include "uarray2.h"
+
+#define MAX_SITES 256
+#define TOP_SITES 10
+#define INITIAL_SLOTS 1024
+
+/* Marks a hash slot whose block was freed */
+#define TOMBSTONE ((void *)1)
+
+const Except_T Mem_Failed = { "Allocation Failed" };
+
+/********** Slot ********
+ *
+ * One entry of the live-block table.
+ *
+ * Elements:
+ *      void *ptr:      The block, NULL if the slot was never used, or
+ *                      TOMBSTONE.
+ *      size_t size:    The block's size in bytes.
+ ************************/
+typedef struct Slot
+{
+        void *ptr;
+        size_t size;
+} Slot;
+
+/********** Site ********
+ *
+ * The counts for one call site.
+ *
+ * Elements:
+ *      const char *file:   The file, as given by __FILE__.
+ *      int line:           The line.
+ *      size_t allocs:      Allocations made there.
+ *      size_t bytes:       Bytes allocated there.
+ ************************/
+typedef struct Site
+{
+        const char *file;
+        int line;
+        size_t allocs;
+        size_t bytes;
+} Site;
+
+/********** Usage ********
+ *
+ * The counts for one stage.
+ *
+ * Elements:
+ *      size_t allocs:      Allocations made during the stage.
+ *      size_t bytes:       Bytes allocated during the stage.
+ *      size_t peak:        The most bytes live during the stage.
+ ************************/
+typedef struct Usage
+{
+        size_t allocs;
+        size_t bytes;
+        size_t peak;
+} Usage;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static Slot *slots = NULL;
+static size_t nslots = 0;
+static size_t used = 0;
+static Site sites[MAX_SITES];
+static size_t nsites = 0;
+static Site other_sites = {"(other sites)", 0, 0, 0};
+static Usage stages[STATS_NSTAGES + 1];
+static size_t live = 0;
+static size_t peak = 0;
+static size_t frees = 0;
+
+/********** hash ********
+ *
+ * Hashes a pointer into a table of nslots slots.
+ ************************/
+static size_t hash(void *ptr)
+{
+        uint64_t h = (uintptr_t)ptr;
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return h & (nslots - 1);
+}
+
+/********** insert_slot ********
+ *
+ * Adds a block to the table, which must have a free slot.
+ ************************/
+static void insert_slot(void *ptr, size_t size)
+{
+        size_t i = hash(ptr);
+        while (slots[i].ptr != NULL && slots[i].ptr != TOMBSTONE)
+        {
+                i = (i + 1) & (nslots - 1);
+        }
+        if (slots[i].ptr == NULL)
+        {
+                used++;
+        }
+        slots[i].ptr = ptr;
+        slots[i].size = size;
+}
+
+/********** grow ********
+ *
+ * Rehashes into a table twice the size, dropping tombstones.
+ ************************/
+static void grow(void)
+{
+        Slot *old = slots;
+        size_t nold = nslots;
+
+        nslots = nold == 0 ? INITIAL_SLOTS : nold * 2;
+        slots = calloc(nslots, sizeof(Slot));
+        assert(slots != NULL);
+        used = 0;
+        for (size_t i = 0; i < nold; i++)
+        {
+                if (old[i].ptr != NULL && old[i].ptr != TOMBSTONE)
+                {
+                        insert_slot(old[i].ptr, old[i].size);
+                }
+        }
+        free(old);
+}
+
+/********** record_alloc ********
+ *
+ * Counts a new block against the current stage and its call site.
+ ************************/
+static void record_alloc(void *ptr, size_t size, const char *file, int line)
+{
+        if (2 * (used + 1) > nslots)
+        {
+                grow();
+        }
+        insert_slot(ptr, size);
+
+        live += size;
+        if (live > peak)
+        {
+                peak = live;
+        }
+
+        Usage *stage = &stages[Stats_current];
+        stage->allocs++;
+        stage->bytes += size;
+        if (live > stage->peak)
+        {
+                stage->peak = live;
+        }
+
+        Site *site = NULL;
+        for (size_t i = 0; i < nsites && site == NULL; i++)
+        {
+                if (sites[i].line == line && sites[i].file == file)
+                {
+                        site = &sites[i];
+                }
+        }
+        if (site == NULL && nsites < MAX_SITES)
+        {
+                site = &sites[nsites++];
+                site->file = file;
+                site->line = line;
+                site->allocs = 0;
+                site->bytes = 0;
+        }
+        if (site == NULL)
+        {
+                site = &other_sites;
+        }
+        site->allocs++;
+        site->bytes += size;
+}
+
+/********** record_free ********
+ *
+ * Uncounts a block, if it is one this allocator handed out.
+ *
+ * Return:
+ *      size_t:         The block's size, or 0 if it was not found.
+ ************************/
+static size_t record_free(void *ptr)
+{
+        if (nslots == 0)
+        {
+                return 0;
+        }
+        size_t i = hash(ptr);
+        while (slots[i].ptr != NULL)
+        {
+                if (slots[i].ptr == ptr)
+                {
+                        live -= slots[i].size;
+                        slots[i].ptr = TOMBSTONE;
+                        frees++;
+                        return slots[i].size;
+                }
+                i = (i + 1) & (nslots - 1);
+        }
+        return 0;
+}
+
+/********** Mem_alloc ********
+ *
+ * CII's Mem_alloc, with accounting.
+ ************************/
+void *Mem_alloc(long nbytes, const char *file, int line)
+{
+        assert(nbytes > 0);
+        void *ptr = malloc(nbytes);
+        if (ptr == NULL)
+        {
+                if (file == NULL)
+                {
+                        RAISE(Mem_Failed);
+                }
+                else
+                {
+                        Except_raise(&Mem_Failed, file, line);
+                }
+        }
+
+        pthread_mutex_lock(&lock);
+        record_alloc(ptr, nbytes, file, line);
+        pthread_mutex_unlock(&lock);
+        return ptr;
+}
+
+/********** Mem_calloc ********
+ *
+ * CII's Mem_calloc, with accounting.
+ ************************/
+void *Mem_calloc(long count, long nbytes, const char *file, int line)
+{
+        assert(count > 0);
+        assert(nbytes > 0);
+        void *ptr = calloc(count, nbytes);
+        if (ptr == NULL)
+        {
+                if (file == NULL)
+                {
+                        RAISE(Mem_Failed);
+                }
+                else
+                {
+                        Except_raise(&Mem_Failed, file, line);
+                }
+        }
+
+        pthread_mutex_lock(&lock);
+        record_alloc(ptr, (size_t)count * nbytes, file, line);
+        pthread_mutex_unlock(&lock);
+        return ptr;
+}
+
+/********** Mem_free ********
+ *
+ * CII's Mem_free, with accounting.
+ ************************/
+void Mem_free(void *ptr, const char *file, int line)
+{
+        (void)file;
+        (void)line;
+        if (ptr != NULL)
+        {
+                pthread_mutex_lock(&lock);
+                record_free(ptr);
+                pthread_mutex_unlock(&lock);
+                free(ptr);
+        }
+}
+
+/********** Mem_resize ********
+ *
+ * CII's Mem_resize, with accounting. Counted as a free of the old block
+ * and an allocation of the new one.
+ ************************/
+void *Mem_resize(void *ptr, long nbytes, const char *file, int line)
+{
+        assert(ptr != NULL);
+        assert(nbytes > 0);
+
+        /* Hold the lock so no other thread can be handed ptr meanwhile */
+        pthread_mutex_lock(&lock);
+        size_t old = record_free(ptr);
+        void *resized = realloc(ptr, nbytes);
+        if (resized == NULL)
+        {
+                /* ptr is still allocated; put it back */
+                if (old > 0)
+                {
+                        insert_slot(ptr, old);
+                        live += old;
+                        frees--;
+                }
+                pthread_mutex_unlock(&lock);
+                if (file == NULL)
+                {
+                        RAISE(Mem_Failed);
+                }
+                else
+                {
+                        Except_raise(&Mem_Failed, file, line);
+                }
+        }
+        record_alloc(resized, nbytes, file, line);
+        pthread_mutex_unlock(&lock);
+        return resized;
+}
+
+/********** record_mapping ********
+ *
+ * UArray2's hook for the buffers it maps: counts a mapped buffer as an
+ * allocation and an unmapped one as a free.
+ ************************/
+static void record_mapping(void *elems, size_t bytes, const char *file,
+                           int line)
+{
+        pthread_mutex_lock(&lock);
+        if (bytes > 0)
+        {
+                record_alloc(elems, bytes, file, line);
+        }
+        else
+        {
+                record_free(elems);
+        }
+        pthread_mutex_unlock(&lock);
+}
+
+/********** Memacct_reset ********
+ *
+ * Clears the counts and sets the peak to the bytes live now, so that
+ * the next report covers only what happens after the call. From then on
+ * the codec keeps Stats_current even with statistics off, and large
+ * UArray2 buffers are counted too.
+ ************************/
+void Memacct_reset(void)
+{
+        Stats_tracking = 1;
+        UArray2_mapped = record_mapping;
+        pthread_mutex_lock(&lock);
+        for (int s = 0; s <= STATS_NSTAGES; s++)
+        {
+                stages[s].allocs = 0;
+                stages[s].bytes = 0;
+                stages[s].peak = 0;
+        }
+        nsites = 0;
+        other_sites.allocs = 0;
+        other_sites.bytes = 0;
+        frees = 0;
+        peak = live;
+        pthread_mutex_unlock(&lock);
+}
+
+/********** Memacct_live ********
+ *
+ * Gets the number of bytes allocated and not yet freed.
+ *
+ * Return:
+ *      size_t:         The live bytes.
+ ************************/
+size_t Memacct_live(void)
+{
+        pthread_mutex_lock(&lock);
+        size_t n = live;
+        pthread_mutex_unlock(&lock);
+        return n;
+}
+
+/********** Memacct_peak ********
+ *
+ * Gets the largest number of live bytes since the last reset.
+ *
+ * Return:
+ *      size_t:         The peak live bytes.
+ ************************/
+size_t Memacct_peak(void)
+{
+        pthread_mutex_lock(&lock);
+        size_t n = peak;
+        pthread_mutex_unlock(&lock);
+        return n;
+}
+
+/********** Memacct_allocations ********
+ *
+ * Gets the number of allocations made since the last reset, resizes
+ * included.
+ *
+ * Return:
+ *      size_t:         The allocation count.
+ ************************/
+size_t Memacct_allocations(void)
+{
+        pthread_mutex_lock(&lock);
+        size_t n = 0;
+        for (int s = 0; s <= STATS_NSTAGES; s++)
+        {
+                n += stages[s].allocs;
+        }
+        pthread_mutex_unlock(&lock);
+        return n;
+}
+
+/********** compare_sites ********
+ *
+ * Orders call sites by bytes allocated, most first.
+ ************************/
+static int compare_sites(const void *a, const void *b)
+{
+        const Site *x = a, *y = b;
+        return (x->bytes < y->bytes) - (x->bytes > y->bytes);
+}
+
+/********** Memacct_report ********
+ *
+ * Prints the totals, the counts for each stage, and the call sites that
+ * allocated the most bytes.
+ *
+ * Parameters:
+ *      FILE *out:      The stream to print to.
+ *
+ * Expects:
+ *      out must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Memacct_report(FILE *out)
+{
+        assert(out != NULL);
+        pthread_mutex_lock(&lock);
+
+        size_t allocs = 0, bytes = 0;
+        for (int s = 0; s <= STATS_NSTAGES; s++)
+        {
+                allocs += stages[s].allocs;
+                bytes += stages[s].bytes;
+        }
+        fprintf(out, "memory: %zu allocs, %zu frees, %zu bytes allocated, "
+                "%zu live, %zu peak\n", allocs, frees, bytes, live, peak);
+
+        fprintf(out, "  %-8s %10s %14s %14s\n", "stage", "allocs", "bytes",
+                "peak");
+        for (int s = 0; s <= STATS_NSTAGES; s++)
+        {
+                fprintf(out, "  %-8s %10zu %14zu %14zu\n",
+                        Stats_stage_name(s), stages[s].allocs,
+                        stages[s].bytes, stages[s].peak);
+        }
+
+        qsort(sites, nsites, sizeof(Site), compare_sites);
+        fprintf(out, "  %-30s %10s %14s\n", "site", "allocs", "bytes");
+        for (size_t i = 0; i < nsites && i < TOP_SITES; i++)
+        {
+                fprintf(out, "  %-24s:%-5d %10zu %14zu\n",
+                        sites[i].file == NULL ? "?" : sites[i].file,
+                        sites[i].line, sites[i].allocs, sites[i].bytes);
+        }
+        if (other_sites.allocs > 0)
+        {
+                fprintf(out, "  %-30s %10zu %14zu\n", other_sites.file,
+                        other_sites.allocs, other_sites.bytes);
+        }
+
+        pthread_mutex_unlock(&lock);
+}
@@ -0,0 +1,83 @@
+/**************************************************************
+ *
+ *                     memacct.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for the accounting allocator.
+ *     memacct.c defines Mem_alloc, Mem_calloc, Mem_resize and Mem_free
+ *     itself, so linking memacct.o ahead of -lcii40 routes every NEW,
+ *     ALLOC, CALLOC, RESIZE and FREE in the program (ours and CII's, e.g.
+ *     UArray) through it. It records allocation counts and bytes per
+ *     pipeline stage (see Stats_current in stats.h) and per call site,
+ *     and the live and peak live bytes.
+ *
+ *     Large UArray2 buffers, which are mapped rather than allocated, are
+ *     counted once Memacct_reset has been called. Other memory from plain
+ *     malloc or mmap, and the overhead of malloc itself, is not counted. Programs that do not link memacct.o use CII's allocator
+ *     unchanged.
+ *
+ ************************/
+
+#ifndef MEMACCT_H
+#define MEMACCT_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+/********** Memacct_reset ********
+ *
+ * Clears the counts and sets the peak to the bytes live now, so that
+ * the next report covers only what happens after the call. From then on
+ * the codec keeps Stats_current even with statistics off, and large
+ * UArray2 buffers are counted too.
+ ************************/
+void Memacct_reset(void);
+
+/********** Memacct_live ********
+ *
+ * Gets the number of bytes allocated and not yet freed.
+ *
+ * Return:
+ *      size_t:         The live bytes.
+ ************************/
+size_t Memacct_live(void);
+
+/********** Memacct_peak ********
+ *
+ * Gets the largest number of live bytes since the last reset.
+ *
+ * Return:
+ *      size_t:         The peak live bytes.
+ ************************/
+size_t Memacct_peak(void);
+
+/********** Memacct_allocations ********
+ *
+ * Gets the number of allocations made since the last reset, resizes
+ * included.
+ *
+ * Return:
+ *      size_t:         The allocation count.
+ ************************/
+size_t Memacct_allocations(void);
+
+/********** Memacct_report ********
+ *
+ * Prints the totals, the counts for each stage, and the call sites that
+ * allocated the most bytes.
+ *
+ * Parameters:
+ *      FILE *out:      The stream to print to.
+ *
+ * Expects:
+ *      out must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Memacct_report(FILE *out);
+
+#endif
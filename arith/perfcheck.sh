@@ -0,0 +1,171 @@
+#!/bin/sh
+#
+#                     perfcheck.sh
+#
+#     Assignment: arith
+#     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+#     Date:       10/19/2026
+#
+#     Performance regression harness. For every image in the corpus it
+#     checks that compress, decompress and ppmdiff produce exactly the
+#     output recorded in perfcheck/golden.sha256, then times each of them
+#     over N runs and compares the median against this host's baseline.
+#     Any output drift, or a median slower than the baseline by more than
+#     the threshold, fails the check.
+#
+#     Timings only mean something on the machine that made them, so the
+#     baseline is kept per host in perfcheck/baseline-<host>.txt and is
+#     not checked in. A host with no baseline gets one recorded by its
+#     first run, which checks output only.
+#
+#     Usage: perfcheck.sh [-u] [-n runs] [-t threshold_percent] [image ...]
+#            -u rewrites the golden hashes and this host's baseline
+#               instead of checking them.
+#            With no images, the corpus is every image listed in
+#            perfcheck/corpus.txt (run make corpus first).
+#
+
+set -u
+
+DIR=perfcheck
+GOLDEN=$DIR/golden.sha256
+BASELINE=$DIR/baseline-$(uname -n).txt
+CORPUS=$DIR/corpus.txt
+RUNS=11
+THRESHOLD=15
+UPDATE=0
+
+usage() {
+        echo "Usage: $0 [-u] [-n runs] [-t threshold_percent] [image ...]" >&2
+        exit 2
+}
+
+while getopts un:t: opt; do
+        case $opt in
+        u) UPDATE=1 ;;
+        n) RUNS=$OPTARG ;;
+        t) THRESHOLD=$OPTARG ;;
+        *) usage ;;
+        esac
+done
+shift $((OPTIND - 1))
+
+if [ $# -eq 0 ]; then
+        set -- $(grep -v '^#' $CORPUS)
+fi
+
+if [ $UPDATE -eq 0 ] && [ ! -f $GOLDEN ]; then
+        echo "perfcheck: no $GOLDEN; run make perfcheck-update" >&2
+        exit 1
+fi
+
+for image in "$@"; do
+        if [ ! -f "$image" ]; then
+                echo "perfcheck: no $image; run make corpus" >&2
+                exit 1
+        fi
+done
+
+# A host's first run records its baseline instead of checking against one
+RECORD=$UPDATE
+if [ ! -f $BASELINE ]; then
+        RECORD=1
+fi
+
+TMP=$(mktemp -d) || exit 1
+trap 'rm -rf "$TMP"' EXIT
+FAILED=0
+
+# now_ns: monotonic-enough wall clock in nanoseconds
+now_ns() {
+        date +%s%N
+}
+
+# median_ms command...: runs the command RUNS times, prints the median ms
+median_ms() {
+        i=0
+        : > "$TMP/times"
+        while [ $i -lt "$RUNS" ]; do
+                start=$(now_ns)
+                "$@" > /dev/null 2>&1
+                end=$(now_ns)
+                echo $(((end - start) / 1000)) >> "$TMP/times"
+                i=$((i + 1))
+        done
+        sort -n "$TMP/times" | awk '{ t[NR] = $1 }
+                END { printf "%.3f\n", t[int((NR + 1) / 2)] / 1000 }'
+}
+
+# check_hash key file: compares file's hash to the golden one for key
+check_hash() {
+        hash=$(sha256sum < "$2" | cut -d' ' -f1)
+        if [ $UPDATE -eq 1 ]; then
+                echo "$hash  $1" >> "$TMP/golden"
+                return
+        fi
+        want=$(awk -v k="$1" '$2 == k { print $1 }' "$GOLDEN")
+        if [ -z "$want" ]; then
+                echo "MISSING golden hash for $1"
+                FAILED=1
+        elif [ "$hash" != "$want" ]; then
+                echo "DRIFT   $1: output hash $hash, golden $want"
+                FAILED=1
+        fi
+}
+
+# check_time key ms: compares a median to the baseline for key
+check_time() {
+        if [ $RECORD -eq 1 ]; then
+                echo "$1 $2" >> "$TMP/baseline"
+                printf "%-40s %10s ms\n" "$1" "$2"
+                return
+        fi
+        base=$(awk -v k="$1" '$1 == k { print $2 }' "$BASELINE")
+        if [ -z "$base" ]; then
+                printf "%-40s %10s ms (no baseline)\n" "$1" "$2"
+                return
+        fi
+        verdict=$(awk -v now="$2" -v base="$base" -v pct="$THRESHOLD" 'BEGIN {
+                change = base > 0 ? 100 * (now - base) / base : 0
+                printf "%+.1f%% %s", change, (change > pct) ? "SLOW" : "ok"
+        }')
+        printf "%-40s %10s ms baseline %10s ms %s\n" "$1" "$2" "$base" \
+                "$verdict"
+        case $verdict in
+        *SLOW) FAILED=1 ;;
+        esac
+}
+
+for image in "$@"; do
+        name=$(basename "$image")
+        ./40image -c "$image" > "$TMP/$name.40"
+        ./40image -d "$TMP/$name.40" > "$TMP/$name.ppm"
+        ./ppmdiff "$image" "$TMP/$name.ppm" > "$TMP/$name.diff"
+        check_hash "$name.40" "$TMP/$name.40"
+        check_hash "$name.ppm" "$TMP/$name.ppm"
+        check_hash "$name.diff" "$TMP/$name.diff"
+
+        check_time "$name.compress" \
+                "$(median_ms ./40image -c "$image")"
+        check_time "$name.decompress" \
+                "$(median_ms ./40image -d "$TMP/$name.40")"
+        check_time "$name.ppmdiff" \
+                "$(median_ms ./ppmdiff "$image" "$TMP/$name.ppm")"
+done
+
+if [ $UPDATE -eq 1 ]; then
+        mv "$TMP/golden" "$GOLDEN"
+        mv "$TMP/baseline" "$BASELINE"
+        echo "perfcheck: wrote $GOLDEN and $BASELINE"
+        exit 0
+fi
+if [ $RECORD -eq 1 ] && [ $FAILED -eq 0 ]; then
+        mv "$TMP/baseline" "$BASELINE"
+        echo "perfcheck: output ok; recorded $BASELINE for later runs"
+        exit 0
+fi
+if [ $FAILED -ne 0 ]; then
+        echo "perfcheck: FAILED (threshold $THRESHOLD%, $RUNS runs)"
+        exit 1
+fi
+echo "perfcheck: ok (threshold $THRESHOLD%, $RUNS runs)"
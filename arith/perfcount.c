@@ -0,0 +1,205 @@
+/**************************************************************
+ *
+ *                     perfcount.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for the hardware performance
+ *     counters.
+ *
+ ************************/
+
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "perfcount.h"
+
+/********** Config ********
+ *
+ * How to ask the kernel for one counter.
+ *
+ * Elements:
+ *      const char *name:   The name reported for it.
+ *      uint32_t type:      The perf_event_attr type.
+ *      uint64_t config:    The perf_event_attr config.
+ ************************/
+typedef struct Config
+{
+        const char *name;
+        uint32_t type;
+        uint64_t config;
+} Config;
+
+/* Indexed by Perf_counter */
+static const Config CONFIGS[PERF_NCOUNTERS] = {
+        {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {"l1d_misses", PERF_TYPE_HW_CACHE,
+         PERF_COUNT_HW_CACHE_L1D |
+         (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {"llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+static int fds[PERF_NCOUNTERS] = {-1, -1, -1, -1, -1};
+
+/* The group's leader, whose read returns every member's count */
+static int leader = -1;
+
+/* Where each open counter's count is in a read of the group */
+static int slots[PERF_NCOUNTERS];
+static int nopen = 0;
+
+/********** Group_read ********
+ *
+ * What a read of the leader returns with PERF_FORMAT_GROUP,
+ * PERF_FORMAT_TOTAL_TIME_ENABLED and PERF_FORMAT_TOTAL_TIME_RUNNING.
+ *
+ * Elements:
+ *      uint64_t nr:            The number of counts that follow.
+ *      uint64_t enabled:       Nanoseconds the group was enabled.
+ *      uint64_t running:       Nanoseconds it was on the PMU.
+ *      uint64_t values[]:      The counts, in the order opened.
+ ************************/
+typedef struct Group_read
+{
+        uint64_t nr;
+        uint64_t enabled;
+        uint64_t running;
+        uint64_t values[PERF_NCOUNTERS];
+} Group_read;
+
+/********** Perf_open ********
+ *
+ * Opens every counter the system allows and starts them counting.
+ *
+ * Return:
+ *      int:            The number of counters opened. 0 means none are
+ *                      available, e.g. because perf_event_paranoid
+ *                      forbids them or the kernel lacks perf events.
+ *
+ * Notes:
+ *      The first counter that opens leads the group; a counter that
+ *      cannot join it (because the CPU has too few counters for the
+ *      whole group, say) is left out.
+ ************************/
+int Perf_open(void)
+{
+        for (int i = 0; i < PERF_NCOUNTERS; i++)
+        {
+                struct perf_event_attr attr;
+                memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = CONFIGS[i].type;
+                attr.config = CONFIGS[i].config;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP |
+                                   PERF_FORMAT_TOTAL_TIME_ENABLED |
+                                   PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                /* There is no glibc wrapper for perf_event_open */
+                fds[i] = syscall(SYS_perf_event_open, &attr, 0, -1, leader,
+                                 0);
+                if (fds[i] >= 0)
+                {
+                        if (leader < 0)
+                        {
+                                leader = fds[i];
+                        }
+                        slots[i] = nopen++;
+                }
+        }
+        return nopen;
+}
+
+/********** Perf_available ********
+ *
+ * Tells whether a counter was opened.
+ *
+ * Parameters:
+ *      Perf_counter counter:   The counter.
+ *
+ * Return:
+ *      int:                    1 if it is being counted, else 0.
+ ************************/
+int Perf_available(Perf_counter counter)
+{
+        return fds[counter] >= 0;
+}
+
+/********** Perf_read ********
+ *
+ * Reads every counter.
+ *
+ * Parameters:
+ *      uint64_t counts[]:      Filled in with the current counts, with 0
+ *                              for each counter that is not available.
+ *
+ * Notes:
+ *      The whole group is read at once. If it had to share the PMU with
+ *      other events, the counts are scaled up by the time it was enabled
+ *      over the time it ran.
+ ************************/
+void Perf_read(uint64_t counts[PERF_NCOUNTERS])
+{
+        Group_read group;
+        ssize_t want = (3 + nopen) * sizeof(uint64_t);
+
+        memset(counts, 0, PERF_NCOUNTERS * sizeof(counts[0]));
+        if (leader < 0 || read(leader, &group, sizeof(group)) != want ||
+            group.running == 0)
+        {
+                return;
+        }
+
+        double scale = (double)group.enabled / group.running;
+        for (int i = 0; i < PERF_NCOUNTERS; i++)
+        {
+                if (fds[i] >= 0)
+                {
+                        uint64_t value = group.values[slots[i]];
+                        counts[i] = group.running < group.enabled
+                                            ? (uint64_t)(value * scale)
+                                            : value;
+                }
+        }
+}
+
+/********** Perf_name ********
+ *
+ * Gets a short name for a counter.
+ *
+ * Parameters:
+ *      Perf_counter counter:   The counter.
+ *
+ * Return:
+ *      const char *:           Its name.
+ ************************/
+const char *Perf_name(Perf_counter counter)
+{
+        return CONFIGS[counter].name;
+}
+
+/********** Perf_close ********
+ *
+ * Closes every counter.
+ ************************/
+void Perf_close(void)
+{
+        for (int i = 0; i < PERF_NCOUNTERS; i++)
+        {
+                if (fds[i] >= 0)
+                {
+                        close(fds[i]);
+                        fds[i] = -1;
+                }
+        }
+        leader = -1;
+        nopen = 0;
+}
@@ -0,0 +1,103 @@
+/**************************************************************
+ *
+ *                     perfcount.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for reading the CPU's hardware
+ *     performance counters through perf_event_open. The counters are
+ *     opened as one group, so the kernel puts them on the CPU together and
+ *     every count covers the same stretch of time; a counter the CPU or
+ *     kernel does not offer is left out of the group rather than taking
+ *     the others down with it. Counts are scaled up when the group had to
+ *     take turns with other events.
+ *
+ *     Only user-space events of the calling thread are counted. Work the
+ *     codec hands to its thread pool (see tuning.h) is not included, so
+ *     per-stage counts are complete only when coding uses one thread.
+ *
+ ************************/
+
+#ifndef PERFCOUNT_H
+#define PERFCOUNT_H
+
+#include <stdint.h>
+
+/********** Perf_counter ********
+ *
+ * The counters that can be read.
+ ************************/
+typedef enum Perf_counter
+{
+        PERF_CYCLES,
+        PERF_INSTRUCTIONS,
+        PERF_L1D_MISSES,
+        PERF_LLC_MISSES,
+        PERF_BRANCH_MISSES,
+        PERF_NCOUNTERS
+} Perf_counter;
+
+/********** Perf_open ********
+ *
+ * Opens every counter the system allows and starts them counting.
+ *
+ * Return:
+ *      int:            The number of counters opened. 0 means none are
+ *                      available, e.g. because perf_event_paranoid
+ *                      forbids them or the kernel lacks perf events.
+ *
+ * Notes:
+ *      The first counter that opens leads the group; a counter that
+ *      cannot join it (because the CPU has too few counters for the
+ *      whole group, say) is left out.
+ ************************/
+int Perf_open(void);
+
+/********** Perf_available ********
+ *
+ * Tells whether a counter was opened.
+ *
+ * Parameters:
+ *      Perf_counter counter:   The counter.
+ *
+ * Return:
+ *      int:                    1 if it is being counted, else 0.
+ ************************/
+int Perf_available(Perf_counter counter);
+
+/********** Perf_read ********
+ *
+ * Reads every counter.
+ *
+ * Parameters:
+ *      uint64_t counts[]:      Filled in with the current counts, with 0
+ *                              for each counter that is not available.
+ *
+ * Notes:
+ *      The whole group is read at once. If it had to share the PMU with
+ *      other events, the counts are scaled up by the time it was enabled
+ *      over the time it ran.
+ ************************/
+void Perf_read(uint64_t counts[PERF_NCOUNTERS]);
+
+/********** Perf_name ********
+ *
+ * Gets a short name for a counter.
+ *
+ * Parameters:
+ *      Perf_counter counter:   The counter.
+ *
+ * Return:
+ *      const char *:           Its name.
+ ************************/
+const char *Perf_name(Perf_counter counter);
+
+/********** Perf_close ********
+ *
+ * Closes every counter.
+ ************************/
+void Perf_close(void);
+
+#endif
@@ -12,23 +12,121 @@
 #include <stdlib.h>
 #include "assert.h"
 #include <string.h>
+#include <stdint.h>
+#include <unistd.h>
 #include <math.h>
+#include <dirent.h>
+#include <sys/stat.h>
 
 #include "pnm.h"
 #include "a2methods.h"
 #include "a2plain.h"
+#include "rmse.h"
+#include "ppmrows.h"
+#include "frame.h"
+#include "jobarena.h"
+#include "kernels.h"
+#include "threadpool.h"
+#include "timer.h"
+#include "mem.h"
 
-#define SQUARE(x) ((x) * (x))
+/* A sampled estimate this close to the limit, relative to it, is checked
+ * with an exact pass */
+#define SAMPLE_MARGIN 0.25
+
+/* Fewer sampled rows than this are not worth estimating from */
+#define MIN_SAMPLED_ROWS 8
+
+/********** Limit ********
+ *
+ * What --max-error and --sample asked for.
+ *
+ * Elements:
+ *      double max_error:       The error to test against, or negative to
+ *                              report the error without testing it.
+ *      unsigned stride:        Estimate from every stride-th row first, or
+ *                              0 not to estimate.
+ ************************/
+typedef struct Limit
+{
+        double max_error;
+        unsigned stride;
+} Limit;
+
+/********** Pair ********
+ *
+ * One pair of images in a batch, and how comparing them went.
+ *
+ * Elements:
+ *      char *name:             The name to report the pair by.
+ *      char *path1, *path2:    The two images.
+ *      const char *error:      NULL, or why the pair could not be compared.
+ *      unsigned width, height: The region compared.
+ *      Rmse_sum sum:           The squared differences over that region.
+ *      double rmse:            The error, or a lower bound if exceeded.
+ *      int exceeded:           1 if the comparison stopped early because
+ *                              the error is sure to exceed the limit.
+ *      double ms:              How long the comparison took.
+ ************************/
+typedef struct Pair
+{
+        char *name;
+        char *path1, *path2;
+        const char *error;
+        unsigned width, height;
+        Rmse_sum sum;
+        double rmse;
+        int exceeded;
+        double ms;
+} Pair;
+
+/********** Batch ********
+ *
+ * The pairs a batch compares, shared by its workers.
+ *
+ * Elements:
+ *      Pair *pairs:    The pairs.
+ *      size_t count:   The number of pairs.
+ *      size_t next:    The index of the next pair for a worker to take.
+ *      Limit limit:    The limit to test every pair against, if any.
+ ************************/
+typedef struct Batch
+{
+        Pair *pairs;
+        size_t count;
+        size_t next;
+        Limit limit;
+} Batch;
 
 static FILE *openFile(char *fname,
                       char *mode);
-void computeDiff(int col,
-                 int row,
-                 A2Methods_UArray2 array2,
-                 A2Methods_Object *ptr,
-                 void *cl);
-float computeE(Pnm_ppm image1,
-               Pnm_ppm image2);
+static int closeEnough(unsigned width1,
+                       unsigned width2);
+double computeE(Pnm_ppm image1,
+                Pnm_ppm image2);
+static int streamE(FILE *i1_fp,
+                   FILE *i2_fp,
+                   Limit limit);
+static int compressedE(FILE *orig_fp,
+                       FILE *compressed_fp,
+                       Limit limit);
+static int report(const Rmse_sum *sum,
+                  unsigned denom1,
+                  unsigned denom2,
+                  Limit limit,
+                  int exceeded);
+static int batchE(Pair *pairs,
+                  size_t count,
+                  Limit limit,
+                  int jobs,
+                  const char *json);
+static Pair *dirPairs(const char *dir1,
+                      const char *dir2,
+                      size_t *count);
+static Pair *manifestPairs(const char *manifest,
+                           size_t *count);
+static void freePairs(Pair *pairs,
+                      size_t count);
 
 /********** main ********
  *
@@ -45,8 +143,8 @@ float computeE(Pnm_ppm image1,
  *      EXIT_FAILURE otherwise.
  *
  * Expects:
- *      The program expects at least two command-line arguments specifying
- *      the input files.
+ *      The program expects two command-line arguments specifying the
+ *      input files, after any options.
  *      If "-" is provided as an argument, the program reads from stdin.
  *      The program can only handle "-" for one of the input files.
  *
@@ -54,29 +152,124 @@ float computeE(Pnm_ppm image1,
  *      The program will print an error message and exit with EXIT_FAILURE
  *      if the images have significantly different dimensions or if there
  *      are issues with reading the files.
+ *      With --stream, the images are compared a row at a time as they are
+ *      read, in memory proportional to their width.
+ *      With --compressed, the second file is a compressed image, which is
+ *      compared without being decompressed to a file first.
+ *      With --max-error E, the images are compared a row at a time and the
+ *      comparison stops as soon as the error is sure to exceed E; the
+ *      program exits with EXIT_FAILURE if it does. Adding --sample N first
+ *      estimates the error from every Nth row of two seekable raw PPMs,
+ *      and compares every row only if the estimate is close to E.
+ *      With --batch dir1 dir2, or --manifest file listing "image1 image2"
+ *      on each line, many pairs are compared on --jobs workers (as many
+ *      as there are CPUs by default) and a table is printed; --json file
+ *      also writes the results as JSON. The program exits with
+ *      EXIT_FAILURE if any pair cannot be compared or exceeds the limit.
  ************************/
 int main(int argc, char *argv[])
 {
-        if (argc < 3)
+        int stream = 0;
+        int compressed = 0;
+        Limit limit = {-1, 0};
+        const char *dir1 = NULL, *dir2 = NULL, *manifest = NULL;
+        const char *json = NULL;
+        long jobs = sysconf(_SC_NPROCESSORS_ONLN);
+        int i;
+
+        for (i = 1; i < argc && strncmp(argv[i], "--", 2) == 0; i++)
         {
+                if (strcmp(argv[i], "--stream") == 0)
+                {
+                        stream = 1;
+                }
+                else if (strcmp(argv[i], "--compressed") == 0)
+                {
+                        compressed = 1;
+                }
+                else if (strcmp(argv[i], "--max-error") == 0 && i + 1 < argc)
+                {
+                        char *end;
+                        limit.max_error = strtod(argv[++i], &end);
+                        if (*end != '\0' || !(limit.max_error >= 0))
+                        {
+                                fprintf(stderr, "%s: bad --max-error '%s'\n",
+                                        argv[0], argv[i]);
+                                return EXIT_FAILURE;
+                        }
+                }
+                else if (strcmp(argv[i], "--sample") == 0 && i + 1 < argc)
+                {
+                        limit.stride = atoi(argv[++i]);
+                }
+                else if (strcmp(argv[i], "--batch") == 0 && i + 2 < argc)
+                {
+                        dir1 = argv[++i];
+                        dir2 = argv[++i];
+                }
+                else if (strcmp(argv[i], "--manifest") == 0 && i + 1 < argc)
+                {
+                        manifest = argv[++i];
+                }
+                else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc)
+                {
+                        jobs = atoi(argv[++i]);
+                }
+                else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+                {
+                        json = argv[++i];
+                }
+                else
+                {
+                        fprintf(stderr, "%s: unknown option '%s'\n",
+                                argv[0], argv[i]);
+                        return EXIT_FAILURE;
+                }
+        }
+        int batch = dir1 != NULL || manifest != NULL;
+        if (argc - i != (batch ? 0 : 2) || (dir1 != NULL && manifest != NULL) ||
+            (limit.stride > 0 && limit.max_error < 0) ||
+            (json != NULL && !batch) || (batch && limit.stride > 0))
+        {
+                fprintf(stderr, "Usage: %s [--stream] image1 image2\n"
+                        "       %s --compressed image.ppm image.40image\n"
+                        "       %s --batch dir1 dir2 | --manifest file\n"
+                        "Options: --max-error E [--sample N]\n"
+                        "Batch options: --jobs N --json file\n",
+                        argv[0], argv[0], argv[0]);
                 return EXIT_FAILURE;
         }
 
+        if (batch)
+        {
+                size_t count;
+                Pair *pairs = manifest != NULL ? manifestPairs(manifest, &count)
+                                               : dirPairs(dir1, dir2, &count);
+                if (pairs == NULL)
+                {
+                        return EXIT_FAILURE;
+                }
+                int status = batchE(pairs, count, limit, jobs > 0 ? jobs : 1,
+                                    json);
+                freePairs(pairs, count);
+                return status;
+        }
+
         FILE *i1_fp;
         FILE *i2_fp;
 
-        if (strcmp(argv[1], "-") == 0)
+        if (strcmp(argv[i], "-") == 0)
         {
                 i1_fp = stdin;
         }
         else
         {
-                i1_fp = openFile(argv[1], "r");
+                i1_fp = openFile(argv[i], "r");
         }
 
-        if (strcmp(argv[2], "-") == 0)
+        if (strcmp(argv[i + 1], "-") == 0)
         {
-                if (strcmp(argv[1], "-") == 0)
+                if (strcmp(argv[i], "-") == 0)
                 {
                         fprintf(stderr, "Can't read both inputs from stdin\n");
                         return EXIT_FAILURE;
@@ -88,15 +281,23 @@ int main(int argc, char *argv[])
         }
         else
         {
-                i2_fp = openFile(argv[2], "r");
+                i2_fp = openFile(argv[i + 1], "r");
+        }
+
+        if (compressed)
+        {
+                return compressedE(i1_fp, i2_fp, limit);
+        }
+        if (stream || limit.max_error >= 0)
+        {
+                return streamE(i1_fp, i2_fp, limit);
         }
 
         A2Methods_T methods = uarray2_methods_plain;
         Pnm_ppm image1 = Pnm_ppmread(i1_fp, methods);
         Pnm_ppm image2 = Pnm_ppmread(i2_fp, methods);
 
-        if (image1->width > image2->width + 1 ||
-            image2->width > image1->width + 1)
+        if (!closeEnough(image1->width, image2->width))
         {
                 fprintf(stderr, "Image dimensions are too different.\n");
                 return EXIT_FAILURE;
@@ -133,130 +334,926 @@ static FILE *openFile(char *fname,
         return fp;
 }
 
-/********** Wrapper ********
+/********** closeEnough ********
+ *
+ * Tells whether two images' widths are close enough to compare.
+ *
+ * Parameters:
+ *      unsigned width1:        The width of the first image.
+ *      unsigned width2:        The width of the second image.
+ *
+ * Return:
+ *      int:                    1 if the widths differ by at most 1.
+ ************************/
+static int closeEnough(unsigned width1,
+                       unsigned width2)
+{
+        return width1 <= width2 + 1 && width2 <= width1 + 1;
+}
+
+/********** computeE ********
+ *
+ * Computes the root mean square error (RMSE) between two PPM images.
+ *
+ * Parameters:
+ *      Pnm_ppm image1: A pointer to the first image.
+ *      Pnm_ppm image2: A pointer to the second image.
+ *
+ * Return:
+ *      double: The computed RMSE value.
+ *
+ * Expects:
+ *      The pointers image1 and image2 must not be NULL.
+ *      The images must have similar dimensions (width and height).
+ *
+ * Notes:
+ *      The function will compute the RMSE based on the overlapping region
+ *      of the two images, on as many threads as there are CPUs.
+ ************************/
+double computeE(Pnm_ppm image1,
+                Pnm_ppm image2)
+{
+        assert(image1 != NULL && image2 != NULL);
+
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        Rmse_sum sum = Rmse_images(image1, image2, cpus > 0 ? cpus : 1);
+        return Rmse_value(&sum, image1->denominator, image2->denominator);
+}
+
+/********** report ********
+ *
+ * Prints the error a sum stands for and tells whether it is within the
+ * limit.
+ *
+ * Parameters:
+ *      const Rmse_sum *sum:    The sum.
+ *      unsigned denom1:        The first image's denominator.
+ *      unsigned denom2:        The second image's denominator.
+ *      Limit limit:            The limit, if any.
+ *      int exceeded:           1 if the sum was cut short because the
+ *                              error is sure to exceed the limit.
+ *
+ * Return:
+ *      int:                    EXIT_FAILURE if the error exceeds the
+ *                              limit, else EXIT_SUCCESS.
+ *
+ * Notes:
+ *      An error cut short is printed as ">E", since only its lower bound
+ *      is known.
+ ************************/
+static int report(const Rmse_sum *sum,
+                  unsigned denom1,
+                  unsigned denom2,
+                  Limit limit,
+                  int exceeded)
+{
+        if (exceeded)
+        {
+                printf(">%.4f\n", limit.max_error);
+                return EXIT_FAILURE;
+        }
+
+        double e = Rmse_value(sum, denom1, denom2);
+        printf("%.4f\n", e);
+        return limit.max_error >= 0 && e > limit.max_error ? EXIT_FAILURE
+                                                         : EXIT_SUCCESS;
+}
+
+/********** estimateE ********
+ *
+ * Estimates the RMSE between two images from every stride-th row.
  *
- * A structure to hold the second image, the sum of differences,
- * and the denominator of the first image.
+ * Parameters:
+ *      Ppmrows_T image1, image2:       The images, at their first rows.
+ *      unsigned width, height:         The region to compare.
+ *      unsigned stride:                The distance between sampled rows.
+ *      double *estimate:               Where to store the estimate.
  *
- * Fields:
- *      Pnm_ppm other_image: A pointer to the second image.
- *      float diff:          The sum of squared differences.
- *      int self_denom:      The denominator of the first image.
+ * Return:
+ *      int:                            1 if an estimate was made and both
+ *                                      images are back at their first
+ *                                      rows, 0 if either image cannot seek
+ *                                      or too few rows would be sampled.
  *
  * Notes:
- *      The fields other_image and self_denom must be initialized
- *      before use. The sum field is used to accumulate the differences.
+ *      Either way, no rows have been consumed when it returns, except if
+ *      an image ends early, which the exact pass then reports.
+ ************************/
+static int estimateE(Ppmrows_T image1,
+                     Ppmrows_T image2,
+                     unsigned width,
+                     unsigned height,
+                     unsigned stride,
+                     double *estimate)
+{
+        if (stride < 2 || height / stride < MIN_SAMPLED_ROWS ||
+            !Ppmrows_seek(image1, 0) || !Ppmrows_seek(image2, 0))
+        {
+                return 0;
+        }
+
+        unsigned denom1 = Ppmrows_denominator(image1);
+        unsigned denom2 = Ppmrows_denominator(image2);
+        Rmse_sum sum = {0, 0, 0};
+        for (unsigned row = stride / 2; row < height; row += stride)
+        {
+                if (!Ppmrows_seek(image1, row) || !Ppmrows_seek(image2, row))
+                {
+                        break;
+                }
+                const struct Pnm_rgb *row1 = Ppmrows_next(image1);
+                const struct Pnm_rgb *row2 = Ppmrows_next(image2);
+                if (row1 == NULL || row2 == NULL)
+                {
+                        break;
+                }
+                Rmse_row(&sum, row1, row2, width, denom1, denom2);
+        }
+
+        *estimate = Rmse_value(&sum, denom1, denom2);
+        return Ppmrows_seek(image1, 0) && Ppmrows_seek(image2, 0);
+}
+
+/********** overlap ********
+ *
+ * Gets the region two images being read a row at a time share.
  ************************/
-typedef struct Wrapper
+static void overlap(Ppmrows_T image1,
+                    Ppmrows_T image2,
+                    unsigned *width,
+                    unsigned *height)
 {
-        Pnm_ppm other_image;
-        float diff;
-        int self_denom;
-} Wrapper;
+        *width = Ppmrows_width(image1) < Ppmrows_width(image2)
+                         ? Ppmrows_width(image1)
+                         : Ppmrows_width(image2);
+        *height = Ppmrows_height(image1) < Ppmrows_height(image2)
+                          ? Ppmrows_height(image1)
+                          : Ppmrows_height(image2);
+}
 
-/********** computeDiff ********
+/********** compareRows ********
  *
- * Computes the squared differences between the RGB values of the
- * corresponding pixels in two images and accumulates the sum.
+ * Sums the squared differences between two images a row at a time.
  *
  * Parameters:
- *      int col:                        The column index of the pixel.
- *      int row:                        The row index of the pixel.
- *      A2Methods_UArray2 array2:       The array containing the pixels of the
- *                                      first image.
- *      A2Methods_Object *ptr:          A pointer to the current pixel in the
- *                                      first image.
- *      void *cl:                       A pointer to a Wrapper structure
- *                                      containing the second image, the sum of
- *                                      squared differences, and the
- *                                      denominator of the first image.
+ *      Ppmrows_T image1:       The first image, at its first row.
+ *      Ppmrows_T image2:       The second image, at its first row.
+ *      Limit limit:            The limit to test against, if any; its
+ *                              stride is ignored.
+ *      Rmse_sum *sum:          Where to store the sum.
+ *      int *exceeded:          Set to 1 if the sum was cut short because
+ *                              the error is sure to exceed the limit.
  *
  * Return:
- *      void
+ *      const char *:           NULL, or why the images cannot be compared.
+ *
+ * Notes:
+ *      Like computeE, compares the overlapping region; rows past the
+ *      shorter image are not read, nor are rows after the error is sure
+ *      to exceed the limit.
+ ************************/
+static const char *compareRows(Ppmrows_T image1,
+                               Ppmrows_T image2,
+                               Limit limit,
+                               Rmse_sum *sum,
+                               int *exceeded)
+{
+        unsigned width, height;
+        unsigned denom1 = Ppmrows_denominator(image1);
+        unsigned denom2 = Ppmrows_denominator(image2);
+        overlap(image1, image2, &width, &height);
+        size_t samples = 3 * (size_t)width * height;
+
+        sum->exact = 0;
+        sum->scaled = 0;
+        sum->samples = 0;
+        *exceeded = 0;
+        if (!closeEnough(Ppmrows_width(image1), Ppmrows_width(image2)))
+        {
+                return "Image dimensions are too different.";
+        }
+
+        for (unsigned row = 0; row < height && !*exceeded; row++)
+        {
+                const struct Pnm_rgb *row1 = Ppmrows_next(image1);
+                const struct Pnm_rgb *row2 = Ppmrows_next(image2);
+                if (row1 == NULL || row2 == NULL)
+                {
+                        return "Input ends before its last row.";
+                }
+                Rmse_row(sum, row1, row2, width, denom1, denom2);
+                *exceeded = limit.max_error >= 0 &&
+                            Rmse_exceeds(sum, samples, denom1, denom2,
+                                         limit.max_error);
+        }
+        return NULL;
+}
+
+/********** streamE ********
+ *
+ * Computes and prints the RMSE between two PPM streams, reading a row of
+ * each at a time.
+ *
+ * Parameters:
+ *      FILE *i1_fp:    The first image.
+ *      FILE *i2_fp:    The second image.
+ *      Limit limit:    The limit to test against, if any.
+ *
+ * Return:
+ *      int:            EXIT_SUCCESS, or EXIT_FAILURE if either stream is
+ *                      not a PPM, the widths are too different or the
+ *                      error exceeds the limit.
  *
  * Expects:
- *      The pointers array2 and cl must not be NULL.
- *      The pixel coordinates (col, row) must be within the bounds of the
- *      first image.
+ *      i1_fp and i2_fp must not be NULL.
  *
  * Notes:
- *      The function will not compute differences for pixels that are out of
- *      bounds in the second image.
+ *      Will CRE if any expectation is violated.
+ *      An estimate far enough from the limit is printed as "~e".
  ************************/
-void computeDiff(int col,
-                 int row,
-                 A2Methods_UArray2 array2,
-                 A2Methods_Object *ptr,
-                 void *cl)
+static int streamE(FILE *i1_fp,
+                   FILE *i2_fp,
+                   Limit limit)
 {
-        assert(cl != NULL);
-        assert(array2 != NULL);
-        Wrapper *w = cl;
-
-        /* Check if the pixel is out of bounds in the other image */
-        Pnm_ppm other_image = w->other_image;
-        if ((unsigned int)col >= other_image->width ||
-            (unsigned int)row >= other_image->height)
-        {
-                return;
-        }
-
-        /* Get the RGB values of the current pixel in both images */
-        Pnm_rgb rgb_self = (Pnm_rgb)ptr;
-        Pnm_rgb rgb_other = other_image->methods->at(other_image->pixels,
-                                                     col,
-                                                     row);
-        float self_denom = (float)w->self_denom;
-        float other_denom = (float)other_image->denominator;
-
-        /* Compute the differences in the RGB values */
-        float r_diff = ((float)rgb_self->red / self_denom) -
-                       ((float)rgb_other->red / other_denom);
-        float g_diff = ((float)rgb_self->green / self_denom) -
-                       ((float)rgb_other->green / other_denom);
-        float b_diff = ((float)rgb_self->blue / self_denom) -
-                       ((float)rgb_other->blue / other_denom);
-
-        float diff = (r_diff * r_diff) +
-                     (g_diff * g_diff) +
-                     (b_diff * b_diff);
-
-        w->diff += diff;
+        assert(i1_fp != NULL && i2_fp != NULL);
+
+        Ppmrows_T image1 = Ppmrows_new(i1_fp);
+        Ppmrows_T image2 = Ppmrows_new(i2_fp);
+        if (image1 == NULL || image2 == NULL)
+        {
+                fprintf(stderr, "Input is not a PPM image.\n");
+                return EXIT_FAILURE;
+        }
+
+        unsigned width, height;
+        overlap(image1, image2, &width, &height);
+        unsigned denom1 = Ppmrows_denominator(image1);
+        unsigned denom2 = Ppmrows_denominator(image2);
+        Rmse_sum sum;
+        int status, exceeded;
+        double estimate;
+
+        if (limit.max_error >= 0 &&
+            closeEnough(Ppmrows_width(image1), Ppmrows_width(image2)) &&
+            estimateE(image1, image2, width, height, limit.stride,
+                      &estimate) &&
+            fabs(estimate - limit.max_error) >
+                    SAMPLE_MARGIN * limit.max_error)
+        {
+                printf("~%.4f\n", estimate);
+                status = estimate > limit.max_error ? EXIT_FAILURE
+                                                    : EXIT_SUCCESS;
+        }
+        else
+        {
+                const char *error = compareRows(image1, image2, limit, &sum,
+                                                &exceeded);
+                if (error != NULL)
+                {
+                        fprintf(stderr, "%s\n", error);
+                        return EXIT_FAILURE;
+                }
+                status = report(&sum, denom1, denom2, limit, exceeded);
+        }
+
+        Ppmrows_free(&image1);
+        Ppmrows_free(&image2);
+        return status;
 }
 
-/********** computeE ********
+/********** compressedE ********
  *
- * Computes the root mean square error (RMSE) between two PPM images.
+ * Computes and prints the RMSE between a PPM and a compressed image,
+ * decoding the compressed image a row of blocks at a time and comparing
+ * each pair of decoded rows as it is made.
  *
  * Parameters:
- *      Pnm_ppm image1: A pointer to the first image.
- *      Pnm_ppm image2: A pointer to the second image.
+ *      FILE *orig_fp:          The original PPM.
+ *      FILE *compressed_fp:    The compressed image.
+ *      Limit limit:            The limit to test against, if any; its
+ *                              stride is ignored.
  *
  * Return:
- *      float: The computed RMSE value.
+ *      int:                    EXIT_SUCCESS, or EXIT_FAILURE if either
+ *                              input is malformed, the widths are too
+ *                              different or the error exceeds the limit.
  *
  * Expects:
- *      The pointers image1 and image2 must not be NULL.
- *      The images must have similar dimensions (width and height).
+ *      orig_fp and compressed_fp must not be NULL.
  *
  * Notes:
- *      The function will compute the RMSE based on the overlapping region
- *      of the two images.
+ *      Will CRE if any expectation is violated.
+ *      Decodes with the codec's active kernels, so the pixels compared
+ *      are exactly those 40image -d would write.
+ *      Only the codewords are held, at one byte per pixel; they are
+ *      stored a column at a time, so they are reordered into rows first.
  ************************/
-float computeE(Pnm_ppm image1,
-               Pnm_ppm image2)
+static int compressedE(FILE *orig_fp,
+                       FILE *compressed_fp,
+                       Limit limit)
 {
-        assert(image1 != NULL && image2 != NULL);
+        assert(orig_fp != NULL && compressed_fp != NULL);
 
-        /* Get the minimum width and height of the two images */
-        int min_width = image1->width > image2->width ? image2->width
-                                                      : image1->width;
-        int min_height = image1->height > image2->height ? image2->height
-                                                         : image1->height;
+        unsigned width, height;
+        Ppmrows_T orig = Ppmrows_new(orig_fp);
+        if (orig == NULL ||
+            fscanf(compressed_fp, "COMP40 Compressed image format 2\n%u %u",
+                   &width, &height) != 2 || getc(compressed_fp) != '\n')
+        {
+                fprintf(stderr, "Input is not a PPM and a compressed "
+                        "image.\n");
+                if (orig != NULL)
+                {
+                        Ppmrows_free(&orig);
+                }
+                return EXIT_FAILURE;
+        }
+        if (!closeEnough(Ppmrows_width(orig), width))
+        {
+                fprintf(stderr, "Image dimensions are too different.\n");
+                Ppmrows_free(&orig);
+                return EXIT_FAILURE;
+        }
+
+        /* Read every codeword, then reorder them a row of blocks at a time */
+        size_t cols = width / 2, rows = height / 2;
+        unsigned char *bytes = ALLOC(4 * cols * rows + 1);
+        uint32_t *words = ALLOC(4 * cols * rows + 4);
+        if (fread(bytes, 4, cols * rows, compressed_fp) != cols * rows)
+        {
+                fprintf(stderr, "Compressed image ends early.\n");
+                FREE(bytes);
+                FREE(words);
+                Ppmrows_free(&orig);
+                return EXIT_FAILURE;
+        }
+        for (size_t col = 0; col < cols; col++)
+        {
+                for (size_t row = 0; row < rows; row++)
+                {
+                        unsigned char *word = bytes + 4 * (col * rows + row);
+                        words[row * cols + col] = (uint32_t)word[0] << 24 |
+                                                  (uint32_t)word[1] << 16 |
+                                                  (uint32_t)word[2] << 8 |
+                                                  word[3];
+                }
+        }
+        FREE(bytes);
+
+        /* A two-row frame, and the two rows of pixels decoded from it */
+        JobArena_T arena = JobArena_new(4096);
+        Frame frame = Frame_arena_new(arena, 2 * cols, 2);
+        struct Pnm_rgb *decoded = JobArena_alloc(arena, 2 * 2 * cols *
+                                                 sizeof(*decoded) + 1);
+        Kernels kernels = Kernels_active();
 
-        Wrapper w = {image2, 0, image1->denominator};
-        image1->methods->map_row_major(image1->pixels, computeDiff, &w);
-        float denom = 3 * min_width * min_height;
+        unsigned compare = Ppmrows_width(orig) < width ? Ppmrows_width(orig)
+                                                       : width;
+        unsigned denom = Ppmrows_denominator(orig);
+        size_t compare_rows = Ppmrows_height(orig) < 2 * rows
+                                      ? Ppmrows_height(orig)
+                                      : 2 * rows;
+        Rmse_sum sum = {0, 0, 0};
+        int status = EXIT_SUCCESS, exceeded = 0;
 
-        return sqrt(w.diff / denom);
-}
\ No newline at end of file
+        for (size_t row = 0; 2 * row < compare_rows && !exceeded; row++)
+        {
+                for (size_t col = 0; col < cols; col++)
+                {
+                        kernels->decode_blocks(frame, &words[row * cols + col],
+                                               col, 1);
+                }
+                for (size_t half = 0; half < 2; half++)
+                {
+                        const struct Pnm_rgb *pixels = Ppmrows_next(orig);
+                        if (pixels == NULL)
+                        {
+                                break;
+                        }
+                        size_t at = half * frame->stride;
+                        struct Pnm_rgb *line = decoded + half * 2 * cols;
+                        kernels->frame_to_rgb(line, frame->Y + at,
+                                              frame->P_b + at,
+                                              frame->P_r + at, 2 * cols, 255);
+                        Rmse_row(&sum, pixels, line, compare, denom, 255);
+                }
+                exceeded = limit.max_error >= 0 &&
+                           Rmse_exceeds(&sum, 3 * (size_t)compare * compare_rows,
+                                        denom, 255, limit.max_error);
+        }
+        if (!exceeded && sum.samples != 3 * (size_t)compare * compare_rows)
+        {
+                fprintf(stderr, "Input ends before its last row.\n");
+                status = EXIT_FAILURE;
+        }
+        else
+        {
+                status = report(&sum, denom, 255, limit, exceeded);
+        }
+
+        JobArena_free(&arena);
+        FREE(words);
+        Ppmrows_free(&orig);
+        return status;
+}
+
+/********** comparePair ********
+ *
+ * Compares one pair of a batch, reading both images a row at a time.
+ *
+ * Parameters:
+ *      Pair *pair:             The pair, whose results are filled in.
+ *      Ppmrows_T *image1:      A reader to reuse for the first image, or a
+ *                              pointer to NULL to make one.
+ *      Ppmrows_T *image2:      Likewise for the second image.
+ *      Limit limit:            The limit to test against, if any.
+ *
+ * Notes:
+ *      Readers are reset rather than remade, so a worker allocates row
+ *      buffers only when it meets a wider image than any before.
+ ************************/
+static void comparePair(Pair *pair,
+                        Ppmrows_T *image1,
+                        Ppmrows_T *image2,
+                        Limit limit)
+{
+        uint64_t start = Timer_ns();
+        FILE *i1_fp = fopen(pair->path1, "r");
+        FILE *i2_fp = fopen(pair->path2, "r");
+
+        if (i1_fp == NULL || i2_fp == NULL)
+        {
+                pair->error = "Cannot open both images.";
+        }
+        else if (*image1 == NULL ? (*image1 = Ppmrows_new(i1_fp)) == NULL
+                                 : !Ppmrows_reset(*image1, i1_fp))
+        {
+                pair->error = "Input is not a PPM image.";
+        }
+        else if (*image2 == NULL ? (*image2 = Ppmrows_new(i2_fp)) == NULL
+                                 : !Ppmrows_reset(*image2, i2_fp))
+        {
+                pair->error = "Input is not a PPM image.";
+        }
+        else
+        {
+                unsigned denom1 = Ppmrows_denominator(*image1);
+                unsigned denom2 = Ppmrows_denominator(*image2);
+                overlap(*image1, *image2, &pair->width, &pair->height);
+                pair->error = compareRows(*image1, *image2, limit, &pair->sum,
+                                          &pair->exceeded);
+                pair->rmse = pair->exceeded
+                                     ? limit.max_error
+                                     : Rmse_value(&pair->sum, denom1, denom2);
+                pair->exceeded |= limit.max_error >= 0 &&
+                                  pair->rmse > limit.max_error;
+        }
+
+        if (i1_fp != NULL)
+        {
+                fclose(i1_fp);
+        }
+        if (i2_fp != NULL)
+        {
+                fclose(i2_fp);
+        }
+        pair->ms = (Timer_ns() - start) / 1e6;
+}
+
+/********** batchWorker ********
+ *
+ * Thread pool job: takes pairs from a batch until none are left.
+ *
+ * Parameters:
+ *      void *arg:      The Batch.
+ ************************/
+static void batchWorker(void *arg)
+{
+        Batch *batch = arg;
+        Ppmrows_T image1 = NULL, image2 = NULL;
+
+        for (;;)
+        {
+                size_t k = __atomic_fetch_add(&batch->next, 1,
+                                              __ATOMIC_RELAXED);
+                if (k >= batch->count)
+                {
+                        break;
+                }
+                comparePair(&batch->pairs[k], &image1, &image2, batch->limit);
+        }
+
+        if (image1 != NULL)
+        {
+                Ppmrows_free(&image1);
+        }
+        if (image2 != NULL)
+        {
+                Ppmrows_free(&image2);
+        }
+}
+
+/********** jsonString ********
+ *
+ * Writes a string as a JSON string literal.
+ ************************/
+static void jsonString(FILE *fp,
+                       const char *s)
+{
+        putc('"', fp);
+        for (; *s != '\0'; s++)
+        {
+                unsigned char c = *s;
+                if (c == '"' || c == '\\')
+                {
+                        fprintf(fp, "\\%c", c);
+                }
+                else if (c < 0x20)
+                {
+                        fprintf(fp, "\\u%04x", c);
+                }
+                else
+                {
+                        putc(c, fp);
+                }
+        }
+        putc('"', fp);
+}
+
+/********** writeJson ********
+ *
+ * Writes a batch's per-pair results and summary as JSON.
+ *
+ * Parameters:
+ *      FILE *fp:               Where to write.
+ *      const Pair *pairs:      The compared pairs.
+ *      size_t count:           The number of pairs.
+ *      Limit limit:            The limit they were tested against, if any.
+ *      int jobs:               The number of workers.
+ *      size_t compared:        The pairs compared without error.
+ *      size_t failed:          The pairs over the limit.
+ *      double mean, max:       The mean and largest error of those pairs.
+ *      double pooled:          The error over every sample of those pairs.
+ *      double ms:              How long the batch took.
+ ************************/
+static void writeJson(FILE *fp,
+                      const Pair *pairs,
+                      size_t count,
+                      Limit limit,
+                      int jobs,
+                      size_t compared,
+                      size_t failed,
+                      double mean,
+                      double max,
+                      double pooled,
+                      double ms)
+{
+        fprintf(fp, "{\"jobs\": %d, \"max_error\": ", jobs);
+        if (limit.max_error >= 0)
+        {
+                fprintf(fp, "%.6f", limit.max_error);
+        }
+        else
+        {
+                fprintf(fp, "null");
+        }
+        fprintf(fp, ",\n \"pairs\": [\n");
+        for (size_t k = 0; k < count; k++)
+        {
+                const Pair *pair = &pairs[k];
+                fprintf(fp, "    {\"name\": ");
+                jsonString(fp, pair->name);
+                fprintf(fp, ", \"image1\": ");
+                jsonString(fp, pair->path1);
+                fprintf(fp, ", \"image2\": ");
+                jsonString(fp, pair->path2);
+                if (pair->error != NULL)
+                {
+                        fprintf(fp, ", \"error\": ");
+                        jsonString(fp, pair->error);
+                }
+                else
+                {
+                        fprintf(fp, ", \"width\": %u, \"height\": %u, "
+                                "\"rmse\": %.6f, \"exceeded\": %s",
+                                pair->width, pair->height, pair->rmse,
+                                pair->exceeded ? "true" : "false");
+                }
+                fprintf(fp, ", \"ms\": %.3f}%s\n", pair->ms,
+                        k + 1 < count ? "," : "");
+        }
+        fprintf(fp, " ],\n \"summary\": {\"pairs\": %zu, \"compared\": %zu, "
+                "\"errors\": %zu, \"exceeded\": %zu,\n  \"mean_rmse\": %.6f, "
+                "\"max_rmse\": %.6f, \"pooled_rmse\": %.6f, \"ms\": %.3f}}\n",
+                count, compared, count - compared, failed, mean, max, pooled,
+                ms);
+}
+
+/********** batchE ********
+ *
+ * Compares every pair of a batch on a pool of workers, then prints a
+ * table of the results and a summary.
+ *
+ * Parameters:
+ *      Pair *pairs:            The pairs to compare.
+ *      size_t count:           The number of pairs.
+ *      Limit limit:            The limit to test every pair against, if
+ *                              any; its stride is ignored.
+ *      int jobs:               The number of workers.
+ *      const char *json:       A file to write the results to as JSON, or
+ *                              NULL.
+ *
+ * Return:
+ *      int:                    EXIT_SUCCESS, or EXIT_FAILURE if any pair
+ *                              could not be compared or exceeds the limit,
+ *                              or the JSON file cannot be written.
+ *
+ * Expects:
+ *      pairs must not be NULL if count > 0, and jobs must be positive.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Workers take the next pair as they finish one, so a few large
+ *      images do not hold up the rest; each keeps its own pair of readers
+ *      for the whole batch.
+ *      The pooled error weighs every sample of every compared pair alike,
+ *      where the mean weighs every pair alike. A pair cut short by the
+ *      limit counts as having the limit for its error.
+ ************************/
+static int batchE(Pair *pairs,
+                  size_t count,
+                  Limit limit,
+                  int jobs,
+                  const char *json)
+{
+        assert((pairs != NULL || count == 0) && jobs > 0);
+
+        Batch batch = {pairs, count, 0, limit};
+        uint64_t start = Timer_ns();
+        if (jobs > 1 && count > 1)
+        {
+                ThreadPool_T pool = ThreadPool_new(jobs);
+                for (int j = 0; j < jobs; j++)
+                {
+                        ThreadPool_submit(pool, batchWorker, &batch);
+                }
+                ThreadPool_wait(pool);
+                ThreadPool_free(&pool);
+        }
+        else
+        {
+                batchWorker(&batch);
+        }
+        double ms = (Timer_ns() - start) / 1e6;
+
+        size_t compared = 0, failed = 0;
+        double total = 0, max = 0, pooled_squares = 0, pooled_samples = 0;
+        printf("%-32s %7s %7s %10s  %s\n", "pair", "width", "height", "rmse",
+               "status");
+        for (size_t k = 0; k < count; k++)
+        {
+                Pair *pair = &pairs[k];
+                if (pair->error != NULL)
+                {
+                        printf("%-32s %7s %7s %10s  %s\n", pair->name, "-",
+                               "-", "-", pair->error);
+                        continue;
+                }
+                printf("%-32s %7u %7u %s%9.4f  %s\n", pair->name, pair->width,
+                       pair->height, pair->exceeded && pair->sum.samples <
+                       3 * (size_t)pair->width * pair->height ? ">" : " ",
+                       pair->rmse, pair->exceeded ? "over limit" : "ok");
+
+                compared++;
+                failed += pair->exceeded;
+                total += pair->rmse;
+                max = pair->rmse > max ? pair->rmse : max;
+                pooled_squares += pair->rmse * pair->rmse *
+                                  pair->sum.samples;
+                pooled_samples += pair->sum.samples;
+        }
+
+        double mean = compared > 0 ? total / compared : 0;
+        double pooled = pooled_samples > 0
+                                ? sqrt(pooled_squares / pooled_samples)
+                                : 0;
+        printf("\n%zu pairs, %zu compared, %zu errors, %zu over limit\n",
+               count, compared, count - compared, failed);
+        printf("rmse: mean %.4f, max %.4f, pooled %.4f\n", mean, max, pooled);
+        printf("%.1f ms on %d workers\n", ms, jobs);
+
+        int status = compared == count && failed == 0 ? EXIT_SUCCESS
+                                                       : EXIT_FAILURE;
+        if (json != NULL)
+        {
+                FILE *fp = fopen(json, "w");
+                if (fp == NULL)
+                {
+                        fprintf(stderr, "Cannot write %s\n", json);
+                        return EXIT_FAILURE;
+                }
+                writeJson(fp, pairs, count, limit, jobs, compared, failed,
+                          mean, max, pooled, ms);
+                fclose(fp);
+        }
+        return status;
+}
+
+/********** joinPath ********
+ *
+ * Joins a directory and a file name into a new string, which the client
+ * must FREE.
+ ************************/
+static char *joinPath(const char *dir,
+                      const char *name)
+{
+        size_t len = strlen(dir) + 1 + strlen(name) + 1;
+        char *path = ALLOC(len);
+        snprintf(path, len, "%s/%s", dir, name);
+        return path;
+}
+
+/********** copyString ********
+ *
+ * Copies a string into a new string, which the client must FREE.
+ ************************/
+static char *copyString(const char *s)
+{
+        char *copy = ALLOC(strlen(s) + 1);
+        strcpy(copy, s);
+        return copy;
+}
+
+/********** addPair ********
+ *
+ * Appends a pair to a growing array, doubling it when it is full.
+ ************************/
+static void addPair(Pair **pairs,
+                    size_t *count,
+                    size_t *capacity,
+                    char *name,
+                    char *path1,
+                    char *path2)
+{
+        if (*count == *capacity)
+        {
+                *capacity = *capacity > 0 ? 2 * *capacity : 16;
+                RESIZE(*pairs, *capacity * sizeof(**pairs));
+        }
+        Pair *pair = &(*pairs)[(*count)++];
+        memset(pair, 0, sizeof(*pair));
+        pair->name = name;
+        pair->path1 = path1;
+        pair->path2 = path2;
+}
+
+/********** comparePairNames ********
+ *
+ * Orders pairs by name, for qsort.
+ ************************/
+static int comparePairNames(const void *a,
+                            const void *b)
+{
+        return strcmp(((const Pair *)a)->name, ((const Pair *)b)->name);
+}
+
+/********** dirPairs ********
+ *
+ * Pairs every regular file in one directory with the file of the same
+ * name in another.
+ *
+ * Parameters:
+ *      const char *dir1:       The first directory.
+ *      const char *dir2:       The second directory.
+ *      size_t *count:          Where to store the number of pairs.
+ *
+ * Return:
+ *      Pair *:                 The pairs, sorted by name, or NULL if dir1
+ *                              cannot be read.
+ *
+ * Expects:
+ *      dir1, dir2 and count must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Hidden files are skipped. A file missing from dir2 still makes a
+ *      pair, which then reports that it cannot be opened.
+ *      Client is responsible for freeing the pairs with freePairs.
+ ************************/
+static Pair *dirPairs(const char *dir1,
+                      const char *dir2,
+                      size_t *count)
+{
+        assert(dir1 != NULL && dir2 != NULL && count != NULL);
+
+        DIR *dir = opendir(dir1);
+        if (dir == NULL)
+        {
+                fprintf(stderr, "Cannot read directory %s\n", dir1);
+                return NULL;
+        }
+
+        Pair *pairs = ALLOC(1);
+        size_t capacity = 0;
+        *count = 0;
+        for (struct dirent *entry = readdir(dir); entry != NULL;
+             entry = readdir(dir))
+        {
+                struct stat info;
+                char *path1 = joinPath(dir1, entry->d_name);
+                if (entry->d_name[0] == '.' || stat(path1, &info) != 0 ||
+                    !S_ISREG(info.st_mode))
+                {
+                        FREE(path1);
+                        continue;
+                }
+                addPair(&pairs, count, &capacity, copyString(entry->d_name),
+                        path1, joinPath(dir2, entry->d_name));
+        }
+        closedir(dir);
+
+        qsort(pairs, *count, sizeof(*pairs), comparePairNames);
+        return pairs;
+}
+
+/********** manifestPairs ********
+ *
+ * Reads the pairs listed in a manifest, one "image1 image2" per line.
+ *
+ * Parameters:
+ *      const char *manifest:   The manifest file.
+ *      size_t *count:          Where to store the number of pairs.
+ *
+ * Return:
+ *      Pair *:                 The pairs, in manifest order and named by
+ *                              their first image, or NULL if the manifest
+ *                              cannot be read or has a malformed line.
+ *
+ * Expects:
+ *      manifest and count must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Blank lines and lines starting with '#' are skipped. Paths cannot
+ *      contain whitespace.
+ *      Client is responsible for freeing the pairs with freePairs.
+ ************************/
+static Pair *manifestPairs(const char *manifest,
+                           size_t *count)
+{
+        assert(manifest != NULL && count != NULL);
+
+        FILE *fp = fopen(manifest, "r");
+        if (fp == NULL)
+        {
+                fprintf(stderr, "Cannot read manifest %s\n", manifest);
+                return NULL;
+        }
+
+        Pair *pairs = ALLOC(1);
+        size_t capacity = 0;
+        char *line = NULL;
+        size_t line_capacity = 0;
+        unsigned number = 0;
+        *count = 0;
+        while (getline(&line, &line_capacity, fp) != -1)
+        {
+                char *path1 = strtok(line, " \t\r\n");
+                char *path2 = path1 == NULL ? NULL : strtok(NULL, " \t\r\n");
+                number++;
+                if (path1 == NULL || path1[0] == '#')
+                {
+                        continue;
+                }
+                if (path2 == NULL || strtok(NULL, " \t\r\n") != NULL)
+                {
+                        fprintf(stderr, "%s:%u: expected two images\n",
+                                manifest, number);
+                        free(line);
+                        fclose(fp);
+                        freePairs(pairs, *count);
+                        return NULL;
+                }
+                addPair(&pairs, count, &capacity, copyString(path1),
+                        copyString(path1), copyString(path2));
+        }
+        free(line);
+        fclose(fp);
+        return pairs;
+}
+
+/********** freePairs ********
+ *
+ * Frees the pairs made by dirPairs or manifestPairs.
+ ************************/
+static void freePairs(Pair *pairs,
+                      size_t count)
+{
+        for (size_t k = 0; k < count; k++)
+        {
+                FREE(pairs[k].name);
+                FREE(pairs[k].path1);
+                FREE(pairs[k].path2);
+        }
+        FREE(pairs);
+}
@@ -0,0 +1,127 @@
+/**************************************************************
+ *
+ *                     ppmgen.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     A deterministic synthetic image generator for benchmarks. Writes a
+ *     binary PPM of a given kind, size and maxval to stdout; the same
+ *     arguments always give the same bytes. Images are generated one row
+ *     at a time, so even 16384 x 16384 needs only one row of memory.
+ *
+ *     Kinds:
+ *             flat       one solid color
+ *             gradient   smooth ramps in each channel
+ *             noise      independent uniform noise per sample
+ *             fractal    multi-octave value noise, like photographic
+ *                        texture
+ *             text       dark glyph-like strokes on a light background,
+ *                        with hard edges
+ *
+ *     Usage: ppmgen [-m maxval] [-s seed] kind width height
+ *            ppmgen -c directory
+ *            -c writes the standard corpus (every kind at several sizes
+ *            and maxvals) into directory.
+ *
+ ************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ppmsynth.h"
+
+#define MAX_DIMENSION 16384
+
+static const unsigned CORPUS_SIZES[] = {256, 1024, 4096};
+static const unsigned CORPUS_MAXVALS[] = {255, 1023, 65535};
+
+/********** write_corpus ********
+ *
+ * Writes every kind at every corpus size and maxval, with seed 0, to
+ * files named kind-size-maxval.ppm.
+ *
+ * Parameters:
+ *      const char *dir:     The directory to write to, which must exist.
+ *
+ * Return:
+ *      int:                 EXIT_SUCCESS, or EXIT_FAILURE if a file could
+ *                           not be written.
+ ************************/
+static int write_corpus(const char *dir)
+{
+        for (int k = 0; k < PPMSYNTH_NKINDS; k++) {
+                for (size_t s = 0; s < sizeof(CORPUS_SIZES) /
+                     sizeof(CORPUS_SIZES[0]); s++) {
+                        for (size_t m = 0; m < sizeof(CORPUS_MAXVALS) /
+                             sizeof(CORPUS_MAXVALS[0]); m++) {
+                                char path[4096];
+                                snprintf(path, sizeof(path),
+                                         "%s/%s-%u-%u.ppm", dir,
+                                         Ppmsynth_name(k),
+                                         CORPUS_SIZES[s], CORPUS_MAXVALS[m]);
+                                FILE *out = fopen(path, "wb");
+                                if (out == NULL) {
+                                        perror(path);
+                                        return EXIT_FAILURE;
+                                }
+                                Ppmsynth_write(out, k, CORPUS_SIZES[s],
+                                               CORPUS_SIZES[s],
+                                               CORPUS_MAXVALS[m], 0);
+                                fclose(out);
+                        }
+                }
+        }
+        return EXIT_SUCCESS;
+}
+
+/********** usage ********
+ *
+ * Prints the usage message and exits with status 1.
+ ************************/
+static void usage(const char *program)
+{
+        fprintf(stderr, "Usage: %s [-m maxval] [-s seed] kind width height\n"
+                "       %s -c directory\n"
+                "Kinds: flat, gradient, noise, fractal, text\n",
+                program, program);
+        exit(1);
+}
+
+int main(int argc, char *argv[])
+{
+        unsigned long maxval = 255;
+        uint64_t seed = 0;
+        int i;
+
+        for (i = 1; i < argc; i++) {
+                if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+                        maxval = strtoul(argv[++i], NULL, 10);
+                } else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+                        seed = strtoull(argv[++i], NULL, 10);
+                } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
+                        return write_corpus(argv[i + 1]);
+                } else if (*argv[i] == '-') {
+                        usage(argv[0]);
+                } else {
+                        break;
+                }
+        }
+        if (argc - i != 3 || maxval < 1 || maxval > 65535) {
+                usage(argv[0]);
+        }
+
+        int kind = Ppmsynth_find(argv[i]);
+        unsigned long width = strtoul(argv[i + 1], NULL, 10);
+        unsigned long height = strtoul(argv[i + 2], NULL, 10);
+        if (kind < 0 || width < 1 || height < 1 ||
+            width > MAX_DIMENSION || height > MAX_DIMENSION) {
+                usage(argv[0]);
+        }
+
+        Ppmsynth_write(stdout, kind, width, height, maxval, seed);
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,346 @@
+/**************************************************************
+ *
+ *                     ppmrows.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for reading a PPM a row at a
+ *     time. A raw row is read with one fread into a byte buffer and then
+ *     widened into the pixel buffer; a plain row is read sample by sample.
+ *
+ ************************/
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "ppmrows.h"
+
+/* The widest image accepted, so that row buffers stay reasonable */
+#define MAX_WIDTH (1u << 24)
+
+/********** Ppmrows_T ********
+ *
+ * A PPM being read a row at a time.
+ *
+ * Elements:
+ *      FILE *fp:               The stream.
+ *      int raw:                1 for P6, 0 for P3.
+ *      unsigned width, height: The dimensions.
+ *      unsigned denominator:   The maximum sample value.
+ *      unsigned next_row:      The number of the next row to read.
+ *      long start:             The offset of the first raw row, or -1 if
+ *                              it is unknown.
+ *      unsigned char *bytes:   A raw row as read.
+ *      struct Pnm_rgb *pixels: The row last read.
+ *      size_t bytes_capacity:  The size of bytes.
+ *      size_t pixels_capacity: The number of pixels pixels can hold.
+ ************************/
+struct Ppmrows_T
+{
+        FILE *fp;
+        int raw;
+        unsigned width, height;
+        unsigned denominator;
+        unsigned next_row;
+        long start;
+        unsigned char *bytes;
+        struct Pnm_rgb *pixels;
+        size_t bytes_capacity;
+        size_t pixels_capacity;
+};
+
+/********** read_number ********
+ *
+ * Reads an unsigned decimal header field, skipping whitespace and
+ * comments before it.
+ *
+ * Return:
+ *      int:    1 if a number was read into *value, else 0.
+ ************************/
+static int read_number(FILE *fp, unsigned *value)
+{
+        int c = getc(fp);
+        while (c == '#' || isspace(c))
+        {
+                if (c == '#')
+                {
+                        while (c != '\n' && c != EOF)
+                        {
+                                c = getc(fp);
+                        }
+                }
+                c = getc(fp);
+        }
+        if (!isdigit(c))
+        {
+                return 0;
+        }
+
+        unsigned long n = 0;
+        for (; isdigit(c); c = getc(fp))
+        {
+                n = n * 10 + (c - '0');
+                if (n > 0xFFFFFFFFul)
+                {
+                        return 0;
+                }
+        }
+        ungetc(c, fp);
+        *value = n;
+        return 1;
+}
+
+/********** Ppmrows_new ********
+ *
+ * Reads a PPM header.
+ *
+ * Parameters:
+ *      FILE *fp:       The stream to read.
+ *
+ * Return:
+ *      Ppmrows_T:      A reader positioned at the first row, or NULL if
+ *                      the header is not a valid PPM header.
+ *
+ * Expects:
+ *      fp must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Client is responsible for freeing the reader with Ppmrows_free; the
+ *      stream is left open.
+ ************************/
+Ppmrows_T Ppmrows_new(FILE *fp)
+{
+        assert(fp != NULL);
+
+        Ppmrows_T rows;
+        NEW(rows);
+        rows->bytes = NULL;
+        rows->pixels = NULL;
+        rows->bytes_capacity = 0;
+        rows->pixels_capacity = 0;
+        if (!Ppmrows_reset(rows, fp))
+        {
+                Ppmrows_free(&rows);
+        }
+        return rows;
+}
+
+/********** Ppmrows_reset ********
+ *
+ * Reads a new PPM header into an existing reader, keeping its buffers
+ * when they are big enough.
+ *
+ * Parameters:
+ *      Ppmrows_T rows:         The reader.
+ *      FILE *fp:               The stream to read.
+ *
+ * Return:
+ *      int:                    1 if the header is valid and the reader is
+ *                              positioned at the first row, else 0 (and
+ *                              the reader has no rows).
+ *
+ * Expects:
+ *      rows and fp must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Ppmrows_reset(Ppmrows_T rows, FILE *fp)
+{
+        assert(rows != NULL && fp != NULL);
+        rows->fp = fp;
+        rows->height = 0;
+        rows->next_row = 0;
+        rows->start = -1;
+
+        int p = getc(fp), kind = getc(fp);
+        unsigned width, height, denominator;
+        if (p != 'P' || (kind != '3' && kind != '6') ||
+            !read_number(fp, &width) || !read_number(fp, &height) ||
+            !read_number(fp, &denominator))
+        {
+                return 0;
+        }
+        if (width == 0 || width > MAX_WIDTH || height == 0 ||
+            denominator == 0 || denominator > 65535)
+        {
+                return 0;
+        }
+        /* One whitespace character separates the header from raw samples */
+        if (kind == '6' && !isspace(getc(fp)))
+        {
+                return 0;
+        }
+
+        rows->raw = kind == '6';
+        rows->width = width;
+        rows->height = height;
+        rows->denominator = denominator;
+        rows->start = rows->raw ? ftell(fp) : -1;
+
+        size_t bytes = rows->raw ? 3 * (size_t)width *
+                                           (denominator > 255 ? 2 : 1)
+                                 : 0;
+        if (bytes > rows->bytes_capacity)
+        {
+                FREE(rows->bytes);
+                rows->bytes = ALLOC(bytes);
+                rows->bytes_capacity = bytes;
+        }
+        if (width > rows->pixels_capacity)
+        {
+                FREE(rows->pixels);
+                rows->pixels = ALLOC(width * sizeof *rows->pixels);
+                rows->pixels_capacity = width;
+        }
+        return 1;
+}
+
+unsigned Ppmrows_width(Ppmrows_T rows)
+{
+        assert(rows != NULL);
+        return rows->width;
+}
+
+unsigned Ppmrows_height(Ppmrows_T rows)
+{
+        assert(rows != NULL);
+        return rows->height;
+}
+
+unsigned Ppmrows_denominator(Ppmrows_T rows)
+{
+        assert(rows != NULL);
+        return rows->denominator;
+}
+
+/********** Ppmrows_next ********
+ *
+ * Reads the next row.
+ *
+ * Parameters:
+ *      Ppmrows_T rows:         The reader.
+ *
+ * Return:
+ *      const struct Pnm_rgb *: The row's Ppmrows_width pixels, valid until
+ *                              the next call, or NULL if every row has been
+ *                              read or the stream ends early.
+ *
+ * Expects:
+ *      rows must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+const struct Pnm_rgb *Ppmrows_next(Ppmrows_T rows)
+{
+        assert(rows != NULL);
+        if (rows->next_row == rows->height)
+        {
+                return NULL;
+        }
+
+        unsigned *samples = &rows->pixels[0].red;
+        size_t n = 3 * (size_t)rows->width;
+        if (rows->raw && rows->denominator <= 255)
+        {
+                if (fread(rows->bytes, 1, n, rows->fp) != n)
+                {
+                        return NULL;
+                }
+                for (size_t i = 0; i < n; i++)
+                {
+                        samples[i] = rows->bytes[i];
+                }
+        }
+        else if (rows->raw)
+        {
+                if (fread(rows->bytes, 2, n, rows->fp) != n)
+                {
+                        return NULL;
+                }
+                for (size_t i = 0; i < n; i++)
+                {
+                        samples[i] = rows->bytes[2 * i] << 8 |
+                                     rows->bytes[2 * i + 1];
+                }
+        }
+        else
+        {
+                for (size_t i = 0; i < n; i++)
+                {
+                        if (!read_number(rows->fp, &samples[i]) ||
+                            samples[i] > rows->denominator)
+                        {
+                                return NULL;
+                        }
+                }
+        }
+        rows->next_row++;
+        return rows->pixels;
+}
+
+/********** Ppmrows_seek ********
+ *
+ * Moves a reader so that the next row read is a given row.
+ *
+ * Parameters:
+ *      Ppmrows_T rows:         The reader.
+ *      unsigned row:           The row to read next.
+ *
+ * Return:
+ *      int:                    1 if the reader moved, 0 if it cannot seek:
+ *                              the image is plain (P3) or the stream is
+ *                              not seekable, such as a pipe.
+ *
+ * Expects:
+ *      rows must not be NULL, and row must be less than Ppmrows_height.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Ppmrows_seek(Ppmrows_T rows, unsigned row)
+{
+        assert(rows != NULL);
+        assert(row < rows->height);
+        if (rows->start < 0)
+        {
+                return 0;
+        }
+
+        long row_bytes = 3 * (long)rows->width *
+                         (rows->denominator > 255 ? 2 : 1);
+        if (fseek(rows->fp, rows->start + row * row_bytes, SEEK_SET) != 0)
+        {
+                return 0;
+        }
+        rows->next_row = row;
+        return 1;
+}
+
+/********** Ppmrows_free ********
+ *
+ * Frees a reader and sets the caller's handle to NULL.
+ *
+ * Parameters:
+ *      Ppmrows_T *rows:        A pointer to the reader.
+ *
+ * Expects:
+ *      rows and *rows must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Ppmrows_free(Ppmrows_T *rows)
+{
+        assert(rows != NULL && *rows != NULL);
+        FREE((*rows)->bytes);
+        FREE((*rows)->pixels);
+        FREE(*rows);
+}
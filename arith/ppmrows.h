@@ -0,0 +1,142 @@
+/**************************************************************
+ *
+ *                     ppmrows.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for reading a PPM a row at a time.
+ *     Unlike Pnm_ppmread, which holds the whole image, a reader keeps only
+ *     one row, so comparing or scanning an image needs memory in proportion
+ *     to its width alone. Both the plain (P3) and raw (P6) formats are
+ *     read, with one- or two-byte raw samples.
+ *
+ ************************/
+
+#ifndef PPMROWS_H
+#define PPMROWS_H
+
+#include <stdio.h>
+#include "pnm.h"
+
+/********** Ppmrows_T ********
+ *
+ * An opaque handle to a PPM being read a row at a time.
+ ************************/
+typedef struct Ppmrows_T *Ppmrows_T;
+
+/********** Ppmrows_new ********
+ *
+ * Reads a PPM header.
+ *
+ * Parameters:
+ *      FILE *fp:       The stream to read.
+ *
+ * Return:
+ *      Ppmrows_T:      A reader positioned at the first row, or NULL if
+ *                      the header is not a valid PPM header.
+ *
+ * Expects:
+ *      fp must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Client is responsible for freeing the reader with Ppmrows_free; the
+ *      stream is left open.
+ ************************/
+Ppmrows_T Ppmrows_new(FILE *fp);
+
+/********** Ppmrows_reset ********
+ *
+ * Reads a new PPM header into an existing reader, keeping its buffers
+ * when they are big enough.
+ *
+ * Parameters:
+ *      Ppmrows_T rows:         The reader.
+ *      FILE *fp:               The stream to read.
+ *
+ * Return:
+ *      int:                    1 if the header is valid and the reader is
+ *                              positioned at the first row, else 0 (and
+ *                              the reader has no rows).
+ *
+ * Expects:
+ *      rows and fp must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Ppmrows_reset(Ppmrows_T rows, FILE *fp);
+
+/********** Ppmrows_width, Ppmrows_height, Ppmrows_denominator ********
+ *
+ * Get the dimensions and maximum sample value from the header.
+ *
+ * Expects:
+ *      rows must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+unsigned Ppmrows_width(Ppmrows_T rows);
+unsigned Ppmrows_height(Ppmrows_T rows);
+unsigned Ppmrows_denominator(Ppmrows_T rows);
+
+/********** Ppmrows_next ********
+ *
+ * Reads the next row.
+ *
+ * Parameters:
+ *      Ppmrows_T rows:         The reader.
+ *
+ * Return:
+ *      const struct Pnm_rgb *: The row's Ppmrows_width pixels, valid until
+ *                              the next call, or NULL if every row has been
+ *                              read or the stream ends early.
+ *
+ * Expects:
+ *      rows must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+const struct Pnm_rgb *Ppmrows_next(Ppmrows_T rows);
+
+/********** Ppmrows_seek ********
+ *
+ * Moves a reader so that the next row read is a given row.
+ *
+ * Parameters:
+ *      Ppmrows_T rows:         The reader.
+ *      unsigned row:           The row to read next.
+ *
+ * Return:
+ *      int:                    1 if the reader moved, 0 if it cannot seek:
+ *                              the image is plain (P3) or the stream is
+ *                              not seekable, such as a pipe.
+ *
+ * Expects:
+ *      rows must not be NULL, and row must be less than Ppmrows_height.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Ppmrows_seek(Ppmrows_T rows, unsigned row);
+
+/********** Ppmrows_free ********
+ *
+ * Frees a reader and sets the caller's handle to NULL.
+ *
+ * Parameters:
+ *      Ppmrows_T *rows:        A pointer to the reader.
+ *
+ * Expects:
+ *      rows and *rows must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Ppmrows_free(Ppmrows_T *rows);
+
+#endif
@@ -0,0 +1,407 @@
+/**************************************************************
+ *
+ *                     ppmsynth.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for the synthetic test
+ *     images. Each kind is a function that computes one row of samples in
+ *     [0, 1] from the row number and a seed, so rows can be made in any
+ *     order and an image never has to be held whole.
+ *
+ ************************/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "ppmsynth.h"
+
+#define OCTAVES 6
+
+/********** Generator ********
+ *
+ * A function that fills one row of samples, each in [0, 1].
+ *
+ * Parameters:
+ *      double *rgb:         3 * width samples to fill.
+ *      unsigned row:        The row being generated.
+ *      unsigned width:      The width of the image.
+ *      unsigned height:     The height of the image.
+ *      uint64_t seed:       The image's seed.
+ ************************/
+typedef void Generator(double *rgb, unsigned row, unsigned width,
+                       unsigned height, uint64_t seed);
+
+/********** mix ********
+ *
+ * Hashes a 64-bit value (the splitmix64 finalizer).
+ ************************/
+static uint64_t mix(uint64_t x)
+{
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+}
+
+/********** unit ********
+ *
+ * Hashes a seed and lattice point to a number in [0, 1).
+ ************************/
+static double unit(uint64_t seed, uint64_t x, uint64_t y)
+{
+        return (mix(seed ^ mix(x ^ mix(y))) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/********** value_noise ********
+ *
+ * Smoothly interpolated lattice noise with one lattice point every
+ * `scale` pixels.
+ ************************/
+static double value_noise(uint64_t seed, double x, double y, double scale)
+{
+        double fx = x / scale, fy = y / scale;
+        uint64_t x0 = (uint64_t)fx, y0 = (uint64_t)fy;
+        double tx = fx - x0, ty = fy - y0;
+
+        /* Smoothstep, so the lattice does not show */
+        tx = tx * tx * (3 - 2 * tx);
+        ty = ty * ty * (3 - 2 * ty);
+
+        double top = unit(seed, x0, y0) * (1 - tx) +
+                     unit(seed, x0 + 1, y0) * tx;
+        double bottom = unit(seed, x0, y0 + 1) * (1 - tx) +
+                        unit(seed, x0 + 1, y0 + 1) * tx;
+        return top * (1 - ty) + bottom * ty;
+}
+
+/********** fbm ********
+ *
+ * Sums OCTAVES octaves of value noise, each half the scale and half the
+ * weight of the last, normalized to [0, 1].
+ ************************/
+static double fbm(uint64_t seed, double x, double y, double scale)
+{
+        double sum = 0, weight = 1, total = 0;
+        for (int octave = 0; octave < OCTAVES && scale >= 1; octave++)
+        {
+                sum += weight * value_noise(seed + octave, x, y, scale);
+                total += weight;
+                weight /= 2;
+                scale /= 2;
+        }
+        return sum / total;
+}
+
+static void gen_flat(double *rgb, unsigned row, unsigned width,
+                     unsigned height, uint64_t seed)
+{
+        (void)row;
+        (void)height;
+        double color[3] = {unit(seed, 0, 0), unit(seed, 1, 0),
+                           unit(seed, 2, 0)};
+        for (unsigned col = 0; col < width; col++)
+        {
+                memcpy(&rgb[3 * col], color, sizeof(color));
+        }
+}
+
+static void gen_gradient(double *rgb, unsigned row, unsigned width,
+                         unsigned height, uint64_t seed)
+{
+        (void)seed;
+        double y = height > 1 ? (double)row / (height - 1) : 0;
+        for (unsigned col = 0; col < width; col++)
+        {
+                double x = width > 1 ? (double)col / (width - 1) : 0;
+                rgb[3 * col] = x;
+                rgb[3 * col + 1] = y;
+                rgb[3 * col + 2] = (x + (1 - y)) / 2;
+        }
+}
+
+static void gen_noise(double *rgb, unsigned row, unsigned width,
+                      unsigned height, uint64_t seed)
+{
+        (void)height;
+        for (unsigned i = 0; i < 3 * width; i++)
+        {
+                rgb[i] = unit(seed, i, row);
+        }
+}
+
+static void gen_fractal(double *rgb, unsigned row, unsigned width,
+                        unsigned height, uint64_t seed)
+{
+        double scale = (width > height ? width : height) / 4.0;
+        scale = scale < 2 ? 2 : scale;
+        for (unsigned col = 0; col < width; col++)
+        {
+                /* Detailed luma, with broad, gentle color variation */
+                double luma = fbm(seed, col, row, scale);
+                double warm = fbm(seed + 100, col, row, 2 * scale) - 0.5;
+                double r = luma + 0.25 * warm, b = luma - 0.25 * warm;
+                rgb[3 * col] = r < 0 ? 0 : (r > 1 ? 1 : r);
+                rgb[3 * col + 1] = luma;
+                rgb[3 * col + 2] = b < 0 ? 0 : (b > 1 ? 1 : b);
+        }
+}
+
+/********** gen_text ********
+ *
+ * Lays the image out as lines of 8 x 12 character cells. Each cell is
+ * blank or holds a glyph made of a random subset of 3 horizontal and
+ * 3 vertical strokes, 1 pixel wide.
+ ************************/
+static void gen_text(double *rgb, unsigned row, unsigned width,
+                     unsigned height, uint64_t seed)
+{
+        (void)height;
+        unsigned line = row / 12, y = row % 12;
+        for (unsigned col = 0; col < width; col++)
+        {
+                unsigned cell = col / 8, x = col % 8;
+                uint64_t glyph = mix(seed ^ mix(((uint64_t)line << 32) |
+                                                cell));
+                int ink = 0;
+
+                /* One cell in six is a space; the margin is never inked */
+                if (glyph % 6 != 0 && x >= 1 && x <= 5 && y >= 2 && y <= 10)
+                {
+                        for (int s = 0; s < 3; s++)
+                        {
+                                int hbar = (glyph >> (8 + s)) & 1;
+                                int vbar = (glyph >> (16 + s)) & 1;
+                                ink |= hbar && y == 2 + 4 * (unsigned)s;
+                                ink |= vbar && x == 1 + 2 * (unsigned)s;
+                        }
+                }
+                double shade = ink ? 0.08 : 0.95;
+                rgb[3 * col] = shade;
+                rgb[3 * col + 1] = shade;
+                rgb[3 * col + 2] = ink ? 0.15 : 0.92;
+        }
+}
+
+/* Indexed by Ppmsynth_kind */
+static Generator *GENERATORS[PPMSYNTH_NKINDS] = {gen_flat, gen_gradient,
+                                                 gen_noise, gen_fractal,
+                                                 gen_text};
+static const char *NAMES[PPMSYNTH_NKINDS] = {"flat", "gradient", "noise",
+                                             "fractal", "text"};
+
+/********** Ppmsynth_name ********
+ *
+ * Gets the name of a kind.
+ *
+ * Parameters:
+ *      Ppmsynth_kind kind:     The kind.
+ *
+ * Return:
+ *      const char *:           Its name, e.g. "fractal".
+ *
+ * Expects:
+ *      kind must be less than PPMSYNTH_NKINDS.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+const char *Ppmsynth_name(Ppmsynth_kind kind)
+{
+        assert(kind < PPMSYNTH_NKINDS);
+        return NAMES[kind];
+}
+
+/********** Ppmsynth_find ********
+ *
+ * Looks up a kind by name.
+ *
+ * Parameters:
+ *      const char *name:       The name.
+ *
+ * Return:
+ *      int:                    The kind, or -1 if there is none by that
+ *                              name.
+ *
+ * Expects:
+ *      name must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Ppmsynth_find(const char *name)
+{
+        assert(name != NULL);
+        for (int k = 0; k < PPMSYNTH_NKINDS; k++)
+        {
+                if (strcmp(name, NAMES[k]) == 0)
+                {
+                        return k;
+                }
+        }
+        return -1;
+}
+
+/********** Synth ********
+ *
+ * One image being made a row at a time.
+ *
+ * Elements:
+ *      Generator *generator:   Fills a row of samples.
+ *      unsigned width, height: The size in pixels.
+ *      unsigned maxval:        The PPM maxval.
+ *      int bytes:              Bytes per sample, 1 or 2.
+ *      uint64_t seed:          The seed, mixed with the kind.
+ *      double *rgb:            One row of samples in [0, 1].
+ ************************/
+typedef struct Synth
+{
+        Generator *generator;
+        unsigned width, height;
+        unsigned maxval;
+        int bytes;
+        uint64_t seed;
+        double *rgb;
+} Synth;
+
+/********** synth_start ********
+ *
+ * Checks the arguments common to Ppmsynth_write and Ppmsynth_image and
+ * sets up a Synth. Client must FREE its rgb.
+ ************************/
+static Synth synth_start(Ppmsynth_kind kind, unsigned width, unsigned height,
+                         unsigned maxval, uint64_t seed)
+{
+        assert(kind < PPMSYNTH_NKINDS);
+        assert(width > 0 && height > 0);
+        assert(maxval >= 1 && maxval <= 65535);
+
+        /* Different kinds never share samples, even with equal seeds */
+        Synth synth = {GENERATORS[kind], width, height, maxval,
+                       maxval > 255 ? 2 : 1,
+                       mix(seed ^ ((uint64_t)kind << 56)),
+                       CALLOC(3 * (size_t)width, sizeof(double))};
+        return synth;
+}
+
+/********** synth_row ********
+ *
+ * Makes one row of a Synth as raw PPM samples.
+ *
+ * Parameters:
+ *      Synth *synth:           The image.
+ *      unsigned row:           The row to make.
+ *      unsigned char *raster:  Filled with 3 * width samples of
+ *                              synth->bytes bytes each.
+ ************************/
+static void synth_row(Synth *synth, unsigned row, unsigned char *raster)
+{
+        synth->generator(synth->rgb, row, synth->width, synth->height,
+                         synth->seed);
+        for (size_t i = 0; i < 3 * (size_t)synth->width; i++)
+        {
+                unsigned v = (unsigned)lround(synth->rgb[i] * synth->maxval);
+                if (synth->bytes == 2)
+                {
+                        raster[2 * i] = v >> 8;
+                        raster[2 * i + 1] = v & 0xFF;
+                }
+                else
+                {
+                        raster[i] = v;
+                }
+        }
+}
+
+/********** Ppmsynth_write ********
+ *
+ * Writes an image as binary PPM, one row at a time, so that even a large
+ * image needs only one row of memory.
+ *
+ * Parameters:
+ *      FILE *out:              The stream to write to.
+ *      Ppmsynth_kind kind:     The kind of image.
+ *      unsigned width:         The width in pixels.
+ *      unsigned height:        The height in pixels.
+ *      unsigned maxval:        The PPM maxval.
+ *      uint64_t seed:          The seed.
+ *
+ * Expects:
+ *      out must not be NULL, kind must be less than PPMSYNTH_NKINDS,
+ *      width and height must be positive, and maxval must be between 1
+ *      and 65535.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Ppmsynth_write(FILE *out, Ppmsynth_kind kind, unsigned width,
+                    unsigned height, unsigned maxval, uint64_t seed)
+{
+        assert(out != NULL);
+        Synth synth = synth_start(kind, width, height, maxval, seed);
+        size_t row_bytes = 3 * (size_t)width * synth.bytes;
+        unsigned char *raster = ALLOC(row_bytes);
+
+        fprintf(out, "P6\n%u %u\n%u\n", width, height, maxval);
+        for (unsigned row = 0; row < height; row++)
+        {
+                synth_row(&synth, row, raster);
+                fwrite(raster, 1, row_bytes, out);
+        }
+
+        FREE(raster);
+        FREE(synth.rgb);
+}
+
+/********** Ppmsynth_image ********
+ *
+ * Makes an image as binary PPM in memory.
+ *
+ * Parameters:
+ *      Ppmsynth_kind kind:     The kind of image.
+ *      unsigned width:         The width in pixels.
+ *      unsigned height:        The height in pixels.
+ *      unsigned maxval:        The PPM maxval.
+ *      uint64_t seed:          The seed.
+ *      size_t *len:            Filled in with the number of bytes
+ *                              returned.
+ *
+ * Return:
+ *      char *:                 The image, the same bytes Ppmsynth_write
+ *                              writes.
+ *
+ * Expects:
+ *      The same as Ppmsynth_write, and len must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated or allocation fails.
+ *      Client is responsible for freeing the image with FREE.
+ ************************/
+char *Ppmsynth_image(Ppmsynth_kind kind, unsigned width, unsigned height,
+                     unsigned maxval, uint64_t seed, size_t *len)
+{
+        assert(len != NULL);
+        Synth synth = synth_start(kind, width, height, maxval, seed);
+        size_t row_bytes = 3 * (size_t)width * synth.bytes;
+        char header[32];
+        int hlen = snprintf(header, sizeof(header), "P6\n%u %u\n%u\n",
+                            width, height, maxval);
+
+        *len = hlen + row_bytes * height;
+        char *ppm = ALLOC(*len);
+        memcpy(ppm, header, hlen);
+        for (unsigned row = 0; row < height; row++)
+        {
+                synth_row(&synth, row,
+                          (unsigned char *)ppm + hlen + row * row_bytes);
+        }
+
+        FREE(synth.rgb);
+        return ppm;
+}
@@ -0,0 +1,134 @@
+/**************************************************************
+ *
+ *                     ppmsynth.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for deterministic synthetic test
+ *     images, as written by ppmgen and used by 40imagebench and the
+ *     autotuner. The same kind, size, maxval and seed always give the
+ *     same bytes.
+ *
+ ************************/
+
+#ifndef PPMSYNTH_H
+#define PPMSYNTH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/********** Ppmsynth_kind ********
+ *
+ * The kinds of image that can be made.
+ *
+ * Values:
+ *      PPMSYNTH_FLAT:       One solid color.
+ *      PPMSYNTH_GRADIENT:   Smooth ramps in each channel.
+ *      PPMSYNTH_NOISE:      Independent uniform noise per sample.
+ *      PPMSYNTH_FRACTAL:    Multi-octave value noise, like photographic
+ *                           texture.
+ *      PPMSYNTH_TEXT:       Dark glyph-like strokes on a light
+ *                           background, with hard edges.
+ ************************/
+typedef enum Ppmsynth_kind
+{
+        PPMSYNTH_FLAT,
+        PPMSYNTH_GRADIENT,
+        PPMSYNTH_NOISE,
+        PPMSYNTH_FRACTAL,
+        PPMSYNTH_TEXT,
+        PPMSYNTH_NKINDS
+} Ppmsynth_kind;
+
+/********** Ppmsynth_name ********
+ *
+ * Gets the name of a kind.
+ *
+ * Parameters:
+ *      Ppmsynth_kind kind:     The kind.
+ *
+ * Return:
+ *      const char *:           Its name, e.g. "fractal".
+ *
+ * Expects:
+ *      kind must be less than PPMSYNTH_NKINDS.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+const char *Ppmsynth_name(Ppmsynth_kind kind);
+
+/********** Ppmsynth_find ********
+ *
+ * Looks up a kind by name.
+ *
+ * Parameters:
+ *      const char *name:       The name.
+ *
+ * Return:
+ *      int:                    The kind, or -1 if there is none by that
+ *                              name.
+ *
+ * Expects:
+ *      name must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Ppmsynth_find(const char *name);
+
+/********** Ppmsynth_write ********
+ *
+ * Writes an image as binary PPM, one row at a time, so that even a large
+ * image needs only one row of memory.
+ *
+ * Parameters:
+ *      FILE *out:              The stream to write to.
+ *      Ppmsynth_kind kind:     The kind of image.
+ *      unsigned width:         The width in pixels.
+ *      unsigned height:        The height in pixels.
+ *      unsigned maxval:        The PPM maxval.
+ *      uint64_t seed:          The seed.
+ *
+ * Expects:
+ *      out must not be NULL, kind must be less than PPMSYNTH_NKINDS,
+ *      width and height must be positive, and maxval must be between 1
+ *      and 65535.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Ppmsynth_write(FILE *out, Ppmsynth_kind kind, unsigned width,
+                    unsigned height, unsigned maxval, uint64_t seed);
+
+/********** Ppmsynth_image ********
+ *
+ * Makes an image as binary PPM in memory.
+ *
+ * Parameters:
+ *      Ppmsynth_kind kind:     The kind of image.
+ *      unsigned width:         The width in pixels.
+ *      unsigned height:        The height in pixels.
+ *      unsigned maxval:        The PPM maxval.
+ *      uint64_t seed:          The seed.
+ *      size_t *len:            Filled in with the number of bytes
+ *                              returned.
+ *
+ * Return:
+ *      char *:                 The image, the same bytes Ppmsynth_write
+ *                              writes.
+ *
+ * Expects:
+ *      The same as Ppmsynth_write, and len must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated or allocation fails.
+ *      Client is responsible for freeing the image with FREE.
+ ************************/
+char *Ppmsynth_image(Ppmsynth_kind kind, unsigned width, unsigned height,
+                     unsigned maxval, uint64_t seed, size_t *len);
+
+#endif
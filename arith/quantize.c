@@ -13,6 +13,11 @@
  ************************/
 
 #include "quantize.h"
+/* libcompress40.a builds this file with QUANTIZE_NO_TELEMETRY, leaving
+ * out the telemetry hook and with it the library's only global state */
+#ifndef QUANTIZE_NO_TELEMETRY
+#include "quantstats.h"
+#endif
 #include <assert.h>
 #include "arith40.h"
 #include "mem.h"
@@ -135,6 +140,13 @@ void quantize(Quantized q,
         q->d = quantize_bcd(dct->d);
         q->Pbar_b = Arith40_index_of_chroma(dct->Pbar_b);
         q->Pbar_r = Arith40_index_of_chroma(dct->Pbar_r);
+
+#ifndef QUANTIZE_NO_TELEMETRY
+        if (Quantstats_enabled)
+        {
+                Quantstats_record(dct, q);
+        }
+#endif
 }
 
 /********** dequantize ********
@@ -210,4 +222,31 @@ void Quantized_free(Quantized *q)
 
         FREE(*q);
         q = NULL;
-}
\ No newline at end of file
+}
+
+/********** Quantized_arena_new ********
+ *
+ * Allocates a new Quantized structure from an arena.
+ *
+ * Parameters:
+ *      JobArena_T arena:  The arena to allocate from.
+ *
+ * Returns:
+ *      Quantized: A new Quantized structure.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      The structure lives until the arena is reset or freed; it must not
+ *      be passed to Quantized_free.
+ ************************/
+Quantized Quantized_arena_new(JobArena_T arena)
+{
+        assert(arena != NULL);
+
+        Quantized q;
+        JOBARENA_NEW(arena, q);
+        return q;
+}
@@ -17,6 +17,7 @@
 
 #include <stdio.h>
 #include "dct.h"
+#include "jobarena.h"
 
 /********** Quantized ********
  *
@@ -110,4 +111,24 @@ Quantized Quantized_new();
  ************************/
 void Quantized_free(Quantized *q);
 
+/********** Quantized_arena_new ********
+ *
+ * Allocates a new Quantized structure from an arena.
+ *
+ * Parameters:
+ *      JobArena_T arena:  The arena to allocate from.
+ *
+ * Returns:
+ *      Quantized: A new Quantized structure.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      The structure lives until the arena is reset or freed; it must not
+ *      be passed to Quantized_free.
+ ************************/
+Quantized Quantized_arena_new(JobArena_T arena);
+
 #endif
\ No newline at end of file
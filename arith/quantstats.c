@@ -0,0 +1,229 @@
+/**************************************************************
+ *
+ *                     quantstats.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for quantization telemetry.
+ *     As in trace.c, each thread publishes its histograms once to a
+ *     global list with a compare-and-swap, and only the owning thread
+ *     writes to them afterwards.
+ *
+ ************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "quantstats.h"
+
+/* The range of b, c and d after quantizing, and of the chroma indices */
+#define BCD_LIMIT 15
+#define BCD_BINS (2 * BCD_LIMIT + 1)
+#define A_BINS 512
+#define CHROMA_BINS 16
+
+/* The clamp bounds used by quantize_a and quantize_bcd */
+#define A_LOW 0
+#define A_HIGH 1
+#define BCD_LOW -0.3
+#define BCD_HIGH 0.3
+
+static const char *FIELD_NAMES[] = {"b", "c", "d"};
+
+/********** Histograms ********
+ *
+ * One thread's counts.
+ *
+ * Elements:
+ *      struct Histograms *next:   The next thread's counts.
+ *      uint64_t blocks:           Blocks counted.
+ *      uint64_t a[]:              Counts of each quantized a.
+ *      uint64_t bcd[][]:          Counts of each quantized b, c and d,
+ *                                 offset by BCD_LIMIT.
+ *      uint64_t pb[], pr[]:       Counts of each chroma index.
+ *      uint64_t a_low, a_high:    Times a was clamped up to 0 or down
+ *                                 to 1.
+ *      uint64_t bcd_low[]:        Times b, c, d were clamped up to -0.3.
+ *      uint64_t bcd_high[]:       Times b, c, d were clamped down to 0.3.
+ ************************/
+typedef struct Histograms
+{
+        struct Histograms *next;
+        uint64_t blocks;
+        uint64_t a[A_BINS];
+        uint64_t bcd[3][BCD_BINS];
+        uint64_t pb[CHROMA_BINS];
+        uint64_t pr[CHROMA_BINS];
+        uint64_t a_low, a_high;
+        uint64_t bcd_low[3];
+        uint64_t bcd_high[3];
+} *Histograms;
+
+int Quantstats_enabled = 0;
+
+static Histograms all = NULL;
+static __thread Histograms mine = NULL;
+
+/********** thread_histograms ********
+ *
+ * Gets the calling thread's histograms, creating and publishing them on
+ * first use.
+ ************************/
+static Histograms thread_histograms(void)
+{
+        if (mine == NULL)
+        {
+                NEW0(mine);
+                mine->next = __atomic_load_n(&all, __ATOMIC_RELAXED);
+                while (!__atomic_compare_exchange_n(&all, &mine->next, mine,
+                                                    1, __ATOMIC_RELEASE,
+                                                    __ATOMIC_RELAXED))
+                {
+                        /* mine->next was reloaded; try again */
+                }
+        }
+        return mine;
+}
+
+/********** Quantstats_record ********
+ *
+ * Counts one quantized block in the calling thread's histograms.
+ *
+ * Parameters:
+ *      DCT dct:        The coefficients before quantizing.
+ *      Quantized q:    The quantized values.
+ *
+ * Expects:
+ *      dct and q must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Quantstats_record(DCT dct, Quantized q)
+{
+        assert(dct != NULL);
+        assert(q != NULL);
+        Histograms h = thread_histograms();
+
+        h->blocks++;
+        h->a[q->a % A_BINS]++;
+        h->pb[q->Pbar_b % CHROMA_BINS]++;
+        h->pr[q->Pbar_r % CHROMA_BINS]++;
+        h->a_low += dct->a < A_LOW;
+        h->a_high += dct->a > A_HIGH;
+
+        float in[3] = {dct->b, dct->c, dct->d};
+        int out[3] = {q->b, q->c, q->d};
+        for (int f = 0; f < 3; f++)
+        {
+                int bin = out[f] + BCD_LIMIT;
+                h->bcd[f][bin < 0 ? 0 : (bin >= BCD_BINS ? BCD_BINS - 1
+                                                         : bin)]++;
+                h->bcd_low[f] += in[f] < BCD_LOW;
+                h->bcd_high[f] += in[f] > BCD_HIGH;
+        }
+}
+
+/********** print_bins ********
+ *
+ * Prints the nonzero bins of one histogram on one line.
+ *
+ * Parameters:
+ *      FILE *out:              The stream to print to.
+ *      const char *name:       The field's name.
+ *      const uint64_t *bins:   The histogram.
+ *      int n:                  The number of bins.
+ *      int offset:             The value of bin 0.
+ ************************/
+static void print_bins(FILE *out, const char *name, const uint64_t *bins,
+                       int n, int offset)
+{
+        fprintf(out, "  hist %-2s", name);
+        for (int i = 0; i < n; i++)
+        {
+                if (bins[i] != 0)
+                {
+                        fprintf(out, " %d:%lu", i + offset,
+                                (unsigned long)bins[i]);
+                }
+        }
+        fprintf(out, "\n");
+}
+
+/********** Quantstats_report ********
+ *
+ * Merges every thread's histograms and prints the clamp counts and the
+ * nonzero histogram bins.
+ *
+ * Parameters:
+ *      FILE *out:      The stream to print to.
+ *
+ * Expects:
+ *      out must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Blocks counted while the report runs may be left out.
+ ************************/
+void Quantstats_report(FILE *out)
+{
+        assert(out != NULL);
+
+        struct Histograms total;
+        memset(&total, 0, sizeof(total));
+        int threads = 0;
+        for (Histograms h = __atomic_load_n(&all, __ATOMIC_ACQUIRE);
+             h != NULL; h = h->next)
+        {
+                total.blocks += h->blocks;
+                for (int i = 0; i < A_BINS; i++)
+                {
+                        total.a[i] += h->a[i];
+                }
+                for (int i = 0; i < CHROMA_BINS; i++)
+                {
+                        total.pb[i] += h->pb[i];
+                        total.pr[i] += h->pr[i];
+                }
+                total.a_low += h->a_low;
+                total.a_high += h->a_high;
+                for (int f = 0; f < 3; f++)
+                {
+                        for (int i = 0; i < BCD_BINS; i++)
+                        {
+                                total.bcd[f][i] += h->bcd[f][i];
+                        }
+                        total.bcd_low[f] += h->bcd_low[f];
+                        total.bcd_high[f] += h->bcd_high[f];
+                }
+                threads++;
+        }
+
+        double blocks = total.blocks == 0 ? 1 : total.blocks;
+        fprintf(out, "quantization: %lu blocks from %d threads\n",
+                (unsigned long)total.blocks, threads);
+        fprintf(out, "  clamp a   low %lu (%.3f%%) high %lu (%.3f%%)\n",
+                (unsigned long)total.a_low, 100 * total.a_low / blocks,
+                (unsigned long)total.a_high, 100 * total.a_high / blocks);
+        for (int f = 0; f < 3; f++)
+        {
+                fprintf(out, "  clamp %s   low %lu (%.3f%%) high %lu "
+                        "(%.3f%%)\n", FIELD_NAMES[f],
+                        (unsigned long)total.bcd_low[f],
+                        100 * total.bcd_low[f] / blocks,
+                        (unsigned long)total.bcd_high[f],
+                        100 * total.bcd_high[f] / blocks);
+        }
+        print_bins(out, "a", total.a, A_BINS, 0);
+        for (int f = 0; f < 3; f++)
+        {
+                print_bins(out, FIELD_NAMES[f], total.bcd[f], BCD_BINS,
+                           -BCD_LIMIT);
+        }
+        print_bins(out, "pb", total.pb, CHROMA_BINS, 0);
+        print_bins(out, "pr", total.pr, CHROMA_BINS, 0);
+}
@@ -0,0 +1,64 @@
+/**************************************************************
+ *
+ *                     quantstats.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for quantization telemetry:
+ *     histograms of every quantized field (a, b, c, d and both chroma
+ *     indices) and counts of how often a, b, c and d were clamped before
+ *     quantizing. Each thread counts into its own histograms, so the hot
+ *     loop takes no lock and shares no cache lines; Quantstats_report
+ *     merges them.
+ *
+ *     Telemetry is off unless Quantstats_enabled is set; quantize then
+ *     pays one predictable branch per block.
+ *
+ ************************/
+
+#ifndef QUANTSTATS_H
+#define QUANTSTATS_H
+
+#include <stdio.h>
+#include "dct.h"
+#include "quantize.h"
+
+/* Nonzero while quantization telemetry is being gathered */
+extern int Quantstats_enabled;
+
+/********** Quantstats_record ********
+ *
+ * Counts one quantized block in the calling thread's histograms.
+ *
+ * Parameters:
+ *      DCT dct:        The coefficients before quantizing.
+ *      Quantized q:    The quantized values.
+ *
+ * Expects:
+ *      dct and q must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Quantstats_record(DCT dct, Quantized q);
+
+/********** Quantstats_report ********
+ *
+ * Merges every thread's histograms and prints the clamp counts and the
+ * nonzero histogram bins.
+ *
+ * Parameters:
+ *      FILE *out:      The stream to print to.
+ *
+ * Expects:
+ *      out must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Blocks counted while the report runs may be left out.
+ ************************/
+void Quantstats_report(FILE *out);
+
+#endif
@@ -222,6 +222,41 @@ void RGB_block_free(RGB_block *block)
         block = NULL;
 }
 
+/********** RGB_block_arena_new ********
+ *
+ * Allocates a new RGB_block and its Pnm_rgb structs from an arena, all in
+ * one contiguous piece.
+ *
+ * Parameters:
+ *      JobArena_T arena:  The arena to allocate from.
+ *
+ * Returns:
+ *      RGB_block: A new RGB_block structure.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      The block lives until the arena is reset or freed; it must not be
+ *      passed to RGB_block_free.
+ ************************/
+RGB_block RGB_block_arena_new(JobArena_T arena)
+{
+        assert(arena != NULL);
+
+        RGB_block block;
+        JOBARENA_NEW(arena, block);
+        Pnm_rgb pixels = JobArena_alloc(arena, 4 * sizeof(*pixels));
+
+        for (int i = 0; i < 4; i++)
+        {
+                block->rgb[i] = &pixels[i];
+        }
+
+        return block;
+}
+
 /********** CAV_block_new ********
  *
  * Allocates memory for a new CAV_block, including the ComponentVideo structs.
@@ -275,4 +310,38 @@ void CAV_block_free(CAV_block *block)
         }
         FREE(*block);
         block = NULL;
-}
\ No newline at end of file
+}
+
+/********** CAV_block_arena_new ********
+ *
+ * Allocates a new CAV_block and its CAV structs from an arena, all in one
+ * contiguous piece.
+ *
+ * Parameters:
+ *      JobArena_T arena:  The arena to allocate from.
+ *
+ * Returns:
+ *      CAV_block: A new CAV_block structure.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      The block lives until the arena is reset or freed; it must not be
+ *      passed to CAV_block_free.
+ ************************/
+CAV_block CAV_block_arena_new(JobArena_T arena)
+{
+        assert(arena != NULL);
+
+        CAV_block block;
+        JOBARENA_NEW(arena, block);
+        CAV cavs = JobArena_alloc(arena, 4 * sizeof(*cavs));
+
+        for (int i = 0; i < 4; i++)
+        {
+                block->cav[i] = &cavs[i];
+        }
+        return block;
+}
@@ -17,6 +17,7 @@
 
 #include <stdio.h>
 #include "pnm.h"
+#include "jobarena.h"
 
 /********** CAV ********
  *
@@ -183,6 +184,27 @@ RGB_block RGB_block_new();
  ************************/
 void RGB_block_free(RGB_block *block);
 
+/********** RGB_block_arena_new ********
+ *
+ * Allocates a new RGB_block and its Pnm_rgb structs from an arena, all in
+ * one contiguous piece.
+ *
+ * Parameters:
+ *      JobArena_T arena:  The arena to allocate from.
+ *
+ * Returns:
+ *      RGB_block: A new RGB_block structure.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      The block lives until the arena is reset or freed; it must not be
+ *      passed to RGB_block_free.
+ ************************/
+RGB_block RGB_block_arena_new(JobArena_T arena);
+
 /********** CAV_block_new ********
  *
  * Allocates memory for a new CAV_block, including the ComponentVideo structs.
@@ -219,4 +241,25 @@ CAV_block CAV_block_new();
  ************************/
 void CAV_block_free(CAV_block *block);
 
+/********** CAV_block_arena_new ********
+ *
+ * Allocates a new CAV_block and its CAV structs from an arena, all in one
+ * contiguous piece.
+ *
+ * Parameters:
+ *      JobArena_T arena:  The arena to allocate from.
+ *
+ * Returns:
+ *      CAV_block: A new CAV_block structure.
+ *
+ * Expects:
+ *      arena must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      The block lives until the arena is reset or freed; it must not be
+ *      passed to CAV_block_free.
+ ************************/
+CAV_block CAV_block_arena_new(JobArena_T arena);
+
 #endif
\ No newline at end of file
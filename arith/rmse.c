@@ -0,0 +1,410 @@
+/**************************************************************
+ *
+ *                     rmse.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for the root mean square
+ *     error between two images.
+ *
+ *     The row kernels treat a span of pixels as 3n unsigned samples. They
+ *     are built once per instruction set, like the codec's batch kernels in
+ *     kernels_isa.c, and the best one the CPU supports is chosen on first
+ *     use. The scaled kernel sums into eight lanes that are combined in a
+ *     fixed order, and the Makefile compiles this file without
+ *     floating-point contraction, so every copy gives the same result.
+ *
+ *     Rmse_images splits the shared region into bands of BAND_ROWS rows,
+ *     sums each band on its own (on a thread pool when the image is big
+ *     enough to pay for one) and adds the bands up in order.
+ *
+ ************************/
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "a2methods.h"
+#include "a2row.h"
+#include "threadpool.h"
+#include "rmse.h"
+
+/* Rows per band, whatever the number of threads */
+#define BAND_ROWS 64
+
+/* Images with fewer pixels than this are summed on the calling thread */
+#define MIN_PARALLEL_PIXELS (1 << 18)
+
+/* Lanes of the scaled kernel; combined pairwise at the end of a span */
+#define LANES 8
+
+/* One copy of the row kernels, for the instruction set in force */
+#define ROW_KERNELS(isa) \
+        static uint64_t exact_row_##isa(const unsigned *restrict x, \
+                                        const unsigned *restrict y, \
+                                        size_t m) \
+        { \
+                uint64_t sum = 0; \
+                for (size_t i = 0; i < m; i++) \
+                { \
+                        uint32_t d = x[i] > y[i] ? x[i] - y[i] \
+                                                 : y[i] - x[i]; \
+                        sum += d * d; \
+                } \
+                return sum; \
+        } \
+        \
+        static double scaled_row_##isa(const unsigned *restrict x, \
+                                       const unsigned *restrict y, \
+                                       size_t m, unsigned denom_x, \
+                                       unsigned denom_y) \
+        { \
+                double lane[LANES] = {0}; \
+                double dx = denom_x, dy = denom_y; \
+                size_t i = 0; \
+                for (; i + LANES <= m; i += LANES) \
+                { \
+                        for (int j = 0; j < LANES; j++) \
+                        { \
+                                double d = (int)x[i + j] * dy - \
+                                           (int)y[i + j] * dx; \
+                                lane[j] += d * d; \
+                        } \
+                } \
+                for (int j = 0; i < m; i++, j++) \
+                { \
+                        double d = (int)x[i] * dy - (int)y[i] * dx; \
+                        lane[j] += d * d; \
+                } \
+                return ((lane[0] + lane[1]) + (lane[2] + lane[3])) + \
+                       ((lane[4] + lane[5]) + (lane[6] + lane[7])); \
+        }
+
+ROW_KERNELS(scalar)
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+ROW_KERNELS(avx2)
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw,avx512dq,avx512vl")
+ROW_KERNELS(avx512)
+#pragma GCC pop_options
+
+#endif
+
+static uint64_t (*exact_row)(const unsigned *, const unsigned *, size_t);
+static double (*scaled_row)(const unsigned *, const unsigned *, size_t,
+                            unsigned, unsigned);
+static pthread_once_t kernels_once = PTHREAD_ONCE_INIT;
+
+/********** choose_kernels ********
+ *
+ * Points exact_row and scaled_row at the best copy the CPU can run.
+ ************************/
+static void choose_kernels(void)
+{
+        exact_row = exact_row_scalar;
+        scaled_row = scaled_row_scalar;
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") &&
+            __builtin_cpu_supports("avx512bw") &&
+            __builtin_cpu_supports("avx512dq") &&
+            __builtin_cpu_supports("avx512vl"))
+        {
+                exact_row = exact_row_avx512;
+                scaled_row = scaled_row_avx512;
+        }
+        else if (__builtin_cpu_supports("avx2"))
+        {
+                exact_row = exact_row_avx2;
+                scaled_row = scaled_row_avx2;
+        }
+#endif
+}
+
+/********** Rmse_row ********
+ *
+ * Adds the squared differences of a span of pixels to a sum.
+ *
+ * Parameters:
+ *      Rmse_sum *sum:                  The sum to add to.
+ *      const struct Pnm_rgb *a:        The span from the first image.
+ *      const struct Pnm_rgb *b:        The span from the second image.
+ *      size_t n:                       The number of pixels in each span.
+ *      unsigned denom_a:               The first image's denominator.
+ *      unsigned denom_b:               The second image's denominator.
+ *
+ * Expects:
+ *      sum must not be NULL, and a and b must not be NULL if n > 0.
+ *      Denominators must be in [1, 65535] and samples must not exceed
+ *      their image's denominator.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Every sum a row is added to must be for the same two denominators.
+ ************************/
+void Rmse_row(Rmse_sum *sum, const struct Pnm_rgb *a,
+              const struct Pnm_rgb *b, size_t n, unsigned denom_a,
+              unsigned denom_b)
+{
+        assert(sum != NULL);
+        assert(n == 0 || (a != NULL && b != NULL));
+        assert(denom_a >= 1 && denom_a <= 65535);
+        assert(denom_b >= 1 && denom_b <= 65535);
+        /* The kernels read a span as 3n consecutive samples */
+        assert(sizeof(struct Pnm_rgb) == 3 * sizeof(unsigned));
+        pthread_once(&kernels_once, choose_kernels);
+
+        const unsigned *x = (const unsigned *)a, *y = (const unsigned *)b;
+        if (denom_a == denom_b)
+        {
+                sum->exact += exact_row(x, y, 3 * n);
+        }
+        else
+        {
+                sum->scaled += scaled_row(x, y, 3 * n, denom_a, denom_b);
+        }
+        sum->samples += 3 * n;
+}
+
+/********** Rmse_add ********
+ *
+ * Adds one sum to another.
+ *
+ * Parameters:
+ *      Rmse_sum *into:         The sum to add to.
+ *      const Rmse_sum *from:   The sum to add.
+ *
+ * Expects:
+ *      into and from must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Rmse_add(Rmse_sum *into, const Rmse_sum *from)
+{
+        assert(into != NULL && from != NULL);
+        into->exact += from->exact;
+        into->scaled += from->scaled;
+        into->samples += from->samples;
+}
+
+/********** Rmse_value ********
+ *
+ * Gets the root mean square error a sum stands for, with samples scaled
+ * to [0, 1].
+ *
+ * Parameters:
+ *      const Rmse_sum *sum:    The sum.
+ *      unsigned denom_a:       The first image's denominator.
+ *      unsigned denom_b:       The second image's denominator.
+ *
+ * Return:
+ *      double:                 The error, or 0 for an empty sum.
+ *
+ * Expects:
+ *      sum must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+double Rmse_value(const Rmse_sum *sum, unsigned denom_a, unsigned denom_b)
+{
+        assert(sum != NULL);
+        if (sum->samples == 0)
+        {
+                return 0;
+        }
+
+        double mean;
+        if (denom_a == denom_b)
+        {
+                double denom = denom_a;
+                mean = (double)sum->exact / (denom * denom);
+        }
+        else
+        {
+                double denom = (double)denom_a * denom_b;
+                mean = sum->scaled / (denom * denom);
+        }
+        return sqrt(mean / sum->samples);
+}
+
+/********** Rmse_exceeds ********
+ *
+ * Tells whether a partial sum already makes the error over a whole image
+ * exceed a limit, whatever the samples not yet summed are.
+ *
+ * Parameters:
+ *      const Rmse_sum *sum:    The sum so far.
+ *      size_t samples:         The number of samples in the whole image.
+ *      unsigned denom_a:       The first image's denominator.
+ *      unsigned denom_b:       The second image's denominator.
+ *      double limit:           The limit on the error.
+ *
+ * Return:
+ *      int:                    1 if the error is certain to exceed limit.
+ *
+ * Expects:
+ *      sum must not be NULL, and samples must be at least sum->samples.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      The rest of the samples can only add to the sum, so the error over
+ *      the whole image is at least the sum so far spread over every sample.
+ ************************/
+int Rmse_exceeds(const Rmse_sum *sum, size_t samples, unsigned denom_a,
+                 unsigned denom_b, double limit)
+{
+        assert(sum != NULL);
+        assert(samples >= sum->samples);
+
+        Rmse_sum whole = *sum;
+        whole.samples = samples;
+        return Rmse_value(&whole, denom_a, denom_b) > limit;
+}
+
+/********** Band ********
+ *
+ * A band of rows to sum on one thread.
+ *
+ * Elements:
+ *      Pnm_ppm a, b:           The images.
+ *      size_t first_row:       The first row of the band.
+ *      size_t nrows:           The number of rows in the band.
+ *      size_t width:           The number of columns to sum.
+ *      Rmse_sum sum:           The band's sum.
+ ************************/
+typedef struct Band
+{
+        Pnm_ppm a, b;
+        size_t first_row;
+        size_t nrows;
+        size_t width;
+        Rmse_sum sum;
+} *Band;
+
+/********** sum_band ********
+ *
+ * Sums a Band, a row at a time when both images' rows are contiguous and
+ * a pixel at a time otherwise.
+ ************************/
+static void sum_band(void *arg)
+{
+        Band band = arg;
+        Pnm_ppm a = band->a, b = band->b;
+
+        for (size_t row = band->first_row;
+             row < band->first_row + band->nrows; row++)
+        {
+                struct Pnm_rgb *row_a = A2Methods_row(a->methods, a->pixels,
+                                                      row);
+                struct Pnm_rgb *row_b = A2Methods_row(b->methods, b->pixels,
+                                                      row);
+                if (row_a != NULL && row_b != NULL)
+                {
+                        Rmse_row(&band->sum, row_a, row_b, band->width,
+                                 a->denominator, b->denominator);
+                        continue;
+                }
+                for (size_t col = 0; col < band->width; col++)
+                {
+                        Rmse_row(&band->sum,
+                                 a->methods->at(a->pixels, col, row),
+                                 b->methods->at(b->pixels, col, row), 1,
+                                 a->denominator, b->denominator);
+                }
+        }
+}
+
+/********** Rmse_images ********
+ *
+ * Sums the squared differences over the region two images share.
+ *
+ * Parameters:
+ *      Pnm_ppm a:      The first image.
+ *      Pnm_ppm b:      The second image.
+ *      int threads:    The most threads to sum with; small images use
+ *                      fewer.
+ *
+ * Return:
+ *      Rmse_sum:       The sum over the top-left min-width x min-height
+ *                      pixels of both images.
+ *
+ * Expects:
+ *      a and b must not be NULL, and threads must be positive.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Bands are merged in order, so the result does not depend on the
+ *      number of threads.
+ ************************/
+Rmse_sum Rmse_images(Pnm_ppm a, Pnm_ppm b, int threads)
+{
+        assert(a != NULL && b != NULL);
+        assert(threads > 0);
+
+        size_t width = a->width < b->width ? a->width : b->width;
+        size_t height = a->height < b->height ? a->height : b->height;
+        size_t nbands = (height + BAND_ROWS - 1) / BAND_ROWS;
+        Rmse_sum total = {0, 0, 0};
+        if (nbands == 0)
+        {
+                return total;
+        }
+
+        Band bands = CALLOC(nbands, sizeof *bands);
+        for (size_t i = 0; i < nbands; i++)
+        {
+                bands[i].a = a;
+                bands[i].b = b;
+                bands[i].first_row = i * BAND_ROWS;
+                bands[i].nrows = height - i * BAND_ROWS < BAND_ROWS
+                                         ? height - i * BAND_ROWS
+                                         : BAND_ROWS;
+                bands[i].width = width;
+        }
+
+        if (width * height < MIN_PARALLEL_PIXELS)
+        {
+                threads = 1;
+        }
+        if ((size_t)threads > nbands)
+        {
+                threads = nbands;
+        }
+        if (threads == 1)
+        {
+                for (size_t i = 0; i < nbands; i++)
+                {
+                        sum_band(&bands[i]);
+                }
+        }
+        else
+        {
+                ThreadPool_T pool = ThreadPool_new(threads);
+                for (size_t i = 0; i < nbands; i++)
+                {
+                        ThreadPool_submit(pool, sum_band, &bands[i]);
+                }
+                ThreadPool_wait(pool);
+                ThreadPool_free(&pool);
+        }
+
+        for (size_t i = 0; i < nbands; i++)
+        {
+                Rmse_add(&total, &bands[i].sum);
+        }
+        FREE(bands);
+        return total;
+}
@@ -0,0 +1,160 @@
+/**************************************************************
+ *
+ *                     rmse.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for the root mean square error
+ *     between two images, as ppmdiff reports it. Errors are summed a row
+ *     span at a time into an Rmse_sum, so that an image can be compared
+ *     whole, in bands on several threads, or a row at a time as it is
+ *     read.
+ *
+ *     When the two images have the same denominator the squared sample
+ *     differences are integers, and they are summed exactly. Otherwise
+ *     each difference is cross-multiplied to an exact integer,
+ *     a * denom_b - b * denom_a, and its square is summed in doubles.
+ *
+ ************************/
+
+#ifndef RMSE_H
+#define RMSE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pnm.h"
+
+/********** Rmse_sum ********
+ *
+ * A running sum of squared differences.
+ *
+ * Elements:
+ *      uint64_t exact:    The sum of squared differences of samples, for
+ *                         images with the same denominator.
+ *      double scaled:     The sum of squared cross-multiplied differences,
+ *                         for images with different denominators.
+ *      size_t samples:    The number of samples (three per pixel) summed.
+ *
+ * Notes:
+ *      A zeroed Rmse_sum is empty.
+ ************************/
+typedef struct Rmse_sum
+{
+        uint64_t exact;
+        double scaled;
+        size_t samples;
+} Rmse_sum;
+
+/********** Rmse_row ********
+ *
+ * Adds the squared differences of a span of pixels to a sum.
+ *
+ * Parameters:
+ *      Rmse_sum *sum:                  The sum to add to.
+ *      const struct Pnm_rgb *a:        The span from the first image.
+ *      const struct Pnm_rgb *b:        The span from the second image.
+ *      size_t n:                       The number of pixels in each span.
+ *      unsigned denom_a:               The first image's denominator.
+ *      unsigned denom_b:               The second image's denominator.
+ *
+ * Expects:
+ *      sum must not be NULL, and a and b must not be NULL if n > 0.
+ *      Denominators must be in [1, 65535] and samples must not exceed
+ *      their image's denominator.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Every sum a row is added to must be for the same two denominators.
+ ************************/
+void Rmse_row(Rmse_sum *sum, const struct Pnm_rgb *a,
+              const struct Pnm_rgb *b, size_t n, unsigned denom_a,
+              unsigned denom_b);
+
+/********** Rmse_add ********
+ *
+ * Adds one sum to another.
+ *
+ * Parameters:
+ *      Rmse_sum *into:         The sum to add to.
+ *      const Rmse_sum *from:   The sum to add.
+ *
+ * Expects:
+ *      into and from must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Rmse_add(Rmse_sum *into, const Rmse_sum *from);
+
+/********** Rmse_value ********
+ *
+ * Gets the root mean square error a sum stands for, with samples scaled
+ * to [0, 1].
+ *
+ * Parameters:
+ *      const Rmse_sum *sum:    The sum.
+ *      unsigned denom_a:       The first image's denominator.
+ *      unsigned denom_b:       The second image's denominator.
+ *
+ * Return:
+ *      double:                 The error, or 0 for an empty sum.
+ *
+ * Expects:
+ *      sum must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+double Rmse_value(const Rmse_sum *sum, unsigned denom_a, unsigned denom_b);
+
+/********** Rmse_exceeds ********
+ *
+ * Tells whether a partial sum already makes the error over a whole image
+ * exceed a limit, whatever the samples not yet summed are.
+ *
+ * Parameters:
+ *      const Rmse_sum *sum:    The sum so far.
+ *      size_t samples:         The number of samples in the whole image.
+ *      unsigned denom_a:       The first image's denominator.
+ *      unsigned denom_b:       The second image's denominator.
+ *      double limit:           The limit on the error.
+ *
+ * Return:
+ *      int:                    1 if the error is certain to exceed limit.
+ *
+ * Expects:
+ *      sum must not be NULL, and samples must be at least sum->samples.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Rmse_exceeds(const Rmse_sum *sum, size_t samples, unsigned denom_a,
+                 unsigned denom_b, double limit);
+
+/********** Rmse_images ********
+ *
+ * Sums the squared differences over the region two images share.
+ *
+ * Parameters:
+ *      Pnm_ppm a:      The first image.
+ *      Pnm_ppm b:      The second image.
+ *      int threads:    The most threads to sum with; small images use
+ *                      fewer.
+ *
+ * Return:
+ *      Rmse_sum:       The sum over the top-left min-width x min-height
+ *                      pixels of both images.
+ *
+ * Expects:
+ *      a and b must not be NULL, and threads must be positive.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Bands are merged in order, so the result does not depend on the
+ *      number of threads.
+ ************************/
+Rmse_sum Rmse_images(Pnm_ppm a, Pnm_ppm b, int threads);
+
+#endif
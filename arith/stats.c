@@ -0,0 +1,280 @@
+/**************************************************************
+ *
+ *                     stats.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for the codec's run
+ *     statistics.
+ *
+ ************************/
+
+#include <sys/resource.h>
+
+#include "assert.h"
+#include "stats.h"
+#include "perfcount.h"
+
+int Stats_enabled = 0;
+int Stats_tracking = 0;
+__thread Stats_stage Stats_current = STATS_NONE;
+static int use_perf = 0;
+static int perf_requested = 0;
+static uint64_t perf_start[PERF_NCOUNTERS];
+
+static const char *STAGE_NAMES[STATS_NSTAGES + 1] = {
+        "read", "convert", "code", "write", "other"
+};
+
+/********** Stats ********
+ *
+ * Everything gathered for one run.
+ *
+ * Elements:
+ *      uint64_t ns[]:       Time charged to each stage.
+ *      uint64_t counts[][]: Hardware counts charged to each stage.
+ *      uint64_t start:      When the run was reset.
+ *      unsigned width:      The image's width in pixels.
+ *      unsigned height:     The image's height in pixels.
+ *      size_t blocks:       The number of blocks coded.
+ *      size_t bytes_in:     Bytes read.
+ *      size_t bytes_out:    Bytes written.
+ ************************/
+static struct Stats
+{
+        uint64_t ns[STATS_NSTAGES];
+        uint64_t counts[STATS_NSTAGES][PERF_NCOUNTERS];
+        uint64_t start;
+        unsigned width;
+        unsigned height;
+        size_t blocks;
+        size_t bytes_in;
+        size_t bytes_out;
+} stats;
+
+/********** Stats_perf_counters ********
+ *
+ * Also charges hardware performance counters (cycles, instructions,
+ * cache and branch misses) to each stage, and enables statistics.
+ *
+ * Return:
+ *      int:            The number of counters available. If 0, the kernel
+ *                      denied access and only wall-clock time is kept.
+ *
+ * Notes:
+ *      Stages must not nest while counters are in use.
+ *      Only the calling thread is counted; see perfcount.h.
+ ************************/
+int Stats_perf_counters(void)
+{
+        Stats_enabled = 1;
+        perf_requested = 1;
+        int opened = Perf_open();
+        use_perf = opened > 0;
+        return opened;
+}
+
+/********** Stats_mark ********
+ *
+ * Reads the clock, and the hardware counters if they are in use, at the
+ * start of a stage. Called through Stats_begin.
+ *
+ * Return:
+ *      uint64_t:       The current time.
+ ************************/
+uint64_t Stats_mark(void)
+{
+        if (use_perf)
+        {
+                Perf_read(perf_start);
+        }
+        return Timer_ns();
+}
+
+/********** Stats_end ********
+ *
+ * Adds the time since a Stats_begin to a stage, and leaves the stage.
+ *
+ * Parameters:
+ *      Stats_stage stage:  The stage to charge.
+ *      uint64_t start:     The value Stats_begin returned.
+ ************************/
+void Stats_end(Stats_stage stage, uint64_t start)
+{
+        if (Stats_enabled || Stats_tracking)
+        {
+                Stats_current = STATS_NONE;
+        }
+        if (Stats_enabled)
+        {
+                stats.ns[stage] += Timer_ns() - start;
+        }
+        if (use_perf)
+        {
+                uint64_t now[PERF_NCOUNTERS];
+                Perf_read(now);
+                for (int i = 0; i < PERF_NCOUNTERS; i++)
+                {
+                        stats.counts[stage][i] += now[i] - perf_start[i];
+                }
+        }
+}
+
+/********** Stats_reset ********
+ *
+ * Clears all counters and timers, ready for a new run.
+ ************************/
+void Stats_reset(void)
+{
+        struct Stats empty = {{0}, {{0}}, 0, 0, 0, 0, 0, 0};
+        stats = empty;
+        stats.start = Timer_ns();
+}
+
+/********** Stats_stage_name ********
+ *
+ * Gets the name of a stage.
+ *
+ * Parameters:
+ *      Stats_stage stage:  The stage, or STATS_NONE.
+ *
+ * Return:
+ *      const char *:       Its name; "other" for STATS_NONE.
+ ************************/
+const char *Stats_stage_name(Stats_stage stage)
+{
+        assert(stage <= STATS_NONE);
+        return STAGE_NAMES[stage];
+}
+
+/********** Stats_image ********
+ *
+ * Records the size of the image being coded.
+ *
+ * Parameters:
+ *      unsigned width:     The width of the image in pixels.
+ *      unsigned height:    The height of the image in pixels.
+ *      size_t blocks:      The number of 2x2 blocks coded.
+ ************************/
+void Stats_image(unsigned width, unsigned height, size_t blocks)
+{
+        stats.width = width;
+        stats.height = height;
+        stats.blocks = blocks;
+}
+
+/********** Stats_bytes ********
+ *
+ * Adds to the counts of bytes read and written.
+ *
+ * Parameters:
+ *      size_t in:          Bytes read.
+ *      size_t out:         Bytes written.
+ ************************/
+void Stats_bytes(size_t in, size_t out)
+{
+        stats.bytes_in += in;
+        stats.bytes_out += out;
+}
+
+/********** per_block ********
+ *
+ * Formats a counter divided by the number of blocks, or "n/a" if the
+ * counter is not available.
+ ************************/
+static const char *per_block(char *buf, size_t size, int stage,
+                             Perf_counter counter)
+{
+        if (!Perf_available(counter))
+        {
+                return "n/a";
+        }
+        snprintf(buf, size, "%.3f", stats.blocks == 0 ? 0.0 :
+                 (double)stats.counts[stage][counter] / stats.blocks);
+        return buf;
+}
+
+/********** report_counters ********
+ *
+ * Prints the hardware counters charged to each stage: cycles,
+ * instructions, instructions per cycle, and misses per block.
+ *
+ * Parameters:
+ *      FILE *out:          The stream to print to.
+ ************************/
+static void report_counters(FILE *out)
+{
+        fprintf(out, "  %-8s %14s %14s %6s %10s %10s %10s\n", "stage",
+                Perf_name(PERF_CYCLES), Perf_name(PERF_INSTRUCTIONS), "IPC",
+                "l1d/blk", "llc/blk", "br/blk");
+        for (int s = 0; s < STATS_NSTAGES; s++)
+        {
+                uint64_t *counts = stats.counts[s];
+                char l1d[32], llc[32], br[32];
+                double ipc = counts[PERF_CYCLES] == 0 ? 0 :
+                             (double)counts[PERF_INSTRUCTIONS] /
+                             counts[PERF_CYCLES];
+                fprintf(out, "  %-8s %14lu %14lu %6.2f %10s %10s %10s\n",
+                        STAGE_NAMES[s], (unsigned long)counts[PERF_CYCLES],
+                        (unsigned long)counts[PERF_INSTRUCTIONS], ipc,
+                        per_block(l1d, sizeof(l1d), s, PERF_L1D_MISSES),
+                        per_block(llc, sizeof(llc), s, PERF_LLC_MISSES),
+                        per_block(br, sizeof(br), s, PERF_BRANCH_MISSES));
+        }
+        fprintf(out, "  (counters cover the calling thread only, not work "
+                "run on a thread pool)\n");
+}
+
+/********** Stats_report ********
+ *
+ * Prints the statistics for the run.
+ *
+ * Parameters:
+ *      FILE *out:          The stream to print to.
+ *      const char *what:   The name of the run, e.g. "compress".
+ *
+ * Expects:
+ *      out and what must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Stats_report(FILE *out, const char *what)
+{
+        assert(out != NULL);
+        assert(what != NULL);
+
+        double total = (Timer_ns() - stats.start) / 1e6;
+        double pixel_mb = 3.0 * stats.width * stats.height / 1e6;
+
+        fprintf(out, "40image stats: %s %ux%u\n", what, stats.width,
+                stats.height);
+        fprintf(out, "  %-8s %10s %6s %10s\n", "stage", "ms", "%", "MB/s");
+        for (int s = 0; s < STATS_NSTAGES; s++)
+        {
+                double ms = stats.ns[s] / 1e6;
+                fprintf(out, "  %-8s %10.3f %6.1f %10.1f\n", STAGE_NAMES[s],
+                        ms, total > 0 ? 100 * ms / total : 0,
+                        ms > 0 ? pixel_mb / ms * 1e3 : 0);
+        }
+        fprintf(out, "  %-8s %10.3f %6.1f %10.1f\n", "total", total, 100.0,
+                total > 0 ? pixel_mb / total * 1e3 : 0);
+
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+        fprintf(out, "  blocks      %zu\n", stats.blocks);
+        fprintf(out, "  bytes_in    %zu\n", stats.bytes_in);
+        fprintf(out, "  bytes_out   %zu\n", stats.bytes_out);
+        fprintf(out, "  peak_rss_kb %ld\n", usage.ru_maxrss);
+
+        if (use_perf)
+        {
+                report_counters(out);
+        }
+        else if (perf_requested)
+        {
+                fprintf(out, "  perf counters unavailable; wall-clock only\n");
+        }
+}
@@ -0,0 +1,181 @@
+/**************************************************************
+ *
+ *                     stats.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for the codec's run statistics:
+ *     monotonic time per pipeline stage, block and byte counts, peak RSS
+ *     and throughput, reported to stderr at the end of a run.
+ *
+ *     Statistics are off unless Stats_enabled is set (40image sets it for
+ *     --stats or a non-empty COMP40_STATS). When off, each instrumentation
+ *     point is one predictable branch. Stages are timed per column of
+ *     blocks or per whole-image pass, never per block, so the cost when on
+ *     is a few clock reads per column.
+ *
+ *     Hardware counters per stage can be added with
+ *     Stats_perf_counters; they cost two reads of the counter group per
+ *     timed section.
+ *
+ *     The counters are process-wide and unsynchronized: only one thread
+ *     may code with statistics enabled. The current stage is kept per
+ *     thread.
+ *
+ ************************/
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "timer.h"
+
+/********** Stats_stage ********
+ *
+ * The stages of the pipeline that are timed separately.
+ *
+ * Values:
+ *      STATS_READ:      Reading and parsing the input.
+ *      STATS_CONVERT:   Converting between RGB and planar component video.
+ *      STATS_CODE:      The DCT, quantization and word packing, or the
+ *                       reverse.
+ *      STATS_WRITE:     Writing the output.
+ ************************/
+typedef enum Stats_stage
+{
+        STATS_READ,
+        STATS_CONVERT,
+        STATS_CODE,
+        STATS_WRITE,
+        STATS_NSTAGES
+} Stats_stage;
+
+/* The value of Stats_current outside every stage */
+#define STATS_NONE STATS_NSTAGES
+
+/* Nonzero while statistics are being gathered */
+extern int Stats_enabled;
+
+/* Nonzero while Stats_current is kept with statistics off; set by the
+ * accounting allocator (memacct.c), which charges allocations to it */
+extern int Stats_tracking;
+
+/* The stage the calling thread is running, or STATS_NONE; kept only while
+ * Stats_enabled or Stats_tracking is set */
+extern __thread Stats_stage Stats_current;
+
+/********** Stats_mark ********
+ *
+ * Reads the clock, and the hardware counters if they are in use, at the
+ * start of a stage. Called through Stats_begin.
+ *
+ * Return:
+ *      uint64_t:       The current time.
+ ************************/
+uint64_t Stats_mark(void);
+
+/********** Stats_begin ********
+ *
+ * Starts timing a stage.
+ *
+ * Parameters:
+ *      Stats_stage stage:  The stage that is starting.
+ *
+ * Return:
+ *      uint64_t:           A start time to pass to Stats_end, or 0 when
+ *                          statistics are off.
+ ************************/
+static inline uint64_t Stats_begin(Stats_stage stage)
+{
+        if (!Stats_enabled && !Stats_tracking)
+        {
+                return 0;
+        }
+        Stats_current = stage;
+        return Stats_enabled ? Stats_mark() : 0;
+}
+
+/********** Stats_perf_counters ********
+ *
+ * Also charges hardware performance counters (cycles, instructions,
+ * cache and branch misses) to each stage, and enables statistics.
+ *
+ * Return:
+ *      int:            The number of counters available. If 0, the kernel
+ *                      denied access and only wall-clock time is kept.
+ *
+ * Notes:
+ *      Stages must not nest while counters are in use.
+ *      Only the calling thread is counted; see perfcount.h.
+ ************************/
+int Stats_perf_counters(void);
+
+/********** Stats_end ********
+ *
+ * Adds the time since a Stats_begin to a stage, and leaves the stage.
+ *
+ * Parameters:
+ *      Stats_stage stage:  The stage to charge.
+ *      uint64_t start:     The value Stats_begin returned.
+ ************************/
+void Stats_end(Stats_stage stage, uint64_t start);
+
+/********** Stats_reset ********
+ *
+ * Clears all counters and timers, ready for a new run.
+ ************************/
+void Stats_reset(void);
+
+/********** Stats_stage_name ********
+ *
+ * Gets the name of a stage.
+ *
+ * Parameters:
+ *      Stats_stage stage:  The stage, or STATS_NONE.
+ *
+ * Return:
+ *      const char *:       Its name; "other" for STATS_NONE.
+ ************************/
+const char *Stats_stage_name(Stats_stage stage);
+
+/********** Stats_image ********
+ *
+ * Records the size of the image being coded.
+ *
+ * Parameters:
+ *      unsigned width:     The width of the image in pixels.
+ *      unsigned height:    The height of the image in pixels.
+ *      size_t blocks:      The number of 2x2 blocks coded.
+ ************************/
+void Stats_image(unsigned width, unsigned height, size_t blocks);
+
+/********** Stats_bytes ********
+ *
+ * Adds to the counts of bytes read and written.
+ *
+ * Parameters:
+ *      size_t in:          Bytes read.
+ *      size_t out:         Bytes written.
+ ************************/
+void Stats_bytes(size_t in, size_t out);
+
+/********** Stats_report ********
+ *
+ * Prints the statistics for the run.
+ *
+ * Parameters:
+ *      FILE *out:          The stream to print to.
+ *      const char *what:   The name of the run, e.g. "compress".
+ *
+ * Expects:
+ *      out and what must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Stats_report(FILE *out, const char *what);
+
+#endif
@@ -0,0 +1,283 @@
+/**************************************************************
+ *
+ *                     threadpool.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for a fixed-size pool of
+ *     worker threads. Jobs are kept in a singly linked FIFO protected by
+ *     one mutex; workers sleep on a condition variable while it is empty.
+ *
+ ************************/
+
+#include <pthread.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "threadpool.h"
+#include "trace.h"
+
+/********** Job ********
+ *
+ * A queued job.
+ *
+ * Elements:
+ *      ThreadPool_job *fn:     The function to run.
+ *      void *arg:              The argument passed to fn.
+ *      struct Job *next:       The next job in the queue.
+ ************************/
+typedef struct Job
+{
+        ThreadPool_job *fn;
+        void *arg;
+        struct Job *next;
+} *Job;
+
+/********** ThreadPool_T ********
+ *
+ * Elements:
+ *      pthread_mutex_t lock:   Protects every other field.
+ *      pthread_cond_t ready:   Signalled when a job is queued or the pool
+ *                              is shutting down.
+ *      pthread_cond_t idle:    Signalled when pending drops to zero.
+ *      Job head, tail:         The job queue.
+ *      int pending:            Jobs queued or running.
+ *      int stopping:           Set when workers should exit.
+ *      int nthreads:           The number of workers.
+ *      pthread_t *threads:     The worker threads.
+ ************************/
+struct ThreadPool_T
+{
+        pthread_mutex_t lock;
+        pthread_cond_t ready;
+        pthread_cond_t idle;
+        Job head;
+        Job tail;
+        int pending;
+        int stopping;
+        int nthreads;
+        pthread_t *threads;
+};
+
+/********** worker ********
+ *
+ * The body of every worker thread. Runs jobs until the pool is stopping
+ * and the queue is empty.
+ *
+ * Parameters:
+ *      void *vpool:    The ThreadPool_T the worker belongs to.
+ *
+ * Return:
+ *      NULL.
+ ************************/
+static void *worker(void *vpool)
+{
+        ThreadPool_T pool = vpool;
+
+        pthread_mutex_lock(&pool->lock);
+        for (;;)
+        {
+                while (pool->head == NULL && !pool->stopping)
+                {
+                        pthread_cond_wait(&pool->ready, &pool->lock);
+                }
+                if (pool->head == NULL)
+                {
+                        break;
+                }
+
+                Job job = pool->head;
+                pool->head = job->next;
+                if (pool->head == NULL)
+                {
+                        pool->tail = NULL;
+                }
+                pthread_mutex_unlock(&pool->lock);
+
+                Trace_begin("job", TRACE_NO_STRIP);
+                job->fn(job->arg);
+                Trace_end("job", TRACE_NO_STRIP);
+                FREE(job);
+
+                pthread_mutex_lock(&pool->lock);
+                if (--pool->pending == 0)
+                {
+                        pthread_cond_broadcast(&pool->idle);
+                }
+        }
+        pthread_mutex_unlock(&pool->lock);
+
+        return NULL;
+}
+
+/********** ThreadPool_new ********
+ *
+ * Creates a pool and starts all of its worker threads.
+ *
+ * Parameters:
+ *      int nthreads:   The number of worker threads to start.
+ *
+ * Return:
+ *      ThreadPool_T:   A new pool with an empty job queue.
+ *
+ * Expects:
+ *      nthreads must be greater than 0.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated or a thread cannot be
+ *      created.
+ *      Client is responsible for freeing the pool with ThreadPool_free.
+ ************************/
+ThreadPool_T ThreadPool_new(int nthreads)
+{
+        assert(nthreads > 0);
+
+        ThreadPool_T pool;
+        NEW(pool);
+        pthread_mutex_init(&pool->lock, NULL);
+        pthread_cond_init(&pool->ready, NULL);
+        pthread_cond_init(&pool->idle, NULL);
+        pool->head = NULL;
+        pool->tail = NULL;
+        pool->pending = 0;
+        pool->stopping = 0;
+        pool->nthreads = nthreads;
+        pool->threads = CALLOC(nthreads, sizeof(pthread_t));
+
+        for (int i = 0; i < nthreads; i++)
+        {
+                int rc = pthread_create(&pool->threads[i], NULL, worker, pool);
+                assert(rc == 0);
+        }
+
+        return pool;
+}
+
+/********** ThreadPool_submit ********
+ *
+ * Appends a job to the pool's queue.
+ *
+ * Parameters:
+ *      ThreadPool_T pool:      The pool to run the job on.
+ *      ThreadPool_job *job:    The function to run.
+ *      void *arg:              The argument passed to job.
+ *
+ * Expects:
+ *      pool and job must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void ThreadPool_submit(ThreadPool_T pool,
+                       ThreadPool_job *job,
+                       void *arg)
+{
+        assert(pool != NULL);
+        assert(job != NULL);
+
+        Job j;
+        NEW(j);
+        j->fn = job;
+        j->arg = arg;
+        j->next = NULL;
+
+        pthread_mutex_lock(&pool->lock);
+        if (pool->tail == NULL)
+        {
+                pool->head = j;
+        }
+        else
+        {
+                pool->tail->next = j;
+        }
+        pool->tail = j;
+        pool->pending++;
+        pthread_cond_signal(&pool->ready);
+        pthread_mutex_unlock(&pool->lock);
+}
+
+/********** ThreadPool_wait ********
+ *
+ * Blocks until every job submitted so far has finished running.
+ *
+ * Parameters:
+ *      ThreadPool_T pool:      The pool to wait on.
+ *
+ * Expects:
+ *      pool must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void ThreadPool_wait(ThreadPool_T pool)
+{
+        assert(pool != NULL);
+
+        pthread_mutex_lock(&pool->lock);
+        while (pool->pending > 0)
+        {
+                pthread_cond_wait(&pool->idle, &pool->lock);
+        }
+        pthread_mutex_unlock(&pool->lock);
+}
+
+/********** ThreadPool_size ********
+ *
+ * Gets the number of worker threads in the pool.
+ *
+ * Parameters:
+ *      ThreadPool_T pool:      The pool to query.
+ *
+ * Return:
+ *      int:                    The number of workers.
+ *
+ * Expects:
+ *      pool must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int ThreadPool_size(ThreadPool_T pool)
+{
+        assert(pool != NULL);
+        return pool->nthreads;
+}
+
+/********** ThreadPool_free ********
+ *
+ * Waits for queued jobs to finish, stops the workers and frees the pool.
+ *
+ * Parameters:
+ *      ThreadPool_T *pool:     A pointer to the pool to be freed.
+ *
+ * Expects:
+ *      pool and *pool must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      The pointer *pool will be set to NULL after freeing.
+ ************************/
+void ThreadPool_free(ThreadPool_T *pool)
+{
+        assert(pool != NULL);
+        assert(*pool != NULL);
+        ThreadPool_T p = *pool;
+
+        pthread_mutex_lock(&p->lock);
+        p->stopping = 1;
+        pthread_cond_broadcast(&p->ready);
+        pthread_mutex_unlock(&p->lock);
+
+        for (int i = 0; i < p->nthreads; i++)
+        {
+                pthread_join(p->threads[i], NULL);
+        }
+
+        pthread_cond_destroy(&p->idle);
+        pthread_cond_destroy(&p->ready);
+        pthread_mutex_destroy(&p->lock);
+        FREE(p->threads);
+        FREE(*pool);
+}
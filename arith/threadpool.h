@@ -0,0 +1,119 @@
+/**************************************************************
+ *
+ *                     threadpool.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for a fixed-size pool of worker
+ *     threads. All threads are created up front; clients submit jobs
+ *     which are run in FIFO order by whichever worker is free.
+ *
+ ************************/
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+/********** ThreadPool_T ********
+ *
+ * An opaque handle to a pool of worker threads and its job queue.
+ ************************/
+typedef struct ThreadPool_T *ThreadPool_T;
+
+/********** ThreadPool_job ********
+ *
+ * The type of a job run by a worker. The argument is the pointer that was
+ * passed to ThreadPool_submit.
+ ************************/
+typedef void ThreadPool_job(void *arg);
+
+/********** ThreadPool_new ********
+ *
+ * Creates a pool and starts all of its worker threads.
+ *
+ * Parameters:
+ *      int nthreads:   The number of worker threads to start.
+ *
+ * Return:
+ *      ThreadPool_T:   A new pool with an empty job queue.
+ *
+ * Expects:
+ *      nthreads must be greater than 0.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated or a thread cannot be
+ *      created.
+ *      Client is responsible for freeing the pool with ThreadPool_free.
+ ************************/
+ThreadPool_T ThreadPool_new(int nthreads);
+
+/********** ThreadPool_submit ********
+ *
+ * Appends a job to the pool's queue.
+ *
+ * Parameters:
+ *      ThreadPool_T pool:      The pool to run the job on.
+ *      ThreadPool_job *job:    The function to run.
+ *      void *arg:              The argument passed to job.
+ *
+ * Expects:
+ *      pool and job must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void ThreadPool_submit(ThreadPool_T pool,
+                       ThreadPool_job *job,
+                       void *arg);
+
+/********** ThreadPool_wait ********
+ *
+ * Blocks until every job submitted so far has finished running.
+ *
+ * Parameters:
+ *      ThreadPool_T pool:      The pool to wait on.
+ *
+ * Expects:
+ *      pool must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void ThreadPool_wait(ThreadPool_T pool);
+
+/********** ThreadPool_size ********
+ *
+ * Gets the number of worker threads in the pool.
+ *
+ * Parameters:
+ *      ThreadPool_T pool:      The pool to query.
+ *
+ * Return:
+ *      int:                    The number of workers.
+ *
+ * Expects:
+ *      pool must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int ThreadPool_size(ThreadPool_T pool);
+
+/********** ThreadPool_free ********
+ *
+ * Waits for queued jobs to finish, stops the workers and frees the pool.
+ *
+ * Parameters:
+ *      ThreadPool_T *pool:     A pointer to the pool to be freed.
+ *
+ * Expects:
+ *      pool and *pool must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      The pointer *pool will be set to NULL after freeing.
+ ************************/
+void ThreadPool_free(ThreadPool_T *pool);
+
+#endif
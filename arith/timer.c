@@ -0,0 +1,69 @@
+/**************************************************************
+ *
+ *                     timer.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for the codec's clocks.
+ *
+ ************************/
+
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#else
+#define HAVE_TSC 0
+#endif
+
+#include "timer.h"
+
+/********** Timer_ns ********
+ *
+ * Reads the monotonic clock.
+ *
+ * Return:
+ *      uint64_t:       Nanoseconds since an arbitrary fixed point.
+ ************************/
+uint64_t Timer_ns(void)
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/********** Timer_has_cycles ********
+ *
+ * Tells whether Timer_cycles reads a real cycle counter.
+ *
+ * Return:
+ *      int:            1 if it does, 0 if Timer_cycles always returns 0.
+ ************************/
+int Timer_has_cycles(void)
+{
+        return HAVE_TSC;
+}
+
+/********** Timer_cycles ********
+ *
+ * Reads the CPU's time-stamp counter.
+ *
+ * Return:
+ *      uint64_t:       Reference cycles since an arbitrary fixed point, or
+ *                      0 if Timer_has_cycles is 0.
+ *
+ * Notes:
+ *      On x86 this counts at a constant rate, not the core's current
+ *      clock, so it is a proxy for cycles rather than an exact count.
+ ************************/
+uint64_t Timer_cycles(void)
+{
+#if HAVE_TSC
+        return __rdtsc();
+#else
+        return 0;
+#endif
+}
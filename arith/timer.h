@@ -0,0 +1,52 @@
+/**************************************************************
+ *
+ *                     timer.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for the clocks used to time the
+ *     codec: a monotonic nanosecond clock, and the CPU's cycle counter
+ *     where the hardware has one that user code may read.
+ *
+ ************************/
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+
+/********** Timer_ns ********
+ *
+ * Reads the monotonic clock.
+ *
+ * Return:
+ *      uint64_t:       Nanoseconds since an arbitrary fixed point.
+ ************************/
+uint64_t Timer_ns(void);
+
+/********** Timer_has_cycles ********
+ *
+ * Tells whether Timer_cycles reads a real cycle counter.
+ *
+ * Return:
+ *      int:            1 if it does, 0 if Timer_cycles always returns 0.
+ ************************/
+int Timer_has_cycles(void);
+
+/********** Timer_cycles ********
+ *
+ * Reads the CPU's time-stamp counter.
+ *
+ * Return:
+ *      uint64_t:       Reference cycles since an arbitrary fixed point, or
+ *                      0 if Timer_has_cycles is 0.
+ *
+ * Notes:
+ *      On x86 this counts at a constant rate, not the core's current
+ *      clock, so it is a proxy for cycles rather than an exact count.
+ ************************/
+uint64_t Timer_cycles(void);
+
+#endif
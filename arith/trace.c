@@ -0,0 +1,183 @@
+/**************************************************************
+ *
+ *                     trace.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for timeline tracing. Each
+ *     thread lazily allocates a fixed-size event buffer and pushes it onto
+ *     a global list with a compare-and-swap; after that only the owning
+ *     thread touches the buffer until the dump.
+ *
+ ************************/
+
+#include <stdint.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "timer.h"
+#include "trace.h"
+
+#define EVENTS_PER_THREAD 65536
+
+int Trace_enabled = 0;
+
+/********** Event ********
+ *
+ * One recorded event.
+ *
+ * Elements:
+ *      uint64_t ns:        When it happened, on the Timer_ns clock.
+ *      const char *name:   The stage.
+ *      long strip:         The strip, or TRACE_NO_STRIP.
+ *      char phase:         'B' or 'E'.
+ ************************/
+typedef struct Event
+{
+        uint64_t ns;
+        const char *name;
+        long strip;
+        char phase;
+} Event;
+
+/********** Buffer ********
+ *
+ * One thread's events.
+ *
+ * Elements:
+ *      struct Buffer *next:  The next buffer in the global list.
+ *      int tid:              The number the trace shows for the thread.
+ *      size_t count:         Events recorded.
+ *      size_t dropped:       Events lost because the buffer was full.
+ *      Event events[]:       The events.
+ ************************/
+typedef struct Buffer
+{
+        struct Buffer *next;
+        int tid;
+        size_t count;
+        size_t dropped;
+        Event events[EVENTS_PER_THREAD];
+} *Buffer;
+
+static Buffer buffers = NULL;
+static int next_tid = 0;
+static uint64_t epoch = 0;
+static __thread Buffer mine = NULL;
+
+/********** Trace_start ********
+ *
+ * Turns tracing on. Event times are reported relative to this call.
+ ************************/
+void Trace_start(void)
+{
+        epoch = Timer_ns();
+        Trace_enabled = 1;
+}
+
+/********** thread_buffer ********
+ *
+ * Gets the calling thread's buffer, creating and publishing it on first
+ * use.
+ ************************/
+static Buffer thread_buffer(void)
+{
+        if (mine == NULL)
+        {
+                NEW(mine);
+                mine->tid = __atomic_add_fetch(&next_tid, 1,
+                                               __ATOMIC_RELAXED);
+                mine->count = 0;
+                mine->dropped = 0;
+                mine->next = __atomic_load_n(&buffers, __ATOMIC_RELAXED);
+                while (!__atomic_compare_exchange_n(&buffers, &mine->next,
+                                                    mine, 1,
+                                                    __ATOMIC_RELEASE,
+                                                    __ATOMIC_RELAXED))
+                {
+                        /* mine->next was reloaded; try again */
+                }
+        }
+        return mine;
+}
+
+/********** Trace_event ********
+ *
+ * Records one event in the calling thread's buffer. Called through
+ * Trace_begin and Trace_end.
+ *
+ * Parameters:
+ *      char phase:         'B' for begin or 'E' for end.
+ *      const char *name:   The name of the stage. Must outlive the trace,
+ *                          e.g. a string literal.
+ *      long strip:         The strip the event belongs to, or
+ *                          TRACE_NO_STRIP.
+ *
+ * Notes:
+ *      Events past a thread's buffer capacity are dropped and counted.
+ ************************/
+void Trace_event(char phase, const char *name, long strip)
+{
+        Buffer buffer = thread_buffer();
+        if (buffer->count == EVENTS_PER_THREAD)
+        {
+                buffer->dropped++;
+                return;
+        }
+
+        /* Fill the slot before publishing it, for a concurrent dump */
+        Event *event = &buffer->events[buffer->count];
+        event->ns = Timer_ns();
+        event->name = name;
+        event->strip = strip;
+        event->phase = phase;
+        __atomic_store_n(&buffer->count, buffer->count + 1, __ATOMIC_RELEASE);
+}
+
+/********** Trace_dump ********
+ *
+ * Writes every recorded event as a Chrome trace JSON object.
+ *
+ * Parameters:
+ *      FILE *out:          The stream to write to.
+ *
+ * Expects:
+ *      out must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Events recorded while the dump runs may be left out.
+ ************************/
+void Trace_dump(FILE *out)
+{
+        assert(out != NULL);
+
+        size_t dropped = 0;
+        const char *sep = "";
+        fprintf(out, "{\"traceEvents\": [\n");
+        for (Buffer b = __atomic_load_n(&buffers, __ATOMIC_ACQUIRE);
+             b != NULL; b = b->next)
+        {
+                size_t count = __atomic_load_n(&b->count, __ATOMIC_ACQUIRE);
+                for (size_t i = 0; i < count; i++)
+                {
+                        Event *e = &b->events[i];
+                        fprintf(out, "%s{\"name\": \"%s\", \"ph\": \"%c\", "
+                                "\"ts\": %.3f, \"pid\": 1, \"tid\": %d",
+                                sep, e->name, e->phase,
+                                (e->ns - epoch) / 1e3, b->tid);
+                        if (e->strip != TRACE_NO_STRIP)
+                        {
+                                fprintf(out, ", \"args\": {\"strip\": %ld}",
+                                        e->strip);
+                        }
+                        fprintf(out, "}");
+                        sep = ",\n";
+                }
+                dropped += b->dropped;
+        }
+        fprintf(out, "\n], \"displayTimeUnit\": \"ms\", "
+                "\"otherData\": {\"dropped_events\": %zu}}\n", dropped);
+}
@@ -0,0 +1,102 @@
+/**************************************************************
+ *
+ *                     trace.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for timeline tracing. While
+ *     tracing is on, begin and end events for each stage, strip and job
+ *     are appended to a buffer owned by the calling thread, so recording
+ *     takes no lock. Trace_dump writes every thread's events as Chrome
+ *     trace JSON, which chrome://tracing and ui.perfetto.dev can open.
+ *
+ *     When tracing is off, each instrumentation point is one predictable
+ *     branch on Trace_enabled.
+ *
+ ************************/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdio.h>
+
+/* Nonzero while events are being recorded */
+extern int Trace_enabled;
+
+/* The value of the strip argument for events that are not per strip */
+#define TRACE_NO_STRIP (-1L)
+
+/********** Trace_event ********
+ *
+ * Records one event in the calling thread's buffer. Called through
+ * Trace_begin and Trace_end.
+ *
+ * Parameters:
+ *      char phase:         'B' for begin or 'E' for end.
+ *      const char *name:   The name of the stage. Must outlive the trace,
+ *                          e.g. a string literal.
+ *      long strip:         The strip the event belongs to, or
+ *                          TRACE_NO_STRIP.
+ *
+ * Notes:
+ *      Events past a thread's buffer capacity are dropped and counted.
+ ************************/
+void Trace_event(char phase, const char *name, long strip);
+
+/********** Trace_begin ********
+ *
+ * Records the start of a stage, if tracing is on.
+ *
+ * Parameters:
+ *      const char *name:   The name of the stage.
+ *      long strip:         The strip, or TRACE_NO_STRIP.
+ ************************/
+static inline void Trace_begin(const char *name, long strip)
+{
+        if (Trace_enabled)
+        {
+                Trace_event('B', name, strip);
+        }
+}
+
+/********** Trace_end ********
+ *
+ * Records the end of a stage, if tracing is on.
+ *
+ * Parameters:
+ *      const char *name:   The name of the stage, as given to Trace_begin.
+ *      long strip:         The strip, as given to Trace_begin.
+ ************************/
+static inline void Trace_end(const char *name, long strip)
+{
+        if (Trace_enabled)
+        {
+                Trace_event('E', name, strip);
+        }
+}
+
+/********** Trace_start ********
+ *
+ * Turns tracing on. Event times are reported relative to this call.
+ ************************/
+void Trace_start(void);
+
+/********** Trace_dump ********
+ *
+ * Writes every recorded event as a Chrome trace JSON object.
+ *
+ * Parameters:
+ *      FILE *out:          The stream to write to.
+ *
+ * Expects:
+ *      out must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Events recorded while the dump runs may be left out.
+ ************************/
+void Trace_dump(FILE *out);
+
+#endif
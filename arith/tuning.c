@@ -0,0 +1,473 @@
+/**************************************************************
+ *
+ *                     tuning.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for the codec's tuning
+ *     parameters and the auto-tuner.
+ *
+ *     A strip is sized so that its columns of the frame fit in the L2
+ *     cache: each column of 2x2 blocks covers two pixel columns of three
+ *     float planes, 24 bytes per pixel row. The tuner tries thread counts
+ *     with that width, then widths around it with the fastest thread
+ *     count, and keeps whatever ran fastest.
+ *
+ ************************/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "compress40_io.h"
+#include "ppmsynth.h"
+#include "stats.h"
+#include "timer.h"
+#include "tuning.h"
+
+Tuning Tuning_current = { 1, 1 };
+
+/* Each candidate is timed this many times, and its fastest run counts */
+#define RUNS 3
+
+/* The side of the synthetic calibration image, in pixels */
+#define SYNTHETIC_SIZE 1024
+
+/* Bounds on what a config file may set */
+#define MAX_THREADS 256
+#define MAX_STRIP_COLS (1u << 20)
+
+/********** read_cache_file ********
+ *
+ * Reads the first line of a file under one cache's sysfs directory.
+ *
+ * Parameters:
+ *      int index:      The cache's index directory.
+ *      const char *name:   The file to read.
+ *      char *buf:      Where to store the line, without its newline.
+ *      size_t size:    The size of buf.
+ *
+ * Return:
+ *      int:            1 if the file was read, else 0.
+ ************************/
+static int read_cache_file(int index, const char *name, char *buf,
+                           size_t size)
+{
+        char path[128];
+        snprintf(path, sizeof path,
+                 "/sys/devices/system/cpu/cpu0/cache/index%d/%s", index, name);
+
+        FILE *fp = fopen(path, "r");
+        if (fp == NULL)
+        {
+                return 0;
+        }
+        int ok = fgets(buf, size, fp) != NULL;
+        fclose(fp);
+        if (ok)
+        {
+                buf[strcspn(buf, "\n")] = '\0';
+        }
+        return ok;
+}
+
+/********** parse_size ********
+ *
+ * Parses a sysfs size such as "48K" or "105M" into bytes.
+ ************************/
+static size_t parse_size(const char *text)
+{
+        char *end;
+        size_t size = strtoul(text, &end, 10);
+        switch (*end)
+        {
+        case 'K':
+                return size << 10;
+        case 'M':
+                return size << 20;
+        case 'G':
+                return size << 30;
+        default:
+                return size;
+        }
+}
+
+/********** Tuning_topology ********
+ *
+ * Reads the cache topology.
+ *
+ * Parameters:
+ *      Cache_topology *topology:  Where to store it.
+ *
+ * Expects:
+ *      topology must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Tuning_topology(Cache_topology *topology)
+{
+        assert(topology != NULL);
+        memset(topology, 0, sizeof *topology);
+
+        char level[16], type[32], size[32], line[32];
+        int deepest = 0;
+        for (int i = 0; read_cache_file(i, "level", level, sizeof level); i++)
+        {
+                if (!read_cache_file(i, "type", type, sizeof type) ||
+                    !read_cache_file(i, "size", size, sizeof size) ||
+                    strcmp(type, "Instruction") == 0)
+                {
+                        continue;
+                }
+
+                int l = atoi(level);
+                size_t bytes = parse_size(size);
+                if (l == 1)
+                {
+                        topology->l1d = bytes;
+                }
+                else if (l == 2)
+                {
+                        topology->l2 = bytes;
+                }
+                if (l >= deepest)
+                {
+                        deepest = l;
+                        topology->llc = bytes;
+                }
+                if (read_cache_file(i, "coherency_line_size", line,
+                                    sizeof line))
+                {
+                        topology->line = strtoul(line, NULL, 10);
+                }
+        }
+
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        topology->cpus = cpus > 0 ? cpus : 1;
+}
+
+/********** Tuning_path ********
+ *
+ * Gets the path of the config file.
+ *
+ * Return:
+ *      const char *:   The path, or NULL if there is none (no
+ *                      COMP40_TUNING and no HOME).
+ ************************/
+const char *Tuning_path(void)
+{
+        static char path[4096];
+
+        const char *env = getenv("COMP40_TUNING");
+        if (env != NULL && *env != '\0')
+        {
+                return env;
+        }
+        const char *home = getenv("HOME");
+        if (home == NULL || *home == '\0' ||
+            snprintf(path, sizeof path, "%s/.comp40tune", home) >=
+                    (int)sizeof path)
+        {
+                return NULL;
+        }
+        return path;
+}
+
+/********** Tuning_load ********
+ *
+ * Reads tuning parameters from a config file into Tuning_current.
+ *
+ * Parameters:
+ *      const char *path:   The file to read.
+ *
+ * Return:
+ *      int:                1 if the file was read, 0 if it could not be
+ *                          opened.
+ *
+ * Expects:
+ *      path must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Values that are missing or out of range are left as they were.
+ ************************/
+int Tuning_load(const char *path)
+{
+        assert(path != NULL);
+
+        FILE *fp = fopen(path, "r");
+        if (fp == NULL)
+        {
+                return 0;
+        }
+
+        char line[256], key[64];
+        long value;
+        while (fgets(line, sizeof line, fp) != NULL)
+        {
+                if (line[0] == '#' ||
+                    sscanf(line, "%63s %ld", key, &value) != 2)
+                {
+                        continue;
+                }
+                if (strcmp(key, "threads") == 0 && value >= 1 &&
+                    value <= MAX_THREADS)
+                {
+                        Tuning_current.threads = value;
+                }
+                else if (strcmp(key, "strip_cols") == 0 && value >= 1 &&
+                         value <= (long)MAX_STRIP_COLS)
+                {
+                        Tuning_current.strip_cols = value;
+                }
+        }
+        fclose(fp);
+        return 1;
+}
+
+/********** Tuning_save ********
+ *
+ * Writes Tuning_current, and the topology it was tuned for, to a config
+ * file.
+ *
+ * Parameters:
+ *      const char *path:               The file to write.
+ *      const Cache_topology *topology: The topology, recorded for
+ *                                      reference.
+ *
+ * Return:
+ *      int:                            1 if the file was written, else 0.
+ *
+ * Expects:
+ *      path and topology must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Tuning_save(const char *path, const Cache_topology *topology)
+{
+        assert(path != NULL);
+        assert(topology != NULL);
+
+        FILE *fp = fopen(path, "w");
+        if (fp == NULL)
+        {
+                return 0;
+        }
+        fprintf(fp, "# written by 40image --autotune\n"
+                "threads %d\n"
+                "strip_cols %u\n"
+                "cpus %d\n"
+                "line %zu\n"
+                "l1d %zu\n"
+                "l2 %zu\n"
+                "llc %zu\n",
+                Tuning_current.threads, Tuning_current.strip_cols,
+                topology->cpus, topology->line, topology->l1d, topology->l2,
+                topology->llc);
+        return fclose(fp) == 0;
+}
+
+/********** time_codec ********
+ *
+ * Times compressing an image and decompressing the result with
+ * Tuning_current.
+ *
+ * Parameters:
+ *      const char *ppm:        The image as PPM bytes.
+ *      size_t len:             The number of bytes in ppm.
+ *
+ * Return:
+ *      uint64_t:               The fastest of RUNS round trips, in ns.
+ ************************/
+static uint64_t time_codec(const char *ppm, size_t len)
+{
+        uint64_t best = UINT64_MAX;
+
+        for (int run = 0; run < RUNS; run++)
+        {
+                char *compressed = NULL, *decompressed = NULL;
+                size_t compressed_len = 0, decompressed_len = 0;
+                uint64_t start = Timer_ns();
+
+                FILE *in = fmemopen((void *)ppm, len, "r");
+                FILE *out = open_memstream(&compressed, &compressed_len);
+                assert(in != NULL && out != NULL);
+                compress40_to(in, out);
+                fclose(in);
+                fclose(out);
+
+                in = fmemopen(compressed, compressed_len, "r");
+                out = open_memstream(&decompressed, &decompressed_len);
+                assert(in != NULL && out != NULL);
+                decompress40_to(in, out);
+                fclose(in);
+                fclose(out);
+
+                uint64_t elapsed = Timer_ns() - start;
+                best = elapsed < best ? elapsed : best;
+                free(compressed);       /* allocated by open_memstream */
+                free(decompressed);
+        }
+        return best;
+}
+
+/********** try_candidate ********
+ *
+ * Times one candidate and keeps it in *best if it is the fastest yet.
+ *
+ * Parameters:
+ *      Tuning candidate:       The setting to try.
+ *      const char *ppm:        The image as PPM bytes.
+ *      size_t len:             The number of bytes in ppm.
+ *      Tuning *best:           The fastest setting so far.
+ *      uint64_t *best_ns:      Its time.
+ *      FILE *log:              Where to report the time, or NULL.
+ ************************/
+static void try_candidate(Tuning candidate, const char *ppm, size_t len,
+                          Tuning *best, uint64_t *best_ns, FILE *log)
+{
+        Tuning_current = candidate;
+        uint64_t ns = time_codec(ppm, len);
+        if (log != NULL)
+        {
+                fprintf(log, "threads %3d  strip_cols %5u  %9.3f ms\n",
+                        candidate.threads, candidate.strip_cols, ns / 1e6);
+        }
+        if (ns < *best_ns)
+        {
+                *best = candidate;
+                *best_ns = ns;
+        }
+}
+
+/********** image_height ********
+ *
+ * Reads the height from a PPM header, skipping comments.
+ *
+ * Return:
+ *      unsigned:       The height, or 0 if the header cannot be read.
+ ************************/
+static unsigned image_height(const char *ppm, size_t len)
+{
+        unsigned fields[3], got = 0;
+        size_t i = 2;
+
+        if (len < 2 || ppm[0] != 'P')
+        {
+                return 0;
+        }
+        while (got < 3 && i < len)
+        {
+                if (ppm[i] == '#')
+                {
+                        while (i < len && ppm[i] != '\n')
+                        {
+                                i++;
+                        }
+                }
+                else if (ppm[i] >= '0' && ppm[i] <= '9')
+                {
+                        fields[got] = 0;
+                        while (i < len && ppm[i] >= '0' && ppm[i] <= '9')
+                        {
+                                fields[got] = fields[got] * 10 + (ppm[i] - '0');
+                                i++;
+                        }
+                        got++;
+                }
+                else
+                {
+                        i++;
+                }
+        }
+        return got >= 2 ? fields[1] : 0;
+}
+
+/********** Tuning_autotune ********
+ *
+ * Times compress40 and decompress40 with each candidate setting and
+ * leaves the fastest in Tuning_current.
+ *
+ * Parameters:
+ *      const char *ppm:                A PPM image to calibrate on, or
+ *                                      NULL for a built-in synthetic one.
+ *      size_t len:                     The number of bytes in ppm.
+ *      const Cache_topology *topology: The topology to choose candidates
+ *                                      for.
+ *      FILE *log:                      Where to report each candidate's
+ *                                      time, or NULL.
+ *
+ * Expects:
+ *      topology must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Threads are tuned first, with the strip width the L2 cache
+ *      suggests, then the strip width with the fastest thread count.
+ ************************/
+void Tuning_autotune(const char *ppm, size_t len,
+                     const Cache_topology *topology, FILE *log)
+{
+        assert(topology != NULL);
+
+        char *synthetic = NULL;
+        if (ppm == NULL)
+        {
+                synthetic = Ppmsynth_image(PPMSYNTH_FRACTAL,
+                                           SYNTHETIC_SIZE,
+                                           SYNTHETIC_SIZE, 255, 0, &len);
+                ppm = synthetic;
+        }
+        int stats = Stats_enabled;
+        Stats_enabled = 0;
+
+        /* The widest strip whose columns fit in L2, at least one column */
+        unsigned height = image_height(ppm, len);
+        size_t l2 = topology->l2 > 0 ? topology->l2 : 256 << 10;
+        unsigned fit = height > 0 ? l2 / (24 * (size_t)height) : 8;
+        fit = fit < 1 ? 1 : (fit > MAX_STRIP_COLS ? MAX_STRIP_COLS : fit);
+
+        Tuning best = { 1, fit };
+        uint64_t best_ns = UINT64_MAX;
+
+        int cpus = topology->cpus > MAX_THREADS ? MAX_THREADS
+                                                : topology->cpus;
+        /* Candidates are in increasing order; skip repeats */
+        int threads[] = { 1, 2, cpus / 2, cpus }, last_threads = 0;
+        for (size_t i = 0; i < sizeof threads / sizeof threads[0]; i++)
+        {
+                if (threads[i] <= last_threads || threads[i] > cpus)
+                {
+                        continue;
+                }
+                Tuning candidate = { threads[i], fit };
+                try_candidate(candidate, ppm, len, &best, &best_ns, log);
+                last_threads = threads[i];
+        }
+
+        unsigned widths[] = { 1, fit / 4, fit / 2, fit * 2 }, last_width = 0;
+        int chosen = best.threads;
+        for (size_t i = 0; i < sizeof widths / sizeof widths[0]; i++)
+        {
+                if (widths[i] <= last_width || widths[i] == fit ||
+                    widths[i] > MAX_STRIP_COLS)
+                {
+                        continue;
+                }
+                Tuning candidate = { chosen, widths[i] };
+                try_candidate(candidate, ppm, len, &best, &best_ns, log);
+                last_width = widths[i];
+        }
+
+        Tuning_current = best;
+        Stats_enabled = stats;
+        FREE(synthetic);
+}
@@ -0,0 +1,161 @@
+/**************************************************************
+ *
+ *                     tuning.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for the codec's tuning parameters:
+ *     how many threads compress40 and decompress40 use, and how many
+ *     columns of blocks each thread codes at a time (a strip). The
+ *     auto-tuner reads the cache topology from sysfs, times the codec
+ *     with a few candidate settings chosen from it, and saves the fastest
+ *     in a config file that later runs load.
+ *
+ *     The config file is $COMP40_TUNING if that is set, and otherwise
+ *     .comp40tune in the home directory. It holds "key value" lines;
+ *     unknown keys and lines starting with # are ignored.
+ *
+ ************************/
+
+#ifndef TUNING_H
+#define TUNING_H
+
+#include <stddef.h>
+#include <stdio.h>
+
+/********** Tuning ********
+ *
+ * The codec's tuning parameters.
+ *
+ * Elements:
+ *      int threads:            Threads to code with; 1 codes on the
+ *                              calling thread alone.
+ *      unsigned strip_cols:    Columns of blocks per strip.
+ ************************/
+typedef struct Tuning
+{
+        int threads;
+        unsigned strip_cols;
+} Tuning;
+
+/* The parameters the codec uses; one thread and one column per strip
+ * unless a config file is loaded or the tuner is run */
+extern Tuning Tuning_current;
+
+/********** Cache_topology ********
+ *
+ * The caches of the first CPU, as sysfs describes them.
+ *
+ * Elements:
+ *      size_t line:    The cache line size in bytes.
+ *      size_t l1d:     The level 1 data cache size in bytes.
+ *      size_t l2:      The level 2 cache size in bytes.
+ *      size_t llc:     The last-level cache size in bytes.
+ *      int cpus:       The number of CPUs this process may run on.
+ *
+ * Notes:
+ *      Sizes sysfs does not give are 0.
+ ************************/
+typedef struct Cache_topology
+{
+        size_t line;
+        size_t l1d;
+        size_t l2;
+        size_t llc;
+        int cpus;
+} Cache_topology;
+
+/********** Tuning_topology ********
+ *
+ * Reads the cache topology.
+ *
+ * Parameters:
+ *      Cache_topology *topology:  Where to store it.
+ *
+ * Expects:
+ *      topology must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void Tuning_topology(Cache_topology *topology);
+
+/********** Tuning_path ********
+ *
+ * Gets the path of the config file.
+ *
+ * Return:
+ *      const char *:   The path, or NULL if there is none (no
+ *                      COMP40_TUNING and no HOME).
+ ************************/
+const char *Tuning_path(void);
+
+/********** Tuning_load ********
+ *
+ * Reads tuning parameters from a config file into Tuning_current.
+ *
+ * Parameters:
+ *      const char *path:   The file to read.
+ *
+ * Return:
+ *      int:                1 if the file was read, 0 if it could not be
+ *                          opened.
+ *
+ * Expects:
+ *      path must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Values that are missing or out of range are left as they were.
+ ************************/
+int Tuning_load(const char *path);
+
+/********** Tuning_save ********
+ *
+ * Writes Tuning_current, and the topology it was tuned for, to a config
+ * file.
+ *
+ * Parameters:
+ *      const char *path:               The file to write.
+ *      const Cache_topology *topology: The topology, recorded for
+ *                                      reference.
+ *
+ * Return:
+ *      int:                            1 if the file was written, else 0.
+ *
+ * Expects:
+ *      path and topology must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+int Tuning_save(const char *path, const Cache_topology *topology);
+
+/********** Tuning_autotune ********
+ *
+ * Times compress40 and decompress40 with each candidate setting and
+ * leaves the fastest in Tuning_current.
+ *
+ * Parameters:
+ *      const char *ppm:                A PPM image to calibrate on, or
+ *                                      NULL for a built-in synthetic one.
+ *      size_t len:                     The number of bytes in ppm.
+ *      const Cache_topology *topology: The topology to choose candidates
+ *                                      for.
+ *      FILE *log:                      Where to report each candidate's
+ *                                      time, or NULL.
+ *
+ * Expects:
+ *      topology must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Threads are tuned first, with the strip width the L2 cache
+ *      suggests, then the strip width with the fastest thread count.
+ ************************/
+void Tuning_autotune(const char *ppm, size_t len,
+                     const Cache_topology *topology, FILE *log);
+
+#endif
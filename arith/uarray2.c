@@ -13,27 +13,42 @@
 
 #include "uarray2.h"
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
-#include <uarray.h>
+#include <sys/mman.h>
+#include <mem.h>
+
+/* Arrays of at least this many bytes are mapped rather than allocated */
+#define MAP_BYTES ((size_t)1 << 26)
+
+void (*UArray2_mapped)(void *elems, size_t bytes, const char *file,
+                       int line) = NULL;
 
 /********** UArray2_T ********
  *
  * This structure represents a 2D unboxed array.
- * It uses a 1D unboxed array (UArray_T) to store the elements.
+ * Its elements are stored a row at a time in one buffer, which is indexed
+ * with 64-bit arithmetic, so an array may have more than 2^31 elements
+ * even though each dimension fits in an int.
  *
  * Elements:
  *      int width:           The width of the 2D unboxed array.
  *      int height:          The height of the 2D unboxed array.
- *      UArray2_T array:     The underlying 1D unboxed array that stores the
- *                           elements.
+ *      int size:            The size of an element in bytes.
+ *      size_t bytes:        The size of the buffer.
+ *      int mapped:          1 if the buffer was mapped with mmap.
+ *      char *elems:         The buffer, or NULL if it would be empty.
  ************************/
 struct UArray2_T 
 {
         int width;
         int height;
-        UArray_T array;
+        int size;
+        size_t bytes;
+        int mapped;
+        char *elems;
 };
 
 /********** UArray2_new ********
@@ -50,20 +65,50 @@ struct UArray2_T
  *      A new 2D unboxed array.
  *
  * Expects:
- *      width, hieght size >= 0.
+ *      width, height >= 0, size > 0, and the array must fit in memory's
+ *      address space.
  *
  * Notes:
  *      Will CRE if memory allocation fails.
  *      Will CRE if any expectation is violated.
  *      Client is expected to free the array using the UArray2_free method.
+ *      Arrays of MAP_BYTES or more are mapped without reserving swap, so
+ *      the kernel backs a page with memory only when it is first touched
+ *      and untouched elements read as zero. Their buffers bypass Mem, so
+ *      they are reported to UArray2_mapped instead.
  ************************/
 UArray2_T UArray2_new(int width, int height, int size)
 {
+        assert(width >= 0 && height >= 0 && size > 0);
+        assert(height == 0 ||
+               (size_t)width <= SIZE_MAX / (size_t)height / (size_t)size);
+
         UArray2_T uarray2 = malloc(sizeof(*uarray2));
         assert(uarray2 != NULL);
         uarray2->width = width;
         uarray2->height = height;
-        uarray2->array = UArray_new(width * height, size);
+        uarray2->size = size;
+        uarray2->bytes = (size_t)width * height * size;
+        uarray2->mapped = uarray2->bytes >= MAP_BYTES;
+        uarray2->elems = NULL;
+        if (uarray2->mapped)
+        {
+                void *elems = mmap(NULL, uarray2->bytes,
+                                   PROT_READ | PROT_WRITE,
+                                   MAP_PRIVATE | MAP_ANONYMOUS |
+                                   MAP_NORESERVE, -1, 0);
+                assert(elems != MAP_FAILED);
+                uarray2->elems = elems;
+                if (UArray2_mapped != NULL)
+                {
+                        UArray2_mapped(elems, uarray2->bytes, __FILE__,
+                                       __LINE__);
+                }
+        }
+        else if (uarray2->bytes > 0)
+        {
+                uarray2->elems = CALLOC(uarray2->bytes, 1);
+        }
         return uarray2;
 }
 
@@ -88,7 +133,19 @@ UArray2_T UArray2_new(int width, int height, int size)
 void UArray2_free(UArray2_T *uarray2)
 {
         assert((uarray2 != NULL) && (*uarray2 != NULL));
-        UArray_free(&((*uarray2)->array));
+        if ((*uarray2)->mapped)
+        {
+                if (UArray2_mapped != NULL)
+                {
+                        UArray2_mapped((*uarray2)->elems, 0, __FILE__,
+                                       __LINE__);
+                }
+                munmap((*uarray2)->elems, (*uarray2)->bytes);
+        }
+        else
+        {
+                FREE((*uarray2)->elems);
+        }
         free(*uarray2);
         *uarray2 = NULL;
 }
@@ -119,7 +176,41 @@ void *UArray2_at(UArray2_T uarray2, int col, int row)
         assert(uarray2 != NULL);
         assert(col >= 0 && col < uarray2->width);
         assert(row >= 0 && row < uarray2->height);
-        return UArray_at(uarray2->array, col + (row * uarray2->width));
+        return uarray2->elems +
+               ((size_t)row * uarray2->width + col) * uarray2->size;
+}
+
+/********** UArray2_row ********
+ *
+ * Gets a row of elements, which are stored one after another.
+ *
+ * Parameters:
+ *      UArray2_T uarray2:      The 2D unboxed array.
+ *      int row:                The row.
+ *
+ * Return:
+ *      A pointer to the row's first element; the element in column col
+ *      is col * UArray2_size bytes past it. NULL if the array has no
+ *      columns.
+ *
+ * Expects:
+ *      uarray2 must not be NULL, and 0 <= row < height.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Rows are stored one after another too, so row + 1 begins
+ *      width * UArray2_size bytes after row.
+ ************************/
+void *UArray2_row(UArray2_T uarray2, int row)
+{
+        assert(uarray2 != NULL);
+        assert(row >= 0 && row < uarray2->height);
+        if (uarray2->width == 0)
+        {
+                return NULL;
+        }
+        return uarray2->elems +
+               (size_t)row * uarray2->width * uarray2->size;
 }
 
 /********** UArray2_width ********
@@ -185,7 +276,7 @@ int UArray2_height(UArray2_T uarray2)
 int UArray2_size(UArray2_T uarray2)
 {
         assert(uarray2 != NULL);
-        return UArray_size(uarray2->array);
+        return uarray2->size;
 }
 
 /********** UArray2_map_row_major ********
@@ -211,6 +302,8 @@ int UArray2_size(UArray2_T uarray2)
  *      Will CRE if any expectation is violated.
  *      The closure pointer (cl) can be used to pass extra data
  *      to the apply function.
+ *      Each row is stepped through with a pointer from UArray2_row, so
+ *      elements are not checked one at a time.
  ************************/
 void UArray2_map_row_major(UArray2_T uarray2,
                            void apply(int col,
@@ -224,10 +317,12 @@ void UArray2_map_row_major(UArray2_T uarray2,
         assert(apply != NULL);
         int height = uarray2->height;
         int width = uarray2->width;
-        for (int row = 0; row < height; row++) {
+        int size = UArray2_size(uarray2);
+        for (int row = 0; row < height && width > 0; row++) {
+                char *elem = UArray2_row(uarray2, row);
                 for (int col = 0; col < width; col++) {
-                        void *elem = UArray2_at(uarray2, col, row);
                         apply(col, row, uarray2, elem, cl);
+                        elem += size;
                 }
         }
 }
@@ -275,4 +370,37 @@ void UArray2_map_col_major(UArray2_T uarray2,
                         apply(col, row, uarray2, elem, cl);
                 }
         }
-}
\ No newline at end of file
+}
+
+/********** UArray2_map_2x2 ********
+ *
+ * Applies a function to each 2x2 block of elements, in row-major order of
+ * blocks.
+ *
+ * Parameters:
+ *      UArray2_T uarray2:              The array to be mapped.
+ *      UArray2_apply2x2fun apply:      Function to be applied to each
+ *                                      block, given the block's column and
+ *                                      row (in blocks) and its four
+ *                                      elements: top-left, top-right,
+ *                                      bottom-left, bottom-right.
+ *      void *cl:                       Closure pointer.
+ *
+ * Expects:
+ *      uarray2 and apply must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      An odd last column or row is not visited.
+ ************************/
+void UArray2_map_2x2(UArray2_T uarray2, UArray2_apply2x2fun apply, void *cl)
+{
+        assert(uarray2 != NULL);
+        assert(apply != NULL);
+        UArray2_2x2 it = UArray2_2x2_start(uarray2);
+        void *elems[4];
+        while (UArray2_2x2_next(&it, elems))
+        {
+                apply(it.col, it.row, uarray2, elems, cl);
+        }
+}
@@ -0,0 +1,269 @@
+/**************************************************************
+ *
+ *                     uarray2.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for a 2D unboxed array, stored a
+ *     row at a time in one buffer. Each dimension fits in an int, but
+ *     elements are indexed with 64-bit arithmetic, so an array may hold
+ *     more than 2^31 elements. Besides access to single elements, it hands
+ *     out whole rows, so that loops over a row can step through plain
+ *     pointers instead of calling UArray2_at for every element.
+ *
+ ************************/
+
+#ifndef UARRAY2_INCLUDED
+#define UARRAY2_INCLUDED
+
+#include <stddef.h>
+
+#define T UArray2_T
+typedef struct T *T;
+
+typedef void UArray2_applyfun(int col, int row, T array2, void *elem,
+                              void *cl);
+typedef void UArray2_apply2x2fun(int col, int row, T array2, void *elems[4],
+                                 void *cl);
+
+/********** UArray2_mapped ********
+ *
+ * Called, if not NULL, whenever a large array's buffer is mapped or
+ * unmapped, since such buffers do not come from Mem_alloc.
+ *
+ * Parameters:
+ *      void *elems:            The buffer.
+ *      size_t bytes:           Its size when it was just mapped, or 0 when
+ *                              it is about to be unmapped.
+ *      const char *file:       The file, as given by __FILE__.
+ *      int line:               The line.
+ *
+ * Notes:
+ *      NULL unless a client sets it; the accounting allocator (memacct.c)
+ *      does, so that large images count toward its live and peak bytes.
+ ************************/
+extern void (*UArray2_mapped)(void *elems, size_t bytes, const char *file,
+                              int line);
+
+/********** UArray2_new ********
+ *
+ * Creates a new 2D unboxed array.
+ *
+ * Parameters:
+ *      int width:      Number of columns in the array.
+ *      int height:     Number of rows in the array.
+ *      int size:       Size (in bytes) of each element.
+ *
+ * Return:
+ *      A new 2D unboxed array, with every element zeroed.
+ *
+ * Expects:
+ *      width, height >= 0, size > 0, and the array must fit in memory's
+ *      address space.
+ *
+ * Notes:
+ *      Will CRE if memory allocation fails.
+ *      Will CRE if any expectation is violated.
+ *      Client is expected to free the array using UArray2_free.
+ *      Large arrays are mapped lazily: memory is committed a page at a
+ *      time as elements are first touched. They are reported to
+ *      UArray2_mapped rather than allocated with CALLOC.
+ ************************/
+extern T UArray2_new(int width, int height, int size);
+
+/********** UArray2_free ********
+ *
+ * Frees a 2D unboxed array and sets the caller's handle to NULL.
+ *
+ * Expects:
+ *      uarray2 and *uarray2 must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+extern void UArray2_free(T *uarray2);
+
+/********** UArray2_at ********
+ *
+ * Gets the element at a column and row.
+ *
+ * Expects:
+ *      uarray2 must not be NULL.
+ *      0 <= col < width and 0 <= row < height.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+extern void *UArray2_at(T uarray2, int col, int row);
+
+/********** UArray2_row ********
+ *
+ * Gets a row of elements, which are stored one after another.
+ *
+ * Parameters:
+ *      T uarray2:      The array.
+ *      int row:        The row.
+ *
+ * Return:
+ *      A pointer to the row's first element; the element in column col
+ *      is col * UArray2_size bytes past it. NULL if the array has no
+ *      columns.
+ *
+ * Expects:
+ *      uarray2 must not be NULL, and 0 <= row < height.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Rows are stored one after another too, so row + 1 begins
+ *      width * UArray2_size bytes after row.
+ ************************/
+extern void *UArray2_row(T uarray2, int row);
+
+/********** UArray2_width, UArray2_height, UArray2_size ********
+ *
+ * Get the number of columns, the number of rows and the size of an
+ * element in bytes.
+ *
+ * Expects:
+ *      uarray2 must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+extern int UArray2_width(T uarray2);
+extern int UArray2_height(T uarray2);
+extern int UArray2_size(T uarray2);
+
+/********** UArray2_map_row_major, UArray2_map_col_major ********
+ *
+ * Apply a function to each element, by row then column or by column then
+ * row.
+ *
+ * Expects:
+ *      uarray2 and apply must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+extern void UArray2_map_row_major(T uarray2, UArray2_applyfun apply,
+                                  void *cl);
+extern void UArray2_map_col_major(T uarray2, UArray2_applyfun apply,
+                                  void *cl);
+
+/********** UArray2_map_2x2 ********
+ *
+ * Applies a function to each 2x2 block of elements, in row-major order of
+ * blocks.
+ *
+ * Parameters:
+ *      T uarray2:                      The array to be mapped.
+ *      UArray2_apply2x2fun apply:      Function to be applied to each
+ *                                      block, given the block's column and
+ *                                      row (in blocks) and its four
+ *                                      elements: top-left, top-right,
+ *                                      bottom-left, bottom-right.
+ *      void *cl:                       Closure pointer.
+ *
+ * Expects:
+ *      uarray2 and apply must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      An odd last column or row is not visited.
+ *      Loops that can be inlined should use UArray2_2x2_next instead,
+ *      which makes no call per block.
+ ************************/
+extern void UArray2_map_2x2(T uarray2, UArray2_apply2x2fun apply, void *cl);
+
+/********** UArray2_2x2 ********
+ *
+ * An iteration over the 2x2 blocks of an array in the order
+ * UArray2_map_2x2 visits them, for loops that want the apply function
+ * inlined.
+ *
+ * Elements:
+ *      int col, row:           The block last returned, in blocks.
+ *      int cols, rows:         The number of whole blocks across and down.
+ *      size_t size:            The size of an element in bytes.
+ *      char *top, *bottom:     The rows of the current row of blocks.
+ *      T uarray2:              The array.
+ *
+ * Notes:
+ *      Set up with UArray2_2x2_start, then call UArray2_2x2_next until it
+ *      returns 0:
+ *
+ *              UArray2_2x2 it = UArray2_2x2_start(array);
+ *              void *elems[4];
+ *              while (UArray2_2x2_next(&it, elems)) { ... }
+ ************************/
+typedef struct UArray2_2x2
+{
+        int col, row;
+        int cols, rows;
+        size_t size;
+        char *top, *bottom;
+        T uarray2;
+} UArray2_2x2;
+
+/********** UArray2_2x2_start ********
+ *
+ * Starts an iteration over the 2x2 blocks of an array.
+ *
+ * Expects:
+ *      uarray2 must not be NULL, and must outlive the iteration.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+static inline UArray2_2x2 UArray2_2x2_start(T uarray2)
+{
+        UArray2_2x2 it = {0, -1, UArray2_width(uarray2) / 2,
+                          UArray2_height(uarray2) / 2,
+                          UArray2_size(uarray2), NULL, NULL, uarray2};
+        it.col = it.cols;
+        return it;
+}
+
+/********** UArray2_2x2_next ********
+ *
+ * Moves an iteration to the next 2x2 block.
+ *
+ * Parameters:
+ *      UArray2_2x2 *it:        The iteration.
+ *      void *elems[4]:         Where to store the block's elements:
+ *                              top-left, top-right, bottom-left,
+ *                              bottom-right.
+ *
+ * Return:
+ *      int:                    1 if elems holds the block at it->col,
+ *                              it->row, or 0 if every block has been
+ *                              visited.
+ *
+ * Notes:
+ *      Calls UArray2_row twice per row of blocks and nothing per block.
+ ************************/
+static inline int UArray2_2x2_next(UArray2_2x2 *it, void *elems[4])
+{
+        if (++it->col >= it->cols)
+        {
+                if (it->cols == 0 || ++it->row >= it->rows)
+                {
+                        it->row = it->rows;
+                        return 0;
+                }
+                it->col = 0;
+                it->top = UArray2_row(it->uarray2, 2 * it->row);
+                it->bottom = UArray2_row(it->uarray2, 2 * it->row + 1);
+        }
+        size_t offset = 2 * (size_t)it->col * it->size;
+        elems[0] = it->top + offset;
+        elems[1] = it->top + offset + it->size;
+        elems[2] = it->bottom + offset;
+        elems[3] = it->bottom + offset + it->size;
+        return 1;
+}
+
+#undef T
+#endif
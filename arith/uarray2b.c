@@ -0,0 +1,265 @@
+/**************************************************************
+ *
+ *                     uarray2b.c
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the implementation for a blocked 2D unboxed
+ *     array as declared in uarray2b.h. Every tile is a fixed-size slot in
+ *     one aligned buffer, so finding a cell is arithmetic on its column
+ *     and row, with no per-tile allocation or indirection.
+ *
+ ************************/
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "assert.h"
+#include "mem.h"
+#include "uarray2b.h"
+
+/********** UArray2b_T ********
+ *
+ * This structure represents a blocked 2D unboxed array.
+ *
+ * Elements:
+ *      int width, height:      The dimensions in cells.
+ *      int size:               The size of an element in bytes.
+ *      int blocksize:          The number of cells on one side of a tile.
+ *      size_t tiles_wide:      The number of tiles in a row of tiles.
+ *      size_t pitch:           The bytes from one tile to the next.
+ *      char *raw:              The buffer as allocated.
+ *      char *elems:            The first tile, aligned within raw.
+ ************************/
+struct UArray2b_T
+{
+        int width, height;
+        int size;
+        int blocksize;
+        size_t tiles_wide;
+        size_t pitch;
+        char *raw;
+        char *elems;
+};
+
+/********** UArray2b_new ********
+ *
+ * Creates a new blocked 2D unboxed array.
+ *
+ * Parameters:
+ *      int width:      Number of columns in the array.
+ *      int height:     Number of rows in the array.
+ *      int size:       Size (in bytes) of each element.
+ *      int blocksize:  Number of cells on one side of a tile.
+ *
+ * Return:
+ *      A new blocked 2D unboxed array, with every element zeroed.
+ *
+ * Expects:
+ *      width, height >= 0, and size, blocksize >= 1.
+ *
+ * Notes:
+ *      Will CRE if memory allocation fails.
+ *      Will CRE if any expectation is violated.
+ *      Client is expected to free the array using UArray2b_free.
+ *      Tiles of at most UARRAY2B_ALIGN bytes are padded to a power of two,
+ *      so no tile crosses a cache line; larger tiles are padded to a
+ *      multiple of UARRAY2B_ALIGN.
+ ************************/
+UArray2b_T UArray2b_new(int width, int height, int size, int blocksize)
+{
+        assert(width >= 0 && height >= 0);
+        assert(size >= 1 && blocksize >= 1);
+
+        UArray2b_T array2b;
+        NEW(array2b);
+        array2b->width = width;
+        array2b->height = height;
+        array2b->size = size;
+        array2b->blocksize = blocksize;
+        array2b->tiles_wide = ((size_t)width + blocksize - 1) / blocksize;
+
+        size_t tile = (size_t)blocksize * blocksize * size;
+        size_t pitch = 1;
+        if (tile <= UARRAY2B_ALIGN)
+        {
+                while (pitch < tile)
+                {
+                        pitch *= 2;
+                }
+        }
+        else
+        {
+                pitch = (tile + UARRAY2B_ALIGN - 1) &
+                        ~(size_t)(UARRAY2B_ALIGN - 1);
+        }
+        array2b->pitch = pitch;
+
+        size_t tiles_high = ((size_t)height + blocksize - 1) / blocksize;
+        size_t bytes = array2b->tiles_wide * tiles_high * pitch;
+        array2b->raw = ALLOC(bytes + UARRAY2B_ALIGN);
+        array2b->elems = (char *)(((uintptr_t)array2b->raw +
+                                   UARRAY2B_ALIGN - 1) &
+                                  ~(uintptr_t)(UARRAY2B_ALIGN - 1));
+        memset(array2b->elems, 0, bytes);
+        return array2b;
+}
+
+/********** UArray2b_new_64K_block ********
+ *
+ * Creates a new blocked 2D unboxed array whose tiles hold as close to 64KB
+ * as a square tile can.
+ *
+ * Parameters:
+ *      int width:      Number of columns in the array.
+ *      int height:     Number of rows in the array.
+ *      int size:       Size (in bytes) of each element.
+ *
+ * Return:
+ *      A new blocked 2D unboxed array, with every element zeroed.
+ *
+ * Expects:
+ *      width, height >= 0, and size >= 1.
+ *
+ * Notes:
+ *      Will CRE if memory allocation fails.
+ *      Will CRE if any expectation is violated.
+ *      Elements bigger than 64KB get a blocksize of 1.
+ ************************/
+UArray2b_T UArray2b_new_64K_block(int width, int height, int size)
+{
+        assert(size >= 1);
+        int blocksize = (int)sqrt(65536.0 / size);
+        return UArray2b_new(width, height, size,
+                            blocksize > 1 ? blocksize : 1);
+}
+
+/********** UArray2b_free ********
+ *
+ * Frees a blocked 2D unboxed array and sets the caller's handle to NULL.
+ *
+ * Parameters:
+ *      UArray2b_T *array2b:    Pointer to the array to be freed.
+ *
+ * Expects:
+ *      array2b and *array2b must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void UArray2b_free(UArray2b_T *array2b)
+{
+        assert(array2b != NULL && *array2b != NULL);
+        FREE((*array2b)->raw);
+        FREE(*array2b);
+}
+
+int UArray2b_width(UArray2b_T array2b)
+{
+        assert(array2b != NULL);
+        return array2b->width;
+}
+
+int UArray2b_height(UArray2b_T array2b)
+{
+        assert(array2b != NULL);
+        return array2b->height;
+}
+
+int UArray2b_size(UArray2b_T array2b)
+{
+        assert(array2b != NULL);
+        return array2b->size;
+}
+
+int UArray2b_blocksize(UArray2b_T array2b)
+{
+        assert(array2b != NULL);
+        return array2b->blocksize;
+}
+
+/********** UArray2b_at ********
+ *
+ * Gets the element at a column and row.
+ *
+ * Parameters:
+ *      UArray2b_T array2b:     The array.
+ *      int col:                Column index of the element.
+ *      int row:                Row index of the element.
+ *
+ * Return:
+ *      A void pointer to the element.
+ *
+ * Expects:
+ *      array2b must not be NULL.
+ *      0 <= col < width and 0 <= row < height.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+void *UArray2b_at(UArray2b_T array2b, int col, int row)
+{
+        assert(array2b != NULL);
+        assert(col >= 0 && col < array2b->width);
+        assert(row >= 0 && row < array2b->height);
+
+        int blocksize = array2b->blocksize;
+        size_t tile = (size_t)(row / blocksize) * array2b->tiles_wide +
+                      col / blocksize;
+        size_t cell = (size_t)(row % blocksize) * blocksize +
+                      col % blocksize;
+        return array2b->elems + tile * array2b->pitch +
+               cell * array2b->size;
+}
+
+/********** UArray2b_map ********
+ *
+ * Applies a function to each element in block-major order: tile by tile
+ * in row-major order of tiles, and row by row within a tile.
+ *
+ * Parameters:
+ *      UArray2b_T array2b:             The array to be mapped.
+ *      UArray2b_applyfun apply:        Function to be applied to each
+ *                                      element.
+ *      void *cl:                       Closure pointer.
+ *
+ * Expects:
+ *      array2b and apply must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Cells of edge tiles that lie outside the array are not visited.
+ *      Elements are visited in the order they are stored.
+ ************************/
+void UArray2b_map(UArray2b_T array2b, UArray2b_applyfun apply, void *cl)
+{
+        assert(array2b != NULL);
+        assert(apply != NULL);
+        int blocksize = array2b->blocksize;
+        char *tile = array2b->elems;
+
+        for (int top = 0; top < array2b->height; top += blocksize)
+        {
+                for (int left = 0; left < array2b->width; left += blocksize)
+                {
+                        for (int r = 0; r < blocksize &&
+                                        top + r < array2b->height; r++)
+                        {
+                                char *elem = tile + (size_t)r * blocksize *
+                                                            array2b->size;
+                                for (int c = 0; c < blocksize &&
+                                                left + c < array2b->width;
+                                     c++)
+                                {
+                                        apply(left + c, top + r, array2b,
+                                              elem, cl);
+                                        elem += array2b->size;
+                                }
+                        }
+                        tile += array2b->pitch;
+                }
+        }
+}
@@ -0,0 +1,153 @@
+/**************************************************************
+ *
+ *                     uarray2b.h
+ *
+ *     Assignment: arith
+ *     Authors:    Robert Stark (rstark03), Kyle Wigdor (kwigdo01)
+ *     Date:       10/19/2026
+ *
+ *     This file contains the interface for a blocked 2D unboxed array.
+ *     The array is cut into blocksize x blocksize tiles, and the cells of
+ *     each tile are stored together, a row of the tile at a time, so that
+ *     cells near each other in either direction are near each other in
+ *     memory. Tiles are stored in row-major order.
+ *
+ ************************/
+
+#ifndef UARRAY2B_H
+#define UARRAY2B_H
+
+#define T UArray2b_T
+typedef struct T *T;
+
+/* Every tile starts on a boundary of this many bytes */
+#define UARRAY2B_ALIGN 64
+
+typedef void UArray2b_applyfun(int col, int row, T array2b, void *elem,
+                               void *cl);
+
+/********** UArray2b_new ********
+ *
+ * Creates a new blocked 2D unboxed array.
+ *
+ * Parameters:
+ *      int width:      Number of columns in the array.
+ *      int height:     Number of rows in the array.
+ *      int size:       Size (in bytes) of each element.
+ *      int blocksize:  Number of cells on one side of a tile.
+ *
+ * Return:
+ *      A new blocked 2D unboxed array, with every element zeroed.
+ *
+ * Expects:
+ *      width, height >= 0, and size, blocksize >= 1.
+ *
+ * Notes:
+ *      Will CRE if memory allocation fails.
+ *      Will CRE if any expectation is violated.
+ *      Client is expected to free the array using UArray2b_free.
+ *      Tiles of at most UARRAY2B_ALIGN bytes are padded to a power of two,
+ *      so no tile crosses a cache line; larger tiles are padded to a
+ *      multiple of UARRAY2B_ALIGN.
+ ************************/
+extern T UArray2b_new(int width, int height, int size, int blocksize);
+
+/********** UArray2b_new_64K_block ********
+ *
+ * Creates a new blocked 2D unboxed array whose tiles hold as close to 64KB
+ * as a square tile can.
+ *
+ * Parameters:
+ *      int width:      Number of columns in the array.
+ *      int height:     Number of rows in the array.
+ *      int size:       Size (in bytes) of each element.
+ *
+ * Return:
+ *      A new blocked 2D unboxed array, with every element zeroed.
+ *
+ * Expects:
+ *      width, height >= 0, and size >= 1.
+ *
+ * Notes:
+ *      Will CRE if memory allocation fails.
+ *      Will CRE if any expectation is violated.
+ *      Elements bigger than 64KB get a blocksize of 1.
+ ************************/
+extern T UArray2b_new_64K_block(int width, int height, int size);
+
+/********** UArray2b_free ********
+ *
+ * Frees a blocked 2D unboxed array and sets the caller's handle to NULL.
+ *
+ * Parameters:
+ *      T *array2b:     Pointer to the array to be freed.
+ *
+ * Expects:
+ *      array2b and *array2b must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+extern void UArray2b_free(T *array2b);
+
+/********** UArray2b_width, UArray2b_height, UArray2b_size,
+ *           UArray2b_blocksize ********
+ *
+ * Get the number of columns, the number of rows, the size of an element
+ * in bytes and the number of cells on one side of a tile.
+ *
+ * Expects:
+ *      array2b must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+extern int UArray2b_width(T array2b);
+extern int UArray2b_height(T array2b);
+extern int UArray2b_size(T array2b);
+extern int UArray2b_blocksize(T array2b);
+
+/********** UArray2b_at ********
+ *
+ * Gets the element at a column and row.
+ *
+ * Parameters:
+ *      T array2b:      The array.
+ *      int col:        Column index of the element.
+ *      int row:        Row index of the element.
+ *
+ * Return:
+ *      A void pointer to the element.
+ *
+ * Expects:
+ *      array2b must not be NULL.
+ *      0 <= col < width and 0 <= row < height.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ ************************/
+extern void *UArray2b_at(T array2b, int col, int row);
+
+/********** UArray2b_map ********
+ *
+ * Applies a function to each element in block-major order: tile by tile
+ * in row-major order of tiles, and row by row within a tile.
+ *
+ * Parameters:
+ *      T array2b:                      The array to be mapped.
+ *      UArray2b_applyfun apply:        Function to be applied to each
+ *                                      element.
+ *      void *cl:                       Closure pointer.
+ *
+ * Expects:
+ *      array2b and apply must not be NULL.
+ *
+ * Notes:
+ *      Will CRE if any expectation is violated.
+ *      Cells of edge tiles that lie outside the array are not visited.
+ *      Elements are visited in the order they are stored.
+ ************************/
+extern void UArray2b_map(T array2b, UArray2b_applyfun apply, void *cl);
+
+#undef T
+#endif
@@ -5,16 +5,36 @@
 #include <math.h>
 #include <stdbool.h>
 #include <limits.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include "assert.h"
 #include "pnm.h"
 #include "a2methods.h"
 #include "a2plain.h"
-#include "rgb2cv.h"
+#include "a2blocked.h"
+#include "uarray2b.h"
+#include "a2row.h"
+#include "uarray2.h"
+#include "a2parallel.h"
+#include "rgb2cav.h"
 #include "dct.h"
 #include "stdlib.h"
 #include "mem.h"
 #include "bitpack.h"
+#include "codec40.h"
+#include "compress40_io.h"
+#include "jobarena.h"
+#include "frame.h"
+#include "kernels.h"
+#include "tuning.h"
+#include "rmse.h"
+#include "ppmrows.h"
+#include "imaged.h"
+#include "memacct.h"
 
 /* Helper function to compare floating-point if not exactly equal */
 bool close_f(double a, double b)
@@ -28,9 +48,9 @@ bool close_i(int a, int b)
 }
 
 /*****************************************************************
- *                          rgb2cv Tests
+ *                          rgb2cav Tests
  *****************************************************************/
-void test_RGBtoCV()
+void test_RGBtoCAV()
 {
         Pnm_rgb rgb;
         NEW(rgb);
@@ -38,34 +58,38 @@ void test_RGBtoCV()
         rgb->green = 0;
         rgb->blue = 0;
 
-        ComponentVideo cv = RGBtoCV(rgb, 255);
+        CAV cav;
+        NEW(cav);
+        RGBtoCAV(cav, rgb, 255);
 
-        assert(close_f(cv->Y, 0.299));
-        assert(close_f(cv->P_b, -0.168736));
-        assert(close_f(cv->P_r, 0.5));
+        assert(close_f(cav->Y, 0.299));
+        assert(close_f(cav->P_b, -0.168736));
+        assert(close_f(cav->P_r, 0.5));
 
         FREE(rgb);
-        FREE(cv);
+        FREE(cav);
 }
-void test_CVtoRGB()
+void test_CAVtoRGB()
 {
-        ComponentVideo cv;
-        NEW(cv);
-        cv->Y = 0.299;
-        cv->P_b = -0.168736;
-        cv->P_r = 0.5;
+        CAV cav;
+        NEW(cav);
+        cav->Y = 0.299;
+        cav->P_b = -0.168736;
+        cav->P_r = 0.5;
 
-        Pnm_rgb rgb = CVtoRGB(cv, 255);
+        Pnm_rgb rgb;
+        NEW(rgb);
+        CAVtoRGB(rgb, cav, 255);
 
         assert(rgb->red == 255);
         assert(rgb->green == 0);
         assert(rgb->blue == 0);
 
         FREE(rgb);
-        FREE(cv);
+        FREE(cav);
 }
 
-void test_RGBtoCV_and_back()
+void test_RGBtoCAV_and_back()
 {
         Pnm_rgb rgb;
         NEW(rgb);
@@ -73,18 +97,866 @@ void test_RGBtoCV_and_back()
         rgb->green = 100;
         rgb->blue = 100;
 
-        ComponentVideo cv = RGBtoCV(rgb, 255);
-        Pnm_rgb rgb2 = CVtoRGB(cv, 255);
+        CAV cav;
+        NEW(cav);
+        RGBtoCAV(cav, rgb, 255);
+        Pnm_rgb rgb2;
+        NEW(rgb2);
+        CAVtoRGB(rgb2, cav, 255);
 
         assert(close_i(rgb->red, rgb2->red));
         assert(close_i(rgb->green, rgb2->green));
         assert(close_i(rgb->blue, rgb2->blue));
 
         FREE(rgb);
-        FREE(cv);
+        FREE(cav);
         FREE(rgb2);
 }
 
+/*****************************************************************
+ *                          Blocked Array Tests
+ *****************************************************************/
+/* Records the order block-major mapping visits elements in */
+static void record_visit(int col, int row, A2Methods_UArray2 array2,
+                         A2Methods_Object *elem, void *cl)
+{
+        char **last = cl;
+        (void)array2;
+        assert(elem == uarray2_methods_blocked->at(array2, col, row));
+        assert(*last == NULL || (char *)elem > *last);
+        *last = elem;
+        ((Pnm_rgb)elem)->red++;
+}
+
+/* Each tile is contiguous and aligned, and mapping follows storage */
+void test_blocked_tiles()
+{
+        A2Methods_T methods = uarray2_methods_blocked;
+        A2Methods_UArray2 array = methods->new_with_blocksize(
+                5, 3, sizeof(struct Pnm_rgb), 2);
+        assert(methods->width(array) == 5 && methods->height(array) == 3);
+        assert(methods->blocksize(array) == 2);
+
+        for (int row = 0; row < 3; row += 2)
+        {
+                for (int col = 0; col < 5; col += 2)
+                {
+                        char *tile = methods->at(array, col, row);
+                        assert((uintptr_t)tile % UARRAY2B_ALIGN == 0);
+                        if (col + 1 < 5 && row + 1 < 3)
+                        {
+                                assert((char *)methods->at(array, col + 1,
+                                                           row + 1) ==
+                                       tile + 3 * sizeof(struct Pnm_rgb));
+                        }
+                }
+        }
+
+        char *last = NULL;
+        methods->map_block_major(array, record_visit, &last);
+        for (int row = 0; row < 3; row++)
+        {
+                for (int col = 0; col < 5; col++)
+                {
+                        Pnm_rgb px = methods->at(array, col, row);
+                        assert(px->red == 1 && px->green == 0);
+                }
+        }
+        methods->free(&array);
+        assert(array == NULL);
+}
+
+/* Plain rows come back whole; blocked arrays have no contiguous rows */
+void test_row_access()
+{
+        A2Methods_T plain = uarray2_methods_plain;
+        A2Methods_UArray2 array = plain->new(7, 4, sizeof(struct Pnm_rgb));
+        for (int row = 0; row < 4; row++)
+        {
+                Pnm_rgb pixels = A2Methods_row(plain, array, row);
+                for (int col = 0; col < 7; col++)
+                {
+                        assert(&pixels[col] == plain->at(array, col, row));
+                }
+        }
+        plain->free(&array);
+
+        array = plain->new(0, 3, sizeof(struct Pnm_rgb));
+        assert(A2Methods_row(plain, array, 2) == NULL);
+        plain->free(&array);
+
+        A2Methods_T blocked = uarray2_methods_blocked;
+        array = blocked->new_with_blocksize(7, 4, sizeof(struct Pnm_rgb), 2);
+        assert(A2Methods_row(blocked, array, 0) == NULL);
+        blocked->free(&array);
+}
+
+struct visit_2x2
+{
+        A2Methods_T methods;
+        int next;
+};
+
+/* Checks each block against at and that blocks come in row-major order */
+static void check_2x2(int col, int row, A2Methods_UArray2 array2,
+                      A2Methods_Object *elems[4], void *cl)
+{
+        struct visit_2x2 *visit = cl;
+        A2Methods_T methods = visit->methods;
+        assert(row * (methods->width(array2) / 2) + col == visit->next++);
+        for (int k = 0; k < 4; k++)
+        {
+                assert(elems[k] == methods->at(array2, 2 * col + k % 2,
+                                               2 * row + k / 2));
+        }
+}
+
+/* Every way of visiting 2x2 blocks sees the same blocks in the same order */
+void test_map_2x2()
+{
+        A2Methods_T suites[2] = {uarray2_methods_plain,
+                                 uarray2_methods_blocked};
+        for (int s = 0; s < 2; s++)
+        {
+                A2Methods_UArray2 array = suites[s]->new_with_blocksize(
+                        7, 5, sizeof(struct Pnm_rgb), 2);
+                struct visit_2x2 visit = {suites[s], 0};
+                A2Methods_map_2x2(suites[s], array, check_2x2, &visit);
+                assert(visit.next == 3 * 2);
+                suites[s]->free(&array);
+        }
+
+        UArray2_T array = UArray2_new(6, 4, sizeof(int));
+        UArray2_2x2 it = UArray2_2x2_start(array);
+        void *elems[4];
+        int blocks = 0;
+        while (UArray2_2x2_next(&it, elems))
+        {
+                assert(it.row * 3 + it.col == blocks++);
+                for (int k = 0; k < 4; k++)
+                {
+                        assert(elems[k] == UArray2_at(array, 2 * it.col + k % 2,
+                                                      2 * it.row + k / 2));
+                }
+        }
+        assert(blocks == 6 && !UArray2_2x2_next(&it, elems));
+        UArray2_free(&array);
+
+        array = UArray2_new(1, 4, sizeof(int));
+        it = UArray2_2x2_start(array);
+        assert(!UArray2_2x2_next(&it, elems));
+        UArray2_free(&array);
+}
+
+/* A running total, kept per band by the parallel maps */
+struct total
+{
+        uint64_t sum;
+        size_t count;
+};
+
+static void *new_total(void *cl)
+{
+        (void)cl;
+        struct total *band;
+        NEW(band);
+        band->sum = 0;
+        band->count = 0;
+        return band;
+}
+
+static void add_total(void *band_cl, void *cl)
+{
+        struct total *band = band_cl, *total = cl;
+        total->sum += band->sum;
+        total->count += band->count;
+        FREE(band);
+}
+
+static void sum_cell(int col, int row, A2Methods_UArray2 array2,
+                     A2Methods_Object *elem, void *cl)
+{
+        struct total *total = cl;
+        (void)array2;
+        assert(*(uint32_t *)elem == (uint32_t)(row * 1000 + col));
+        total->sum += *(uint32_t *)elem;
+        total->count++;
+}
+
+static void fill_cell(int col, int row, A2Methods_UArray2 array2,
+                      A2Methods_Object *elem, void *cl)
+{
+        (void)array2;
+        (void)cl;
+        *(uint32_t *)elem = row * 1000 + col;
+}
+
+/* Both parallel maps visit every cell once, on any number of threads */
+void test_parallel_maps()
+{
+        enum { WIDTH = 601, HEIGHT = 450 };
+        A2Methods_T suites[2] = {uarray2_methods_plain,
+                                 uarray2_methods_blocked};
+        uint64_t expected = 0;
+        for (uint64_t row = 0; row < HEIGHT; row++)
+        {
+                for (uint64_t col = 0; col < WIDTH; col++)
+                {
+                        expected += row * 1000 + col;
+                }
+        }
+
+        for (int s = 0; s < 2; s++)
+        {
+                A2Methods_UArray2 array = suites[s]->new_with_blocksize(
+                        WIDTH, HEIGHT, sizeof(uint32_t), 16);
+                suites[s]->map_default(array, fill_cell, NULL);
+                for (int threads = 1; threads <= 4; threads += 3)
+                {
+                        struct total rows = {0, 0}, blocks = {0, 0};
+                        A2Methods_map_row_major_parallel(
+                                suites[s], array, sum_cell, new_total,
+                                add_total, &rows, threads);
+                        A2Methods_map_block_major_parallel(
+                                suites[s], array, sum_cell, new_total,
+                                add_total, &blocks, threads);
+                        assert(rows.sum == expected && blocks.sum == expected);
+                        assert(rows.count == WIDTH * HEIGHT);
+                        assert(blocks.count == WIDTH * HEIGHT);
+                }
+                suites[s]->free(&array);
+        }
+}
+
+/* An array of more than 2^31 elements indexes without overflow; it is
+ * mapped lazily, so only the pages touched here are ever backed */
+void test_uarray2_huge()
+{
+        enum { WIDTH = 65536, HEIGHT = 40000 };
+        A2Methods_T methods = uarray2_methods_plain;
+        A2Methods_UArray2 array = methods->new(WIDTH, HEIGHT, 1);
+        assert((size_t)methods->width(array) * methods->height(array) >
+               (size_t)INT_MAX);
+
+        unsigned char *first = methods->at(array, 0, 0);
+        unsigned char *last = methods->at(array, WIDTH - 1, HEIGHT - 1);
+        assert((size_t)(last - first) == (size_t)WIDTH * HEIGHT - 1);
+        assert(*last == 0);
+        *last = 7;
+        *first = 3;
+        assert(*(unsigned char *)methods->at(array, WIDTH - 1,
+                                             HEIGHT - 1) == 7);
+        assert((unsigned char *)A2Methods_row(methods, array, HEIGHT - 1) +
+               WIDTH - 1 == last);
+
+        UArray2_T blocks = array;
+        UArray2_2x2 it = UArray2_2x2_start(blocks);
+        void *elems[4];
+        assert(UArray2_2x2_next(&it, elems) && elems[0] == first);
+        methods->free(&array);
+}
+
+/*****************************************************************
+ *                          Frame Tests
+ *****************************************************************/
+/* The planar pipeline matches the block pipeline bit for bit */
+void test_frame_matches_blocks()
+{
+        unsigned width = 37, height = 20;
+        Pnm_ppm image;
+        NEW(image);
+        image->width = width;
+        image->height = height;
+        image->denominator = 255;
+        image->methods = uarray2_methods_plain;
+        image->pixels = image->methods->new(width, height,
+                                            sizeof(struct Pnm_rgb));
+        for (unsigned row = 0; row < height; row++)
+        {
+                for (unsigned col = 0; col < width; col++)
+                {
+                        Pnm_rgb px = image->methods->at(image->pixels, col,
+                                                        row);
+                        px->red = (col * 41 + row * 7) % 256;
+                        px->green = (col * 13 + row * 97) % 256;
+                        px->blue = (col * row + 5) % 256;
+                }
+        }
+
+        JobArena_T arena = JobArena_new(4096);
+        Frame frame = Frame_arena_new(arena, width & ~1, height & ~1);
+        assert((uintptr_t)frame->Y % FRAME_ALIGN == 0);
+        assert((uintptr_t)frame->P_b % FRAME_ALIGN == 0);
+        assert((uintptr_t)frame->P_r % FRAME_ALIGN == 0);
+        assert(frame->stride * sizeof(float) % FRAME_ALIGN == 0);
+        Frame_from_ppm(frame, image);
+
+        RGB_block rgb_block = RGB_block_new();
+        CAV_block cav_block = CAV_block_new();
+        DCT expected = DCT_new();
+        DCT actual = DCT_new();
+        for (unsigned col = 0; col < frame->width / 2; col++)
+        {
+                for (unsigned row = 0; row < frame->height / 2; row++)
+                {
+                        for (int k = 0; k < 4; k++)
+                        {
+                                *rgb_block->rgb[k] = *(Pnm_rgb)image->methods
+                                        ->at(image->pixels, col * 2 + k % 2,
+                                             row * 2 + k / 2);
+                        }
+                        RGBtoCAV_block(cav_block, rgb_block, 255);
+                        computeDCT(expected, cav_block);
+                        computeDCT_frame(actual, frame, col, row);
+                        assert(memcmp(expected, actual,
+                                      sizeof(*actual)) == 0);
+
+                        invertDCT(cav_block, expected);
+                        CAVtoRGB_block(rgb_block, cav_block, 255);
+                        invertDCT_frame(frame, actual, col, row);
+                }
+        }
+
+        /* Back to RGB, every pixel agrees with the block pipeline */
+        Frame_to_ppm(image, frame);
+        for (unsigned col = 0; col < frame->width / 2; col++)
+        {
+                for (unsigned row = 0; row < frame->height / 2; row++)
+                {
+                        for (int k = 0; k < 4; k++)
+                        {
+                                CAV cav = cav_block->cav[k];
+                                size_t at = (row * 2 + k / 2) *
+                                            frame->stride + col * 2 + k % 2;
+                                cav->Y = frame->Y[at];
+                                cav->P_b = frame->P_b[at];
+                                cav->P_r = frame->P_r[at];
+                        }
+                        CAVtoRGB_block(rgb_block, cav_block, 255);
+                        for (int k = 0; k < 4; k++)
+                        {
+                                Pnm_rgb px = image->methods->at(
+                                        image->pixels, col * 2 + k % 2,
+                                        row * 2 + k / 2);
+                                assert(memcmp(px, rgb_block->rgb[k],
+                                              sizeof(*px)) == 0);
+                        }
+                }
+        }
+
+        DCT_free(&actual);
+        DCT_free(&expected);
+        CAV_block_free(&cav_block);
+        RGB_block_free(&rgb_block);
+        JobArena_free(&arena);
+        Pnm_ppmfree(&image);
+}
+
+/* A blocked image converts to the same frame as a plain one */
+void test_frame_from_blocked()
+{
+        unsigned width = 21, height = 10;
+        Pnm_ppm images[2];
+        A2Methods_T methods[2] = {uarray2_methods_plain,
+                                  uarray2_methods_blocked};
+        JobArena_T arena = JobArena_new(4096);
+        Frame frames[2];
+
+        for (int i = 0; i < 2; i++)
+        {
+                NEW(images[i]);
+                images[i]->width = width;
+                images[i]->height = height;
+                images[i]->denominator = 255;
+                images[i]->methods = methods[i];
+                images[i]->pixels = methods[i]->new_with_blocksize(
+                        width, height, sizeof(struct Pnm_rgb), 2);
+                for (unsigned row = 0; row < height; row++)
+                {
+                        for (unsigned col = 0; col < width; col++)
+                        {
+                                Pnm_rgb px = methods[i]->at(images[i]->pixels,
+                                                            col, row);
+                                px->red = (col * 41 + row * 7) % 256;
+                                px->green = (col * 13 + row * 97) % 256;
+                                px->blue = (col * row + 5) % 256;
+                        }
+                }
+                frames[i] = Frame_arena_new(arena, width & ~1, height & ~1);
+                Frame_from_ppm(frames[i], images[i]);
+        }
+
+        size_t bytes = frames[0]->width * sizeof(float);
+        for (size_t at = 0; at < frames[0]->stride * frames[0]->height;
+             at += frames[0]->stride)
+        {
+                assert(memcmp(frames[0]->Y + at, frames[1]->Y + at,
+                              bytes) == 0);
+                assert(memcmp(frames[0]->P_b + at, frames[1]->P_b + at,
+                              bytes) == 0);
+                assert(memcmp(frames[0]->P_r + at, frames[1]->P_r + at,
+                              bytes) == 0);
+        }
+
+        JobArena_free(&arena);
+        Pnm_ppmfree(&images[0]);
+        Pnm_ppmfree(&images[1]);
+}
+
+/*****************************************************************
+ *                          Kernel Tests
+ *****************************************************************/
+/* Every kernel set this CPU runs codes a frame exactly as the reference */
+void test_kernels_match_reference()
+{
+        enum { WIDTH = 38, HEIGHT = 20, N = WIDTH * HEIGHT };
+        struct Pnm_rgb rgb[N], rgb_out[2][N];
+        float planes[2][3][N];
+        uint32_t words[2][HEIGHT / 2];
+        struct Kernels ref, var;
+
+        for (int i = 0; i < N; i++)
+        {
+                rgb[i].red = (i * 41) % 1024;
+                rgb[i].green = (i * 97 + 13) % 1024;
+                rgb[i].blue = (i * i) % 1024;
+        }
+
+        Kernels_at(0, &ref);
+        for (int v = 1; v < Kernels_count(); v++)
+        {
+                if (!Kernels_supported(v))
+                {
+                        continue;
+                }
+                Kernels_at(v, &var);
+                Kernels k[2] = {&ref, &var};
+
+                for (int w = 0; w < 2; w++)
+                {
+                        struct Frame frame = {WIDTH, HEIGHT, WIDTH,
+                                              planes[w][0], planes[w][1],
+                                              planes[w][2]};
+                        k[w]->rgb_to_frame(frame.Y, frame.P_b, frame.P_r,
+                                           rgb, N, 1023);
+                        for (size_t col = 0; col < WIDTH / 2; col++)
+                        {
+                                k[w]->encode_blocks(words[w], &frame, col,
+                                                    HEIGHT / 2);
+                                k[w]->decode_blocks(&frame, words[w], col,
+                                                    HEIGHT / 2);
+                        }
+                        k[w]->frame_to_rgb(rgb_out[w], frame.Y, frame.P_b,
+                                           frame.P_r, N, 1023);
+                }
+                assert(memcmp(words[0], words[1], sizeof(words[0])) == 0);
+                assert(memcmp(planes[0], planes[1], sizeof(planes[0])) == 0);
+                assert(memcmp(rgb_out[0], rgb_out[1],
+                              sizeof(rgb_out[0])) == 0);
+        }
+}
+
+/*****************************************************************
+ *                          RMSE Tests
+ *****************************************************************/
+/* Both sums agree with the definition, and with each other */
+void test_rmse_matches_definition()
+{
+        enum { N = 1000 };
+        struct Pnm_rgb a[N], b[N], b4[N];
+        double expected = 0;
+
+        for (int i = 0; i < N; i++)
+        {
+                a[i].red = (i * 41) % 256;
+                a[i].green = (i * 97 + 13) % 256;
+                a[i].blue = (i * i) % 256;
+                b[i].red = (i * 7) % 256;
+                b[i].green = a[i].green;
+                b[i].blue = 255 - a[i].blue;
+                b4[i].red = b[i].red * 4;
+                b4[i].green = b[i].green * 4;
+                b4[i].blue = b[i].blue * 4;
+
+                unsigned *x = &a[i].red, *y = &b[i].red;
+                for (int k = 0; k < 3; k++)
+                {
+                        double d = x[k] / 255.0 - y[k] / 255.0;
+                        expected += d * d;
+                }
+        }
+        expected = sqrt(expected / (3 * N));
+
+        /* Same denominators sum exactly; split spans add up the same */
+        Rmse_sum exact = {0, 0, 0}, halves = {0, 0, 0};
+        Rmse_row(&exact, a, b, N, 255, 255);
+        Rmse_row(&halves, a, b, N / 2, 255, 255);
+        Rmse_row(&halves, a + N / 2, b + N / 2, N - N / 2, 255, 255);
+        assert(exact.exact == halves.exact && exact.samples == 3 * N);
+        assert(fabs(Rmse_value(&exact, 255, 255) - expected) < 1e-12);
+
+        /* b4 is b at denominator 1020: the same image */
+        Rmse_sum scaled = {0, 0, 0};
+        Rmse_row(&scaled, a, b4, N, 255, 1020);
+        assert(fabs(Rmse_value(&scaled, 255, 1020) - expected) < 1e-12);
+
+        Rmse_sum none = {0, 0, 0};
+        Rmse_row(&none, b, b4, N, 255, 1020);
+        assert(Rmse_value(&none, 255, 1020) == 0);
+}
+
+/* Plain, raw and two-byte raw rows read back the same samples */
+void test_ppmrows_formats()
+{
+        static const char plain[] = "P3\n# a comment\n2 2\n1000\n"
+                                    "0 1 2 3 4 5\n6 7 8 9 10 1000\n";
+        static const char raw[] = "P6 2 2 255\n\0\1\2\3\4\5\6\7\10\11\12\377";
+        static const char wide[] = "P6\n1 1\n1000\n\0\0\0\1\3\350";
+        const char *images[] = {plain, raw, wide};
+        size_t lengths[] = {sizeof(plain) - 1, sizeof(raw) - 1,
+                            sizeof(wide) - 1};
+        unsigned last[] = {1000, 255, 1000};
+
+        for (int i = 0; i < 3; i++)
+        {
+                FILE *fp = fmemopen((void *)images[i], lengths[i], "r");
+                Ppmrows_T rows = Ppmrows_new(fp);
+                assert(rows != NULL);
+
+                unsigned n = 0, sample = 0;
+                const struct Pnm_rgb *row;
+                while ((row = Ppmrows_next(rows)) != NULL)
+                {
+                        for (unsigned col = 0; col < Ppmrows_width(rows);
+                             col++)
+                        {
+                                assert(row[col].red == n++);
+                                assert(row[col].green == n++);
+                                sample = row[col].blue;
+                                n++;
+                        }
+                }
+                assert(n == 3 * Ppmrows_width(rows) * Ppmrows_height(rows));
+                assert(sample == last[i]);
+                Ppmrows_free(&rows);
+                assert(rows == NULL);
+                fclose(fp);
+        }
+
+        FILE *fp = fmemopen("P5 1 1 255\n\0", 12, "r");
+        assert(Ppmrows_new(fp) == NULL);
+        fclose(fp);
+}
+
+void test_ppmrows_reset()
+{
+        static const char narrow[] = "P6 1 1 255\n\1\2\3";
+        static const char wide[] = "P3 3 1 9\n1 2 3 4 5 6 7 8 9\n";
+        FILE *fp = fmemopen((void *)narrow, sizeof(narrow) - 1, "r");
+        Ppmrows_T rows = Ppmrows_new(fp);
+        assert(rows != NULL);
+        assert(Ppmrows_next(rows)[0].blue == 3);
+        fclose(fp);
+
+        /* A wider image grows the buffers; a bad header leaves no rows */
+        fp = fmemopen((void *)wide, sizeof(wide) - 1, "r");
+        assert(Ppmrows_reset(rows, fp));
+        assert(Ppmrows_width(rows) == 3 && Ppmrows_denominator(rows) == 9);
+        assert(Ppmrows_next(rows)[2].blue == 9);
+        assert(Ppmrows_next(rows) == NULL);
+        fclose(fp);
+
+        fp = fmemopen("P6 0 1 255\n", 11, "r");
+        assert(!Ppmrows_reset(rows, fp));
+        assert(Ppmrows_height(rows) == 0 && Ppmrows_next(rows) == NULL);
+        fclose(fp);
+        Ppmrows_free(&rows);
+}
+
+/*****************************************************************
+ *                          JobArena Tests
+ *****************************************************************/
+void test_arena_alignment()
+{
+        JobArena_T arena = JobArena_new(100);
+
+        for (int i = 1; i < 50; i++)
+        {
+                void *p = JobArena_alloc(arena, i);
+                assert((uintptr_t)p % JOBARENA_ALIGN == 0);
+                void *q = JobArena_alloc_aligned(arena, i, 64);
+                assert((uintptr_t)q % 64 == 0);
+        }
+
+        /* Bigger than a chunk gets a chunk of its own */
+        char *big = JobArena_alloc(arena, 1000);
+        big[999] = 1;
+
+        JobArena_free(&arena);
+        assert(arena == NULL);
+}
+
+void test_arena_reset_reuses_chunks()
+{
+        JobArena_T arena = JobArena_new(256);
+
+        for (int i = 0; i < 100; i++)
+        {
+                JobArena_alloc(arena, 48);
+        }
+        size_t chunks = JobArena_chunks(arena);
+        assert(chunks > 1);
+
+        for (int round = 0; round < 10; round++)
+        {
+                JobArena_reset(arena);
+                for (int i = 0; i < 100; i++)
+                {
+                        JobArena_alloc(arena, 48);
+                }
+        }
+        assert(JobArena_chunks(arena) == chunks);
+
+        JobArena_free(&arena);
+}
+
+/* Trimming keeps the chunks within the budget and frees the rest */
+void test_arena_trim_frees_large_chunks()
+{
+        JobArena_T arena = JobArena_new(256);
+
+        JobArena_alloc(arena, 100);
+        JobArena_alloc(arena, 5000);
+        assert(JobArena_chunks(arena) == 2);
+
+        /* The small chunk is kept and reused; the large one is not */
+        JobArena_trim(arena, 1024);
+        JobArena_alloc(arena, 100);
+        assert(JobArena_chunks(arena) == 2);
+        JobArena_alloc(arena, 5000);
+        assert(JobArena_chunks(arena) == 3);
+
+        JobArena_trim(arena, 0);
+        JobArena_alloc(arena, 100);
+        assert(JobArena_chunks(arena) == 4);
+
+        JobArena_free(&arena);
+}
+
+/********** make_image ********
+ *
+ * Fills a new width x height 8-bit RGB buffer with a deterministic
+ * pattern. Client must FREE the result.
+ ************************/
+static unsigned char *make_image(unsigned width, unsigned height)
+{
+        unsigned char *rgb = ALLOC(3 * width * height);
+        for (unsigned i = 0; i < 3 * width * height; i++)
+        {
+                rgb[i] = (i * 37 + i / 7) & 0xFF;
+        }
+        return rgb;
+}
+
+/* Encoding and decoding allocate nothing, whatever the block count;
+ * every Mem_* call is counted by memacct.o */
+void test_codec_zero_per_block_allocations()
+{
+        unsigned sizes[] = {2, 64, 256};
+        Codec40_T codec = Codec40_new();
+
+        for (int s = 0; s < 3; s++)
+        {
+                unsigned n = sizes[s];
+                unsigned char *rgb = make_image(n, n);
+                size_t cap = Codec40_encoded_size(n, n);
+                unsigned char *out = ALLOC(cap);
+                unsigned char *back = ALLOC(3 * n * n);
+
+                size_t live = Memacct_live();
+                Memacct_reset();
+                size_t len = Codec40_encode(codec, rgb, n, n, 3 * n, out,
+                                            cap);
+                size_t used = Codec40_decode(codec, out, len, back, 3 * n);
+                assert(Memacct_allocations() == 0);
+                assert(Memacct_live() == live);
+                assert(len == cap && used == len);
+
+                FREE(back);
+                FREE(out);
+                FREE(rgb);
+        }
+
+        Codec40_free(&codec);
+}
+
+/********** compress_image ********
+ *
+ * Runs compress40_to on an n x n PPM, discarding the output.
+ ************************/
+static void compress_image(unsigned n, FILE *sink)
+{
+        unsigned char *rgb = make_image(n, n);
+        char *ppm = ALLOC(3 * n * n + 64);
+        int hlen = sprintf(ppm, "P6\n%u %u\n255\n", n, n);
+        memcpy(ppm + hlen, rgb, 3 * n * n);
+
+        FILE *input = fmemopen(ppm, hlen + 3 * n * n, "r");
+        compress40_to(input, sink);
+        fclose(input);
+
+        FREE(ppm);
+        FREE(rgb);
+}
+
+/* The codec's scratch comes from the thread arena, and stops growing */
+void test_compress_scratch_in_thread_arena()
+{
+        FILE *sink = fopen("/dev/null", "w");
+        assert(sink != NULL);
+        JobArena_T arena = JobArena_thread();
+
+        compress_image(512, sink);
+        size_t chunks = JobArena_chunks(arena);
+        assert(chunks >= 1);
+
+        compress_image(4, sink);
+        compress_image(512, sink);
+        assert(JobArena_chunks(arena) == chunks);
+
+        fclose(sink);
+}
+
+/* Releasing the thread arena frees its chunks; the next job starts over */
+void test_thread_arena_release()
+{
+        FILE *sink = fopen("/dev/null", "w");
+        assert(sink != NULL);
+
+        compress_image(64, sink);
+        JobArena_thread_release();
+        JobArena_thread_release();
+        assert(JobArena_chunks(JobArena_thread()) == 0);
+
+        compress_image(64, sink);
+        assert(JobArena_chunks(JobArena_thread()) >= 1);
+
+        fclose(sink);
+}
+
+/********** round_trip ********
+ *
+ * Compresses a PPM and decompresses the result with
+ * Tuning_current. Client must free both outputs.
+ ************************/
+static void round_trip(const char *ppm, size_t len, char **compressed,
+                       size_t *compressed_len, char **decompressed,
+                       size_t *decompressed_len)
+{
+        FILE *input = fmemopen((void *)ppm, len, "r");
+        FILE *output = open_memstream(compressed, compressed_len);
+        compress40_to(input, output);
+        fclose(input);
+        fclose(output);
+
+        input = fmemopen(*compressed, *compressed_len, "r");
+        output = open_memstream(decompressed, decompressed_len);
+        decompress40_to(input, output);
+        fclose(input);
+        fclose(output);
+}
+
+/* Any thread count and strip width gives the same bytes as the default */
+void test_tuning_output_unchanged()
+{
+        enum { N = 70 };
+        unsigned char *rgb = make_image(N, N);
+        char *ppm = ALLOC(3 * N * N + 64);
+        int hlen = sprintf(ppm, "P6\n%u %u\n255\n", N, N);
+        memcpy(ppm + hlen, rgb, 3 * N * N);
+
+        Tuning saved = Tuning_current;
+        Tuning settings[] = {{1, 1}, {2, 1}, {3, 4}, {4, 9}, {2, 100}};
+        char *expected[2], *actual[2];
+        size_t expected_len[2], actual_len[2];
+
+        Tuning_current = settings[0];
+        round_trip(ppm, hlen + 3 * N * N, &expected[0], &expected_len[0],
+                   &expected[1], &expected_len[1]);
+        for (size_t i = 1; i < sizeof(settings) / sizeof(settings[0]); i++)
+        {
+                Tuning_current = settings[i];
+                round_trip(ppm, hlen + 3 * N * N, &actual[0], &actual_len[0],
+                           &actual[1], &actual_len[1]);
+                for (int k = 0; k < 2; k++)
+                {
+                        assert(actual_len[k] == expected_len[k]);
+                        assert(memcmp(actual[k], expected[k],
+                                      expected_len[k]) == 0);
+                        free(actual[k]);    /* allocated by open_memstream */
+                }
+        }
+        Tuning_current = saved;
+
+        free(expected[0]);
+        free(expected[1]);
+        FREE(ppm);
+        FREE(rgb);
+}
+
+/* An image whose pixel array is large enough to be mapped rather than
+ * allocated round-trips, and the mapped array counts toward memacct's
+ * peak alongside the frame decompress40_to holds with it */
+void test_codec_large_image()
+{
+        enum { N = 2400 };
+        size_t pixels = (size_t)N * N * sizeof(struct Pnm_rgb);
+        size_t planes = 3 * (size_t)N * N * sizeof(float);
+        assert(pixels >= (size_t)1 << 26);
+
+        char *ppm = ALLOC(3 * N * N + 64);
+        int hlen = sprintf(ppm, "P6\n%u %u\n255\n", N, N);
+        for (size_t i = 0; i < 3 * (size_t)N * N; i++)
+        {
+                ppm[hlen + i] = (char)(100 + 50 * (i % 3));
+        }
+
+        FILE *input = fmemopen(ppm, hlen + 3 * N * N, "r");
+        char *compressed;
+        size_t compressed_len;
+        FILE *output = open_memstream(&compressed, &compressed_len);
+        compress40_to(input, output);
+        fclose(input);
+        fclose(output);
+
+        JobArena_thread_release();
+        Memacct_reset();
+        size_t live = Memacct_live();
+        input = fmemopen(compressed, compressed_len, "r");
+        char *decompressed;
+        size_t decompressed_len;
+        output = open_memstream(&decompressed, &decompressed_len);
+        decompress40_to(input, output);
+        fclose(input);
+        fclose(output);
+        assert(Memacct_peak() - live >= pixels + planes);
+        JobArena_thread_release();
+        assert(Memacct_live() == live);
+
+        assert(decompressed_len == (size_t)hlen + 3 * N * N);
+        assert(memcmp(decompressed, ppm, hlen) == 0);
+        for (size_t i = hlen; i < decompressed_len; i++)
+        {
+                int error = (unsigned char)decompressed[i] -
+                            (unsigned char)ppm[i];
+                assert(error >= -8 && error <= 8);
+        }
+
+        free(decompressed);    /* allocated by open_memstream */
+        free(compressed);
+        FREE(ppm);
+}
+
 void test_bitpack_fitsu()
 {
         assert(Bitpack_fitsu(5, 3));
@@ -160,6 +1032,92 @@ void test_bitpack_s()
         assert(Bitpack_gets(a, 8, 24) == 100);
 }
 
+/*****************************************************************
+ *                          40imaged Tests
+ *****************************************************************/
+/********** imaged_decompress ********
+ *
+ * Sends a decompress request with an inline payload, reads the response
+ * payload and discards it.
+ *
+ * Return:
+ *      int:    The response status, or -1 if the server did not answer.
+ ************************/
+static int imaged_decompress(int sock, const void *payload, size_t len)
+{
+        Imaged_header req = {IMAGED_MAGIC, IMAGED_DECOMPRESS, 0, len};
+        Imaged_header resp;
+        int fds[2];
+        int nfds;
+
+        if (Imaged_send(sock, &req, payload, NULL, 0) < 0 ||
+            Imaged_recv(sock, &resp, fds, &nfds) < 0)
+        {
+                return -1;
+        }
+        if (resp.length > 0)
+        {
+                char *result = ALLOC(resp.length);
+                assert(Imaged_read_full(sock, result, resp.length) == 0);
+                FREE(result);
+        }
+        return resp.op;
+}
+
+/* A codeword whose b is -16 gets an error response, and the server keeps
+ * serving that client and new ones. Needs ./40imaged. */
+void test_imaged_rejects_illegal_codeword()
+{
+        char dir[] = "/tmp/40imaged-test-XXXXXX";
+        assert(mkdtemp(dir) != NULL);
+        char path[64];
+        snprintf(path, sizeof(path), "%s/sock", dir);
+
+        pid_t pid = fork();
+        assert(pid >= 0);
+        if (pid == 0)
+        {
+                freopen("/dev/null", "w", stderr);
+                execl("./40imaged", "40imaged", "-s", path, "-t", "2",
+                      (char *)NULL);
+                _exit(127);
+        }
+
+        int sock = -1;
+        for (int tries = 0; sock < 0 && tries < 500; tries++)
+        {
+                usleep(10000);
+                sock = Imaged_connect(path);
+        }
+        assert(sock >= 0);
+
+        /* One 2x2 block: b = -16 is 0x10 in bits 18-22 */
+        unsigned char image[64];
+        int hlen = sprintf((char *)image,
+                           "COMP40 Compressed image format 2\n2 2\n");
+        uint32_t bad = 0x10u << 18;
+        for (int i = 0; i < 4; i++)
+        {
+                image[hlen + i] = bad >> (24 - 8 * i);
+        }
+        assert(imaged_decompress(sock, image, hlen + 4) == IMAGED_ERROR);
+
+        /* The same client, and a new one, are still served */
+        memset(image + hlen, 0, 4);
+        assert(imaged_decompress(sock, image, hlen + 4) == IMAGED_OK);
+        close(sock);
+        sock = Imaged_connect(path);
+        assert(sock >= 0);
+        assert(imaged_decompress(sock, image, hlen + 4) == IMAGED_OK);
+        close(sock);
+
+        int status;
+        kill(pid, SIGTERM);
+        assert(waitpid(pid, &status, 0) == pid);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        rmdir(dir);
+}
+
 /*****************************************************************
  *                          Main Function
  *****************************************************************/
@@ -168,9 +1126,28 @@ int main(int argc, char *argv[])
         (void)argc;
         (void)argv;
 
-        test_RGBtoCV();
-        test_CVtoRGB();
-        test_RGBtoCV_and_back();
+        test_RGBtoCAV();
+        test_CAVtoRGB();
+        test_RGBtoCAV_and_back();
+        test_blocked_tiles();
+        test_row_access();
+        test_map_2x2();
+        test_parallel_maps();
+        test_uarray2_huge();
+        test_frame_matches_blocks();
+        test_frame_from_blocked();
+        test_kernels_match_reference();
+        test_rmse_matches_definition();
+        test_ppmrows_formats();
+        test_ppmrows_reset();
+        test_arena_alignment();
+        test_arena_reset_reuses_chunks();
+        test_arena_trim_frees_large_chunks();
+        test_codec_zero_per_block_allocations();
+        test_compress_scratch_in_thread_arena();
+        test_thread_arena_release();
+        test_tuning_output_unchanged();
+        test_codec_large_image();
         test_bitpack_fitsu();
         test_bitpack_fitss();
         test_bitpack_getu();
@@ -179,6 +1156,7 @@ int main(int argc, char *argv[])
         test_bitpack_news();
         test_bitpack_u();
         test_bitpack_s();
+        test_imaged_rejects_illegal_codeword();
 
         return 0;
 }
\ No newline at end of file